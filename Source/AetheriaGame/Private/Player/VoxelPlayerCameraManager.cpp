@@ -1,7 +1,7 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#include "VoxelPlayerCameraManager.h"
-
-
-
-
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "VoxelPlayerCameraManager.h"
+
+
+
+
@@ -0,0 +1,280 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "ChunkLifecycle.h"
+
+namespace
+{
+
+	const FIntVector2D NeighborOffsets[] =
+	{
+		FIntVector2D(-1, -1), FIntVector2D(0, -1), FIntVector2D(1, -1),
+		FIntVector2D(-1, 0), FIntVector2D(1, 0),
+		FIntVector2D(-1, 1), FIntVector2D(0, 1), FIntVector2D(1, 1)
+	};
+
+	FORCEINLINE bool IsColumnLoaded(const FChunkLifecycle::FColumn& Column)
+	{
+		// Every chunk of a column is loaded and unloaded at the same time
+		return Column.States[0] != EChunkState::Requested && Column.States[0] != EChunkState::Unloading;
+	}
+
+	FORCEINLINE bool IsUnmeshed(EChunkState State)
+	{
+		return State == EChunkState::NeighborsReady || State == EChunkState::Collided;
+	}
+
+}
+
+bool FChunkLifecycle::Request(const FIntVector2D& ColumnCoord)
+{
+	if (Columns.Contains(ColumnCoord))
+	{
+		return false;
+	}
+
+	FColumn& Column = Columns.Add(ColumnCoord);
+	for (EChunkState& State : Column.States)
+	{
+		State = EChunkState::Requested;
+	}
+	Column.NumLoadedNeighbors = 0;
+	return true;
+}
+
+bool FChunkLifecycle::Cancel(const FIntVector2D& ColumnCoord)
+{
+	if (!IsRequested(ColumnCoord))
+	{
+		return false;
+	}
+
+	Columns.Remove(ColumnCoord);
+	return true;
+}
+
+void FChunkLifecycle::SetGenerated(const FIntVector2D& ColumnCoord)
+{
+	FColumn* const Column = Columns.Find(ColumnCoord);
+	if (Column == nullptr || Column->States[0] != EChunkState::Requested)
+	{
+		return;
+	}
+
+	for (EChunkState& State : Column->States)
+	{
+		State = EChunkState::Generated;
+	}
+
+	for (const FIntVector2D& Offset : NeighborOffsets)
+	{
+		const FIntVector2D NeighborCoord = ColumnCoord + Offset;
+		FColumn* const Neighbor = Columns.Find(NeighborCoord);
+		if (Neighbor == nullptr || !IsColumnLoaded(*Neighbor))
+		{
+			continue;
+		}
+
+		++Column->NumLoadedNeighbors;
+		if (++Neighbor->NumLoadedNeighbors == ARRAY_COUNT(NeighborOffsets))
+		{
+			SetNeighborsReady(NeighborCoord, *Neighbor);
+		}
+	}
+
+	if (Column->NumLoadedNeighbors == ARRAY_COUNT(NeighborOffsets))
+	{
+		SetNeighborsReady(ColumnCoord, *Column);
+	}
+}
+
+void FChunkLifecycle::SetMeshed(const FIntVector3& ChunkCoord)
+{
+	const FIntVector2D ColumnCoord(ChunkCoord.X, ChunkCoord.Y);
+	FColumn* const Column = Columns.Find(ColumnCoord);
+	if (Column == nullptr)
+	{
+		return;
+	}
+
+	EChunkState& State = Column->States[ChunkCoord.Z];
+	if (State == EChunkState::NeighborsReady)
+	{
+		State = EChunkState::Meshed;
+	}
+	else if (State == EChunkState::Collided)
+	{
+		State = EChunkState::MeshedAndCollided;
+	}
+	UpdateUnmeshed(ColumnCoord, *Column);
+}
+
+void FChunkLifecycle::SetCollided(const FIntVector3& ChunkCoord)
+{
+	FColumn* const Column = Columns.Find(FIntVector2D(ChunkCoord.X, ChunkCoord.Y));
+	if (Column == nullptr)
+	{
+		return;
+	}
+
+	// A collided chunk still needs its mesh, so the column stays unmeshed
+	EChunkState& State = Column->States[ChunkCoord.Z];
+	if (State == EChunkState::NeighborsReady)
+	{
+		State = EChunkState::Collided;
+	}
+	else if (State == EChunkState::Meshed)
+	{
+		State = EChunkState::MeshedAndCollided;
+	}
+}
+
+void FChunkLifecycle::BeginUnload(const FIntVector2D& ColumnCoord)
+{
+	FColumn* const Column = Columns.Find(ColumnCoord);
+	if (Column == nullptr || !IsColumnLoaded(*Column))
+	{
+		return;
+	}
+
+	for (const FIntVector2D& Offset : NeighborOffsets)
+	{
+		const FIntVector2D NeighborCoord = ColumnCoord + Offset;
+		FColumn* const Neighbor = Columns.Find(NeighborCoord);
+		if (Neighbor == nullptr || !IsColumnLoaded(*Neighbor))
+		{
+			continue;
+		}
+
+		// Meshes that were already built keep the neighbor's voxels they were built with
+		if (Neighbor->NumLoadedNeighbors-- == ARRAY_COUNT(NeighborOffsets))
+		{
+			for (EChunkState& State : Neighbor->States)
+			{
+				if (State == EChunkState::NeighborsReady)
+				{
+					State = EChunkState::Generated;
+				}
+			}
+			UpdateUnmeshed(NeighborCoord, *Neighbor);
+		}
+	}
+
+	for (EChunkState& State : Column->States)
+	{
+		State = EChunkState::Unloading;
+	}
+	Column->NumLoadedNeighbors = 0;
+	UnmeshedColumns.Remove(ColumnCoord);
+}
+
+void FChunkLifecycle::FinishUnload(const FIntVector2D& ColumnCoord)
+{
+	if (IsUnloading(ColumnCoord))
+	{
+		Columns.Remove(ColumnCoord);
+	}
+}
+
+bool FChunkLifecycle::GetState(const FIntVector3& ChunkCoord, EChunkState& OutState) const
+{
+	const FColumn* const Column = Columns.Find(FIntVector2D(ChunkCoord.X, ChunkCoord.Y));
+	if (Column == nullptr || ChunkCoord.Z < 0 || ChunkCoord.Z >= WORLD_HEIGHT_CHUNKS)
+	{
+		return false;
+	}
+
+	OutState = Column->States[ChunkCoord.Z];
+	return true;
+}
+
+bool FChunkLifecycle::IsRequested(const FIntVector2D& ColumnCoord) const
+{
+	const FColumn* const Column = Columns.Find(ColumnCoord);
+	return Column != nullptr && Column->States[0] == EChunkState::Requested;
+}
+
+bool FChunkLifecycle::IsLoaded(const FIntVector2D& ColumnCoord) const
+{
+	const FColumn* const Column = Columns.Find(ColumnCoord);
+	return Column != nullptr && IsColumnLoaded(*Column);
+}
+
+bool FChunkLifecycle::IsUnloading(const FIntVector2D& ColumnCoord) const
+{
+	const FColumn* const Column = Columns.Find(ColumnCoord);
+	return Column != nullptr && Column->States[0] == EChunkState::Unloading;
+}
+
+bool FChunkLifecycle::HasMesh(const FIntVector3& ChunkCoord) const
+{
+	EChunkState State;
+	return GetState(ChunkCoord, State) && (State == EChunkState::Meshed || State == EChunkState::MeshedAndCollided);
+}
+
+bool FChunkLifecycle::HasCollision(const FIntVector3& ChunkCoord) const
+{
+	EChunkState State;
+	return GetState(ChunkCoord, State) && (State == EChunkState::Collided || State == EChunkState::MeshedAndCollided);
+}
+
+bool FChunkLifecycle::NeedsMesh(const FIntVector3& ChunkCoord) const
+{
+	// A Collided chunk keeps its state when a neighbor unloads, so the neighbors are counted as well
+	EChunkState State;
+	return GetState(ChunkCoord, State) && IsUnmeshed(State)
+		&& Columns[FIntVector2D(ChunkCoord.X, ChunkCoord.Y)].NumLoadedNeighbors == ARRAY_COUNT(NeighborOffsets);
+}
+
+bool FChunkLifecycle::NeedsCollision(const FIntVector3& ChunkCoord) const
+{
+	EChunkState State;
+	return GetState(ChunkCoord, State) && (State == EChunkState::NeighborsReady || State == EChunkState::Meshed)
+		&& Columns[FIntVector2D(ChunkCoord.X, ChunkCoord.Y)].NumLoadedNeighbors == ARRAY_COUNT(NeighborOffsets);
+}
+
+void FChunkLifecycle::TakeReadyColumns(TArray<FIntVector2D>& OutColumns)
+{
+	OutColumns.Append(ReadyColumns);
+	ReadyColumns.Reset();
+}
+
+void FChunkLifecycle::Empty()
+{
+	Columns.Empty();
+	ReadyColumns.Empty();
+	UnmeshedColumns.Empty();
+}
+
+void FChunkLifecycle::SetNeighborsReady(const FIntVector2D& ColumnCoord, FColumn& Column)
+{
+	bool bAnyUnmeshed = false;
+	for (EChunkState& State : Column.States)
+	{
+		if (State == EChunkState::Generated)
+		{
+			State = EChunkState::NeighborsReady;
+		}
+		bAnyUnmeshed |= IsUnmeshed(State);
+	}
+
+	ReadyColumns.Add(ColumnCoord);
+	if (bAnyUnmeshed)
+	{
+		UnmeshedColumns.Add(ColumnCoord);
+	}
+}
+
+void FChunkLifecycle::UpdateUnmeshed(const FIntVector2D& ColumnCoord, const FColumn& Column)
+{
+	if (Column.NumLoadedNeighbors == ARRAY_COUNT(NeighborOffsets))
+	{
+		for (const EChunkState State : Column.States)
+		{
+			if (IsUnmeshed(State))
+			{
+				return;
+			}
+		}
+	}
+	UnmeshedColumns.Remove(ColumnCoord);
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "ChunkOffsetTable.h"
+
+void FChunkOffsetTable::BuildCircle(const int32 InRadius)
+{
+	Build(InRadius, 0);
+}
+
+void FChunkOffsetTable::BuildSphere(const int32 InRadius)
+{
+	Build(InRadius, InRadius);
+}
+
+void FChunkOffsetTable::Build(const int32 InRadius, const int32 ZRadius)
+{
+	Radius = FMath::Max(0, InRadius);
+	const int32 RadiusSquared = FMath::Square<int32>(Radius);
+
+	Offsets.Reset();
+	for (int32 z = -ZRadius; z <= ZRadius; ++z)
+	{
+		for (int32 y = -Radius; y <= Radius; ++y)
+		{
+			for (int32 x = -Radius; x <= Radius; ++x)
+			{
+				const int32 DistanceSquared = x * x + y * y + z * z;
+				if (DistanceSquared < RadiusSquared)
+				{
+					FOffset& Offset = Offsets[Offsets.AddUninitialized()];
+					Offset.Offset = FIntVector3(x, y, z);
+					Offset.DistanceSquared = DistanceSquared;
+				}
+			}
+		}
+	}
+
+	// Stable, so offsets at the same distance keep the same order on every platform
+	Offsets.StableSort([](const FOffset& A, const FOffset& B)
+	{
+		return A.DistanceSquared < B.DistanceSquared;
+	});
+}
@@ -0,0 +1,499 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "ChunkMesher.h"
+
+#include "TerrainGenerator.h"
+#include "VoxelTerrain.h"
+
+#include "HAL/IConsoleManager.h"
+
+static_assert(CHUNK_SIZE == 32, "Every row of a slice is a uint32 and every column of the padded chunk a uint64");
+
+namespace
+{
+
+	const int32 PADDED_SIZE = FChunkMesher::PADDED_SIZE;
+
+	/* Distance in the padded voxels between neighbors along x, y and z */
+	const int32 PaddedStrides[3] = { 1, PADDED_SIZE, PADDED_SIZE * PADDED_SIZE };
+
+	FORCEINLINE EVoxelFace GetFace(const int32 Axis, const bool bBackFace)
+	{
+		static const EVoxelFace BackFaces[3] = { EVoxelFace::LEFT, EVoxelFace::BACK, EVoxelFace::BOTTOM };
+		static const EVoxelFace FrontFaces[3] = { EVoxelFace::RIGHT, EVoxelFace::FRONT, EVoxelFace::TOP };
+		return bBackFace ? BackFaces[Axis] : FrontFaces[Axis];
+	}
+
+	/** The faces of one side of an axis d, and the directions in chunk space of the slices, columns and rows they are meshed in */
+	struct FFaceAxes
+	{
+		EVoxelFace Face;
+		bool bBackFace;
+
+		/* Along d, u = (d + 1) % 3 and v = (d + 2) % 3 */
+		FIntVector3 D;
+		FIntVector3 U;
+		FIntVector3 V;
+
+		FFaceAxes(const int32 d, const bool bInBackFace)
+			: Face(GetFace(d, bInBackFace)), bBackFace(bInBackFace)
+		{
+			int32 Axes[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+			Axes[0][d] = 1;
+			Axes[1][(d + 1) % 3] = 1;
+			Axes[2][(d + 2) % 3] = 1;
+			D = FIntVector3(Axes[0][0], Axes[0][1], Axes[0][2]);
+			U = FIntVector3(Axes[1][0], Axes[1][1], Axes[1][2]);
+			V = FIntVector3(Axes[2][0], Axes[2][1], Axes[2][2]);
+		}
+	};
+
+	/** Bit k is whether the voxel k of the 8 from Voxels is solid */
+	FORCEINLINE uint64 GetSolidBits(const uint8* Voxels)
+	{
+		uint64 Word;
+		FMemory::Memcpy(&Word, Voxels, sizeof(Word));
+
+		// Sets the high bit of every byte that isn't zero, then gathers them in the top byte
+		const uint64 High = (((Word & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | Word) & 0x8080808080808080ull;
+		return ((High >> 7) * 0x0102040810204080ull) >> 56;
+	}
+
+	/** Transposes a 32 x 32 matrix of bits in place, bit i of Rows[k] becomes bit k of Rows[i] */
+	FORCEINLINE void TransposeBits(uint32 Rows[CHUNK_SIZE])
+	{
+		uint32 Mask = 0x0000FFFF;
+		for (int32 j = 16; j != 0; j >>= 1, Mask ^= Mask << j)
+		{
+			for (int32 k = 0; k < CHUNK_SIZE; k = (k + j + 1) & ~j)
+			{
+				const uint32 Swap = ((Rows[k] >> j) ^ Rows[k + j]) & Mask;
+				Rows[k + j] ^= Swap;
+				Rows[k] ^= Swap << j;
+			}
+		}
+	}
+
+	/** Adds the quad covering Width x Height faces from the column i and row j of a slice */
+	FORCEINLINE void AddQuad(const FFaceAxes& Axes, const int32 Slice, const int32 i, const int32 j, const int32 Width, const int32 Height,
+		const uint8 VoxelType, TArray<FChunkMesher::FQuad>& OutQuads)
+	{
+		// Front faces are on the far side of their voxel
+		const FIntVector3 Corner = Axes.D * (Axes.bBackFace ? Slice : Slice + 1) + Axes.U * i + Axes.V * j;
+		const FIntVector3 DU = Axes.U * Width;
+		const FIntVector3 DV = Axes.V * Height;
+
+		FChunkMesher::FQuad& Quad = OutQuads[OutQuads.AddUninitialized()];
+		Quad.Face = Axes.Face;
+		Quad.VoxelType = VoxelType;
+		if (!Axes.bBackFace)
+		{
+			Quad.Vertices[0] = Corner;
+			Quad.Vertices[1] = Corner + DV;
+			Quad.Vertices[2] = Corner + DU;
+			Quad.Vertices[3] = Corner + DU + DV;
+		}
+		else
+		{
+			Quad.Vertices[2] = Corner;
+			Quad.Vertices[0] = Corner + DU;
+			Quad.Vertices[3] = Corner + DV;
+			Quad.Vertices[1] = Corner + DU + DV;
+		}
+	}
+
+}
+
+void FChunkMesher::MeshChunk(const uint8* PaddedVoxels, TArray<FQuad>& OutQuads)
+{
+
+	// Every column of the padded chunk along every axis d, bit p is whether the voxel at p along d is solid.
+	// Indexed by the coordinates on the other two axes, v * PADDED_SIZE + u with u = (d + 1) % 3 and v = (d + 2) % 3.
+	// The columns along x are read straight from the voxels, the others are transposed from them, and only inside the chunk
+	uint64 Columns[3][PADDED_SIZE * PADDED_SIZE];
+
+	// Only chunks with more than one type of solid voxel inside need to look at the types of the faces at all
+	uint8 MinType = MAX_uint8;
+	uint8 MaxType = 0;
+
+	const uint8* Voxel = PaddedVoxels;
+	for (int32 z = 0; z < PADDED_SIZE; ++z)
+	{
+		for (int32 y = 0; y < PADDED_SIZE; ++y, Voxel += PADDED_SIZE)
+		{
+			uint64 Row = GetSolidBits(Voxel) | GetSolidBits(Voxel + 8) << 8 | GetSolidBits(Voxel + 16) << 16 | GetSolidBits(Voxel + 24) << 24;
+			Row |= (uint64)(Voxel[32] != 0) << 32 | (uint64)(Voxel[33] != 0) << 33;
+			Columns[0][z * PADDED_SIZE + y] = Row;
+
+			if (Row != 0 && (uint32)(y - 1) < CHUNK_SIZE && (uint32)(z - 1) < CHUNK_SIZE)
+			{
+				for (int32 x = 1; x <= CHUNK_SIZE; ++x)
+				{
+					// Air wraps around to the largest type for the min
+					MinType = FMath::Min<uint8>(MinType, Voxel[x] - 1);
+					MaxType = FMath::Max(MaxType, Voxel[x]);
+				}
+			}
+		}
+	}
+
+	// No solid voxel inside the chunk
+	if (MaxType == 0)
+	{
+		return;
+	}
+	const bool bMixedTypes = MinType + 1 != MaxType;
+
+	uint32 Block[CHUNK_SIZE];
+	for (int32 k = 1; k <= CHUNK_SIZE; ++k)
+	{
+		// The columns along z of the layer y = k, from the rows of x of every z
+		for (int32 z = 1; z <= CHUNK_SIZE; ++z)
+		{
+			Block[z - 1] = (uint32)(Columns[0][z * PADDED_SIZE + k] >> 1);
+		}
+		TransposeBits(Block);
+
+		const uint64 Below = Columns[0][k];
+		const uint64 Above = Columns[0][(PADDED_SIZE - 1) * PADDED_SIZE + k];
+		for (int32 x = 1; x <= CHUNK_SIZE; ++x)
+		{
+			Columns[2][k * PADDED_SIZE + x] = (uint64)Block[x - 1] << 1 | (Below >> x & 1) | (Above >> x & 1) << (PADDED_SIZE - 1);
+		}
+
+		// The columns along y of the layer z = k, from the rows of x of every y
+		const uint64* const Layer = &Columns[0][k * PADDED_SIZE];
+		for (int32 y = 1; y <= CHUNK_SIZE; ++y)
+		{
+			Block[y - 1] = (uint32)(Layer[y] >> 1);
+		}
+		TransposeBits(Block);
+
+		for (int32 x = 1; x <= CHUNK_SIZE; ++x)
+		{
+			Columns[1][x * PADDED_SIZE + k] = (uint64)Block[x - 1] << 1 | (Layer[0] >> x & 1) | (Layer[PADDED_SIZE - 1] >> x & 1) << (PADDED_SIZE - 1);
+		}
+	}
+
+	// The visible faces of every slice, bit i of Rows[Slice][j] is the face at <i, j>
+	uint32 Rows[CHUNK_SIZE][CHUNK_SIZE];
+
+	// The faces of every type in a slice that mixes types, CHUNK_SIZE rows per type, and the slot of the types in it
+	TArray<uint32, TInlineAllocator<CHUNK_SIZE * 8>> TypeRows;
+	TArray<uint8, TInlineAllocator<8>> SliceTypes;
+	int32 TypeSlots[256];
+	for (int32 i = 0; i < 256; ++i)
+	{
+		TypeSlots[i] = INDEX_NONE;
+	}
+
+	// Same order as the reference mesher: back faces first, then every axis
+	for (int32 b = 0; b < 2; ++b)
+	{
+		const bool bBackFace = b == 0;
+
+		for (int32 d = 0; d < 3; ++d)
+		{
+			const int32 u = (d + 1) % 3;
+			const int32 v = (d + 2) % 3;
+			const FFaceAxes Axes(d, bBackFace);
+
+			// A face is visible where a solid voxel has air on its side, the padding gives the neighbors of the first and last slices
+			FMemory::Memzero(Rows);
+			for (int32 j = 0; j < CHUNK_SIZE; ++j)
+			{
+				const uint64* const ColumnRow = &Columns[d][(j + 1) * PADDED_SIZE + 1];
+				for (int32 i = 0; i < CHUNK_SIZE; ++i)
+				{
+					const uint64 Column = ColumnRow[i];
+					if (Column == 0)
+					{
+						continue;
+					}
+
+					const uint64 Visible = bBackFace ? Column & ~(Column << 1) : Column & ~(Column >> 1);
+					uint32 SliceBits = (uint32)(Visible >> 1);
+					while (SliceBits != 0)
+					{
+						Rows[FMath::CountTrailingZeros(SliceBits)][j] |= 1u << i;
+						SliceBits &= SliceBits - 1;
+					}
+				}
+			}
+
+			for (int32 Slice = 0; Slice < CHUNK_SIZE; ++Slice)
+			{
+				uint32* const SliceRows = Rows[Slice];
+				const uint8* const SliceVoxels = PaddedVoxels + (Slice + 1) * PaddedStrides[d] + PaddedStrides[u] + PaddedStrides[v];
+
+				// Splits the faces of the slice by type, a slice of a single type is merged on the visible faces alone
+				SliceTypes.Reset();
+				TypeRows.Reset();
+				if (bMixedTypes)
+				{
+					for (int32 j = 0; j < CHUNK_SIZE; ++j)
+					{
+						uint32 RowBits = SliceRows[j];
+						while (RowBits != 0)
+						{
+							const int32 i = FMath::CountTrailingZeros(RowBits);
+							RowBits &= RowBits - 1;
+
+							const uint8 VoxelType = SliceVoxels[i * PaddedStrides[u] + j * PaddedStrides[v]];
+							int32& Slot = TypeSlots[VoxelType];
+							if (Slot == INDEX_NONE)
+							{
+								Slot = SliceTypes.Add(VoxelType);
+								TypeRows.AddZeroed(CHUNK_SIZE);
+							}
+							TypeRows[Slot * CHUNK_SIZE + j] |= 1u << i;
+						}
+					}
+				}
+				const bool bSliceMixesTypes = SliceTypes.Num() > 1;
+
+				for (int32 j = 0; j < CHUNK_SIZE; ++j)
+				{
+					while (SliceRows[j] != 0)
+					{
+						const int32 i = FMath::CountTrailingZeros(SliceRows[j]);
+						const uint8 VoxelType = SliceVoxels[i * PaddedStrides[u] + j * PaddedStrides[v]];
+
+						// The faces left to mesh that can be merged with this one, the ones of its type when the slice mixes them
+						const uint32* TypeMask = nullptr;
+						if (bSliceMixesTypes)
+						{
+							TypeMask = &TypeRows[TypeSlots[VoxelType] * CHUNK_SIZE];
+						}
+
+						// The quad is as wide as the run of mergeable faces from i
+						const uint32 Mergeable = TypeMask != nullptr ? SliceRows[j] & TypeMask[j] : SliceRows[j];
+						const uint32 Gaps = ~(Mergeable >> i);
+						const int32 Width = Gaps == 0 ? CHUNK_SIZE - i : FMath::CountTrailingZeros(Gaps);
+						const uint32 RunMask = (Width == CHUNK_SIZE ? MAX_uint32 : (1u << Width) - 1) << i;
+
+						// And as high as the rows that have every one of those faces left
+						int32 Height = 1;
+						for (; j + Height < CHUNK_SIZE; ++Height)
+						{
+							const uint32 Row = TypeMask != nullptr ? SliceRows[j + Height] & TypeMask[j + Height] : SliceRows[j + Height];
+							if ((Row & RunMask) != RunMask)
+							{
+								break;
+							}
+						}
+
+						for (int32 Row = j; Row < j + Height; ++Row)
+						{
+							SliceRows[Row] &= ~RunMask;
+						}
+
+						AddQuad(Axes, Slice, i, j, Width, Height, VoxelType, OutQuads);
+					}
+				}
+
+				for (const uint8 VoxelType : SliceTypes)
+				{
+					TypeSlots[VoxelType] = INDEX_NONE;
+				}
+			}
+		}
+	}
+
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+
+	/* The voxel at a time greedy mesher MeshChunk replaced, kept to check and time it against */
+	void MeshChunkReference(const uint8* PaddedVoxels, TArray<FChunkMesher::FQuad>& OutQuads)
+	{
+
+		// The greedy meshing of ChunkMeshComponent.cpp, see the license there, without the ambient occlusion
+		uint8 Mask[CHUNK_SIZE * CHUNK_SIZE];
+
+		for (bool bBackFace = true, b = false; b != bBackFace; bBackFace = bBackFace && b, b = !b)
+		{
+			for (int32 d = 0; d < 3; d++)
+			{
+				const int32 u = (d + 1) % 3;
+				const int32 v = (d + 2) % 3;
+
+				const FFaceAxes Axes(d, bBackFace);
+				const FIntVector3 Normal = UChunkUtils::GetNormal(Axes.Face);
+
+				int32 x[] = { 0, 0, 0 };
+				for (x[d] = 0; x[d] < CHUNK_SIZE; x[d]++)
+				{
+					int32 n = 0;
+					for (x[v] = 0; x[v] < CHUNK_SIZE; x[v]++)
+					{
+						for (x[u] = 0; x[u] < CHUNK_SIZE; x[u]++)
+						{
+							const FIntVector3 LocalCoord(x[0] + 1, x[1] + 1, x[2] + 1);
+							const uint8 VoxelType = PaddedVoxels[LocalCoord.X + (LocalCoord.Y * PADDED_SIZE) + (LocalCoord.Z * PADDED_SIZE * PADDED_SIZE)];
+
+							const FIntVector3 FaceVoxel = LocalCoord + Normal;
+							const bool bIsFaceVisible = PaddedVoxels[FaceVoxel.X + (FaceVoxel.Y * PADDED_SIZE) + (FaceVoxel.Z * PADDED_SIZE * PADDED_SIZE)] == 0;
+
+							Mask[n++] = bIsFaceVisible ? VoxelType : 0;
+						}
+					}
+
+					n = 0;
+					for (int32 j = 0; j < CHUNK_SIZE; j++)
+					{
+						for (int32 i = 0; i < CHUNK_SIZE; )
+						{
+							if (Mask[n] == 0)
+							{
+								i++;
+								n++;
+								continue;
+							}
+
+							int32 w, h;
+							for (w = 1; w + i < CHUNK_SIZE && Mask[n + w] == Mask[n]; w++)
+							{
+							}
+
+							bool bDone = false;
+							for (h = 1; j + h < CHUNK_SIZE; h++)
+							{
+								for (int32 k = 0; k < w; k++)
+								{
+									if (Mask[n + k + h * CHUNK_SIZE] != Mask[n])
+									{
+										bDone = true;
+										break;
+									}
+								}
+								if (bDone)
+								{
+									break;
+								}
+							}
+
+							AddQuad(Axes, x[d], i, j, w, h, Mask[n], OutQuads);
+
+							for (int32 l = 0; l < h; ++l)
+							{
+								for (int32 k = 0; k < w; ++k)
+								{
+									Mask[n + k + l * CHUNK_SIZE] = 0;
+								}
+							}
+							i += w;
+							n += w;
+						}
+					}
+				}
+			}
+		}
+
+	}
+
+	void BenchmarkMesher(const TArray<FString>& Args)
+	{
+		// The chunks on the border of the square have no neighbors, so only the ones inside it are meshed
+		const int32 NumColumnsPerSide = Args.Num() > 0 ? FMath::Max(3, FCString::Atoi(*Args[0])) : 4;
+		const AVoxelTerrain* const DefaultTerrain = GetDefault<AVoxelTerrain>();
+
+		TArray<FChunkColumn> Columns;
+		Columns.SetNum(NumColumnsPerSide * NumColumnsPerSide);
+		for (int32 ColumnY = 0; ColumnY < NumColumnsPerSide; ++ColumnY)
+		{
+			for (int32 ColumnX = 0; ColumnX < NumColumnsPerSide; ++ColumnX)
+			{
+				UTerrainGenerator::GenerateColumn(DefaultTerrain, FIntVector2D(ColumnX, ColumnY), Columns[ColumnX + ColumnY * NumColumnsPerSide], DefaultTerrain->TerrainGenParameters);
+			}
+		}
+
+		// Outside of the world is air, like the terrain gives chunks that aren't loaded
+		const auto GetVoxel = [&](const int32 X, const int32 Y, const int32 Z) -> uint8
+		{
+			if (Z < 0 || Z >= WORLD_HEIGHT)
+			{
+				return 0;
+			}
+			const FChunkColumn& Column = Columns[(X >> CHUNK_SHIFT) + (Y >> CHUNK_SHIFT) * NumColumnsPerSide];
+			const int32 LocalX = X & (CHUNK_SIZE - 1);
+			const int32 LocalY = Y & (CHUNK_SIZE - 1);
+			const int32 LocalZ = Z & (CHUNK_SIZE - 1);
+			return Column.Chunks[Z >> CHUNK_SHIFT].Voxels[LocalX | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT)];
+		};
+
+		const int32 PaddedSize = FChunkMesher::PADDED_SIZE;
+		TArray<TArray<uint8>> PaddedChunks;
+		for (int32 ChunkY = 1; ChunkY < NumColumnsPerSide - 1; ++ChunkY)
+		{
+			for (int32 ChunkX = 1; ChunkX < NumColumnsPerSide - 1; ++ChunkX)
+			{
+				for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+				{
+					TArray<uint8>& Voxels = PaddedChunks[PaddedChunks.AddDefaulted()];
+					Voxels.SetNumUninitialized(PaddedSize * PaddedSize * PaddedSize);
+					for (int32 z = 0; z < PaddedSize; ++z)
+					{
+						for (int32 y = 0; y < PaddedSize; ++y)
+						{
+							for (int32 x = 0; x < PaddedSize; ++x)
+							{
+								Voxels[x + y * PaddedSize + z * PaddedSize * PaddedSize] = GetVoxel((ChunkX << CHUNK_SHIFT) + x - 1, (ChunkY << CHUNK_SHIFT) + y - 1, (ChunkZ << CHUNK_SHIFT) + z - 1);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		TArray<TArray<FChunkMesher::FQuad>> ReferenceQuads;
+		TArray<TArray<FChunkMesher::FQuad>> Quads;
+		ReferenceQuads.SetNum(PaddedChunks.Num());
+		Quads.SetNum(PaddedChunks.Num());
+
+		const double ReferenceStartTime = FPlatformTime::Seconds();
+		for (int32 ChunkIndex = 0; ChunkIndex < PaddedChunks.Num(); ++ChunkIndex)
+		{
+			MeshChunkReference(PaddedChunks[ChunkIndex].GetData(), ReferenceQuads[ChunkIndex]);
+		}
+		const double ReferenceTime = FPlatformTime::Seconds() - ReferenceStartTime;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 ChunkIndex = 0; ChunkIndex < PaddedChunks.Num(); ++ChunkIndex)
+		{
+			FChunkMesher::MeshChunk(PaddedChunks[ChunkIndex].GetData(), Quads[ChunkIndex]);
+		}
+		const double Time = FPlatformTime::Seconds() - StartTime;
+
+		int32 NumQuads = 0;
+		int32 NumMismatches = 0;
+		for (int32 ChunkIndex = 0; ChunkIndex < PaddedChunks.Num(); ++ChunkIndex)
+		{
+			NumQuads += ReferenceQuads[ChunkIndex].Num();
+			if (Quads[ChunkIndex] != ReferenceQuads[ChunkIndex])
+			{
+				++NumMismatches;
+			}
+		}
+
+		const int32 NumChunks = PaddedChunks.Num();
+		UE_LOG(LogStats, Log, TEXT("Mesher Benchmark: %d chunks, %d quads"), NumChunks, NumQuads);
+		UE_LOG(LogStats, Log, TEXT("    Reference: %.3f ms per chunk"), ReferenceTime * 1000.0 / NumChunks);
+		UE_LOG(LogStats, Log, TEXT("    Bitmask: %.3f ms per chunk, %.2fx faster"), Time * 1000.0 / NumChunks, Time > 0.0 ? ReferenceTime / Time : 0.0);
+		if (NumMismatches > 0)
+		{
+			UE_LOG(LogStats, Error, TEXT("    %d chunks got different quads from the two meshers"), NumMismatches);
+		}
+	}
+
+	FAutoConsoleCommand BenchmarkMesherCommand(
+		TEXT("Aetheria.Benchmark.Mesher"),
+		TEXT("Meshes the chunks of a square of columns of the default terrain with the bitmask mesher and the voxel at a time one, and checks they give the same quads. Usage: Aetheria.Benchmark.Mesher [ColumnsPerSide]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkMesher));
+
+}
+
+#endif
@@ -0,0 +1,193 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainFrameBudget.h"
+
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+
+	TAutoConsoleVariable<int32> CVarStarvationFrames(
+		TEXT("Aetheria.Terrain.StarvationFrames"),
+		4,
+		TEXT("Number of frames in a row a kind of terrain work can be left without time before it is allowed one item anyway."));
+
+	TAutoConsoleVariable<int32> CVarShowFrameBudget(
+		TEXT("Aetheria.Terrain.ShowFrameBudget"),
+		0,
+		TEXT("1 shows the time every kind of terrain work used in the last frame on screen."));
+
+	// Insertion is cheap per column but has the most items, meshes are the most expensive items, and unloading can always wait
+	const double WorkShares[(int32)ETerrainWork::Num] = { 0.3, 0.2, 0.4, 0.1 };
+
+}
+
+FTerrainFrameBudget::FScopedItem::FScopedItem(FTerrainFrameBudget& InBudget, const ETerrainWork InWork)
+	: Budget(InBudget), Work(InWork), StartCycles(FPlatformTime::Cycles())
+{
+}
+
+FTerrainFrameBudget::FScopedItem::~FScopedItem()
+{
+	Budget.AddItem(Work, FPlatformTime::Cycles() - StartCycles);
+}
+
+FTerrainFrameBudget::FTerrainFrameBudget()
+	: BudgetSeconds(0.0), SpareSeconds(0.0)
+{
+	FMemory::Memzero(Works);
+	Reset();
+}
+
+void FTerrainFrameBudget::BeginFrame(const double InBudgetSeconds)
+{
+	BudgetSeconds = FMath::Max(0.0, InBudgetSeconds);
+	SpareSeconds = 0.0;
+
+	for (int32 i = 0; i < (int32)ETerrainWork::Num; ++i)
+	{
+		FWorkState& State = Works[i];
+		State.Stats.AllowedSeconds = FMath::Max(0.0, WorkShares[i] * BudgetSeconds - State.DebtSeconds);
+		State.Stats.UsedSeconds = 0.0;
+		State.Stats.NumItems = 0;
+		State.Stats.bOutOfTime = false;
+		State.bFinished = false;
+	}
+}
+
+bool FTerrainFrameBudget::HasTime(const ETerrainWork Work)
+{
+	FWorkState& State = Works[(int32)Work];
+
+	if (State.Stats.UsedSeconds < State.Stats.AllowedSeconds)
+	{
+		return true;
+	}
+
+	// Takes all the time the work before it gave up, whatever it doesn't use is given on when it finishes
+	if (SpareSeconds > 0.0)
+	{
+		State.Stats.AllowedSeconds += SpareSeconds;
+		SpareSeconds = 0.0;
+
+		if (State.Stats.UsedSeconds < State.Stats.AllowedSeconds)
+		{
+			return true;
+		}
+	}
+
+	if (State.Stats.NumItems == 0 && State.StarvedFrames >= CVarStarvationFrames.GetValueOnGameThread())
+	{
+		return true;
+	}
+
+	State.Stats.bOutOfTime = true;
+	return false;
+}
+
+void FTerrainFrameBudget::Finish(const ETerrainWork Work)
+{
+	FWorkState& State = Works[(int32)Work];
+	if (State.bFinished)
+	{
+		return;
+	}
+
+	State.bFinished = true;
+	if (State.Stats.UsedSeconds < State.Stats.AllowedSeconds)
+	{
+		SpareSeconds += State.Stats.AllowedSeconds - State.Stats.UsedSeconds;
+		State.Stats.AllowedSeconds = State.Stats.UsedSeconds;
+	}
+}
+
+void FTerrainFrameBudget::EndFrame()
+{
+	double FrameSeconds = 0.0;
+
+	for (int32 i = 0; i < (int32)ETerrainWork::Num; ++i)
+	{
+		FWorkState& State = Works[i];
+
+		// Only one frame's share is paid back, so a single slow item doesn't stall the work for many frames
+		State.DebtSeconds = FMath::Clamp(State.Stats.UsedSeconds - State.Stats.AllowedSeconds, 0.0, WorkShares[i] * BudgetSeconds);
+
+		if (State.Stats.NumItems > 0 || !State.Stats.bOutOfTime)
+		{
+			State.StarvedFrames = 0;
+		}
+		else
+		{
+			++State.StarvedFrames;
+		}
+
+		FrameSeconds += State.Stats.UsedSeconds;
+		Totals.UsedSeconds[i] += State.Stats.UsedSeconds;
+		Totals.MaxUsedSeconds[i] = FMath::Max(Totals.MaxUsedSeconds[i], State.Stats.UsedSeconds);
+	}
+
+	++Totals.Frames;
+	Totals.FramesOverBudget += FrameSeconds > BudgetSeconds ? 1 : 0;
+	Totals.MaxFrameSeconds = FMath::Max(Totals.MaxFrameSeconds, FrameSeconds);
+
+	if (CVarShowFrameBudget.GetValueOnGameThread() != 0 && GEngine != nullptr)
+	{
+		FString Message = FString::Printf(TEXT("Terrain %.3f / %.3f ms"), FrameSeconds * 1000.0, BudgetSeconds * 1000.0);
+		for (int32 i = 0; i < (int32)ETerrainWork::Num; ++i)
+		{
+			const FWorkStats& Stats = Works[i].Stats;
+			Message += FString::Printf(TEXT("\n    %s: %.3f / %.3f ms, %d items%s"), GetWorkName((ETerrainWork)i),
+				Stats.UsedSeconds * 1000.0, Stats.AllowedSeconds * 1000.0, Stats.NumItems, Stats.bOutOfTime ? TEXT(", out of time") : TEXT(""));
+		}
+
+		// A fixed key replaces last frame's message instead of stacking them
+		GEngine->AddOnScreenDebugMessage((uint64)(UPTRINT)this, 0.0f, FrameSeconds > BudgetSeconds ? FColor::Orange : FColor::White, Message);
+	}
+}
+
+double FTerrainFrameBudget::GetUsedSeconds() const
+{
+	double UsedSeconds = 0.0;
+	for (const FWorkState& State : Works)
+	{
+		UsedSeconds += State.Stats.UsedSeconds;
+	}
+	return UsedSeconds;
+}
+
+const TCHAR* FTerrainFrameBudget::GetWorkName(const ETerrainWork Work)
+{
+	switch (Work)
+	{
+	case ETerrainWork::Insertion: return TEXT("Insertion");
+	case ETerrainWork::Collision: return TEXT("Collision");
+	case ETerrainWork::Meshing: return TEXT("Meshing");
+	case ETerrainWork::Unloading: return TEXT("Unloading");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FTerrainFrameBudget::Log() const
+{
+	UE_LOG(LogStats, Log, TEXT("Terrain Frame Budget: %.3f ms, %lld frames, %lld over budget, %.3f ms max"),
+		BudgetSeconds * 1000.0, Totals.Frames, Totals.FramesOverBudget, Totals.MaxFrameSeconds * 1000.0);
+
+	for (int32 i = 0; i < (int32)ETerrainWork::Num; ++i)
+	{
+		UE_LOG(LogStats, Log, TEXT("    %s: %.3f ms share, %.3f ms average, %.3f ms max"), GetWorkName((ETerrainWork)i), WorkShares[i] * BudgetSeconds * 1000.0,
+			Totals.Frames > 0 ? Totals.UsedSeconds[i] * 1000.0 / Totals.Frames : 0.0, Totals.MaxUsedSeconds[i] * 1000.0);
+	}
+}
+
+void FTerrainFrameBudget::Reset()
+{
+	FMemory::Memzero(Totals);
+}
+
+void FTerrainFrameBudget::AddItem(const ETerrainWork Work, const uint32 Cycles)
+{
+	FWorkState& State = Works[(int32)Work];
+	State.Stats.UsedSeconds += Cycles * FPlatformTime::GetSecondsPerCycle();
+	++State.Stats.NumItems;
+}
@@ -0,0 +1,417 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainInterestManager.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+
+	TAutoConsoleVariable<float> CVarPrefetchSeconds(
+		TEXT("Aetheria.Streaming.PrefetchSeconds"),
+		4.0f,
+		TEXT("Moving viewers prefetch the columns they reach within this many seconds at their current velocity. 0 turns prefetching off."));
+
+	TAutoConsoleVariable<int32> CVarPrefetchMaxColumns(
+		TEXT("Aetheria.Streaming.PrefetchMaxColumns"),
+		8,
+		TEXT("The furthest a viewer prefetches past its load distance, in columns."));
+
+	TAutoConsoleVariable<float> CVarPrefetchHalfAngle(
+		TEXT("Aetheria.Streaming.PrefetchHalfAngle"),
+		30.0f,
+		TEXT("Half the angle in degrees of the cone of columns prefetched ahead of a moving viewer."));
+
+	TAutoConsoleVariable<float> CVarAheadDistanceScale(
+		TEXT("Aetheria.Streaming.AheadDistanceScale"),
+		0.25f,
+		TEXT("The squared distance of the columns in the cone ahead of a moving viewer is multiplied by this when ordering requests."));
+
+	TAutoConsoleVariable<float> CVarBehindDistanceScale(
+		TEXT("Aetheria.Streaming.BehindDistanceScale"),
+		2.0f,
+		TEXT("The squared distance of the columns behind a moving viewer is multiplied by this when ordering requests."));
+
+	const float ColumnWorldSize = CHUNK_SIZE * 100.0f;
+
+	// Which eighth of a circle the viewer looks at, -1 without a view
+	int32 GetViewSector(const FTerrainViewer& Viewer)
+	{
+		if (Viewer.ViewDirection.IsNearlyZero())
+		{
+			return -1;
+		}
+		return FMath::FloorToInt(FRotator::ClampAxis(FMath::RadiansToDegrees(FMath::Atan2(Viewer.ViewDirection.Y, Viewer.ViewDirection.X))) / 45.0f);
+	}
+
+	FORCEINLINE int32 GetDistanceSquared(const FIntVector2D& A, const FIntVector2D& B)
+	{
+		return FMath::Square<int32>(A.X - B.X) + FMath::Square<int32>(A.Y - B.Y);
+	}
+
+}
+
+void FTerrainInterestManager::SetViewers(const TArray<FTerrainViewer>& NewViewers, FChanges& OutChanges)
+{
+
+	OutChanges.bViewersMoved = false;
+	OutChanges.bViewsTurned = false;
+	OutChanges.bPrefetchChanged = false;
+
+	// Every count is added before any is removed, so a column passed from one viewer to another never leaves the union
+	TArray<FIntVector2D> RequiredGained;
+	TArray<FIntVector2D> RequiredLost;
+	TArray<FIntVector2D> RetainedGained;
+	TArray<FIntVector2D> RetainedLost;
+
+	TArray<FViewerState> NewStates;
+	NewStates.Reserve(NewViewers.Num());
+
+	for (const FTerrainViewer& Viewer : NewViewers)
+	{
+		FViewerState& State = NewStates[NewStates.AddUninitialized()];
+		State.Viewer = Viewer;
+		State.ChunkPosition = Viewer.GetChunkPosition();
+		State.ViewSector = GetViewSector(Viewer);
+
+		UpdateMotion(State);
+
+		FindOrBuildCircle(Viewer.DrawDistance);
+		if (!Spheres.Contains(Viewer.CollisionDistance))
+		{
+			Spheres.Add(Viewer.CollisionDistance).BuildSphere(Viewer.CollisionDistance);
+		}
+
+		const FIntVector2D NewColumn(State.ChunkPosition.X, State.ChunkPosition.Y);
+		const FViewerState* const OldState = Viewers.FindByPredicate([&Viewer](const FViewerState& Other) { return Other.Viewer.Key == Viewer.Key; });
+
+		// The cone only changes with the column, the heading sector and the speed, so it isn't rebuilt every tick
+		const bool bPrefetchChanged = OldState == nullptr || OldState->ChunkPosition.X != State.ChunkPosition.X || OldState->ChunkPosition.Y != State.ChunkPosition.Y
+			|| OldState->HeadingSector != State.HeadingSector || OldState->PrefetchLength != State.PrefetchLength || OldState->Viewer.LoadDistance != Viewer.LoadDistance;
+		if (bPrefetchChanged)
+		{
+			OutChanges.bPrefetchChanged = true;
+			GetPrefetchColumns(State, State.PrefetchColumns);
+
+			const TSet<FIntVector2D> NewPrefetch(State.PrefetchColumns);
+			const TSet<FIntVector2D> OldPrefetch = OldState != nullptr ? TSet<FIntVector2D>(OldState->PrefetchColumns) : TSet<FIntVector2D>();
+			for (const FIntVector2D& ColumnCoord : State.PrefetchColumns)
+			{
+				if (!OldPrefetch.Contains(ColumnCoord))
+				{
+					RequiredGained.Add(ColumnCoord);
+					RetainedGained.Add(ColumnCoord);
+				}
+			}
+			for (const FIntVector2D& ColumnCoord : OldPrefetch)
+			{
+				if (!NewPrefetch.Contains(ColumnCoord))
+				{
+					RequiredLost.Add(ColumnCoord);
+					RetainedLost.Add(ColumnCoord);
+				}
+			}
+		}
+		else
+		{
+			State.PrefetchColumns = OldState->PrefetchColumns;
+		}
+
+		if (OldState == nullptr)
+		{
+			OutChanges.bViewersMoved = true;
+			GetGainedColumns(NewColumn, Viewer.LoadDistance, nullptr, 0, RequiredGained);
+			GetGainedColumns(NewColumn, Viewer.LoadDistance + 1, nullptr, 0, RetainedGained);
+			continue;
+		}
+
+		const bool bRadiiChanged = OldState->Viewer.LoadDistance != Viewer.LoadDistance || OldState->Viewer.DrawDistance != Viewer.DrawDistance || OldState->Viewer.CollisionDistance != Viewer.CollisionDistance;
+		OutChanges.bViewersMoved |= OldState->ChunkPosition != State.ChunkPosition || bRadiiChanged;
+		OutChanges.bViewsTurned |= OldState->ViewSector != State.ViewSector;
+
+		const FIntVector2D OldColumn(OldState->ChunkPosition.X, OldState->ChunkPosition.Y);
+		const int32 OldLoadDistance = OldState->Viewer.LoadDistance;
+		if (OldColumn != NewColumn || OldLoadDistance != Viewer.LoadDistance)
+		{
+			GetGainedColumns(NewColumn, Viewer.LoadDistance, &OldColumn, OldLoadDistance, RequiredGained);
+			GetGainedColumns(OldColumn, OldLoadDistance, &NewColumn, Viewer.LoadDistance, RequiredLost);
+			GetGainedColumns(NewColumn, Viewer.LoadDistance + 1, &OldColumn, OldLoadDistance + 1, RetainedGained);
+			GetGainedColumns(OldColumn, OldLoadDistance + 1, &NewColumn, Viewer.LoadDistance + 1, RetainedLost);
+		}
+	}
+
+	// Viewers that are gone lose their whole circles
+	for (const FViewerState& OldState : Viewers)
+	{
+		if (!NewViewers.ContainsByPredicate([&OldState](const FTerrainViewer& Viewer) { return Viewer.Key == OldState.Viewer.Key; }))
+		{
+			OutChanges.bViewersMoved = true;
+			const FIntVector2D OldColumn(OldState.ChunkPosition.X, OldState.ChunkPosition.Y);
+			GetGainedColumns(OldColumn, OldState.Viewer.LoadDistance, nullptr, 0, RequiredLost);
+			GetGainedColumns(OldColumn, OldState.Viewer.LoadDistance + 1, nullptr, 0, RetainedLost);
+			RequiredLost.Append(OldState.PrefetchColumns);
+			RetainedLost.Append(OldState.PrefetchColumns);
+		}
+	}
+
+	Viewers = MoveTemp(NewStates);
+
+	AddColumns(RequiredColumns, RequiredGained, &OutChanges.EnteredColumns);
+	AddColumns(RetainedColumns, RetainedGained, nullptr);
+	RemoveColumns(RequiredColumns, RequiredLost, OutChanges.LeftColumns);
+	RemoveColumns(RetainedColumns, RetainedLost, OutChanges.ReleasedColumns);
+
+}
+
+bool FTerrainInterestManager::IsInDrawDistance(const FIntVector2D& ColumnCoord) const
+{
+	for (const FViewerState& State : Viewers)
+	{
+		if (GetDistanceSquared(ColumnCoord, FIntVector2D(State.ChunkPosition.X, State.ChunkPosition.Y)) < FMath::Square<int32>(State.Viewer.DrawDistance))
+		{
+			return true;
+		}
+	}
+
+	for (const TPair<int32, FRegion>& Pair : Regions)
+	{
+		const FRegion& Region = Pair.Value;
+		if (Region.bDraw && ColumnCoord >= Region.MinDrawColumn && ColumnCoord <= Region.MaxDrawColumn)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FTerrainInterestManager::AddRegion(const int32 RegionId, const FIntVector2D& MinColumn, const FIntVector2D& MaxColumn, const bool bDraw, const float Priority, FChanges& OutChanges)
+{
+	OutChanges.bViewersMoved = false;
+	OutChanges.bViewsTurned = false;
+	OutChanges.bPrefetchChanged = false;
+
+	FRegion& Region = Regions.Add(RegionId);
+	Region.MinDrawColumn = MinColumn;
+	Region.MaxDrawColumn = MaxColumn;
+	Region.MinColumn = bDraw ? MinColumn - 1 : MinColumn;
+	Region.MaxColumn = bDraw ? MaxColumn + 1 : MaxColumn;
+	Region.bDraw = bDraw;
+	Region.Priority = FMath::Max(0.0f, Priority);
+
+	TArray<FIntVector2D> Columns;
+	GetRegionColumns(Region, Columns);
+	AddColumns(RequiredColumns, Columns, &OutChanges.EnteredColumns);
+	AddColumns(RetainedColumns, Columns, nullptr);
+}
+
+void FTerrainInterestManager::RemoveRegion(const int32 RegionId, FChanges& OutChanges)
+{
+	OutChanges.bViewersMoved = false;
+	OutChanges.bViewsTurned = false;
+	OutChanges.bPrefetchChanged = false;
+
+	FRegion Region;
+	if (!Regions.RemoveAndCopyValue(RegionId, Region))
+	{
+		return;
+	}
+
+	TArray<FIntVector2D> Columns;
+	GetRegionColumns(Region, Columns);
+	RemoveColumns(RequiredColumns, Columns, OutChanges.LeftColumns);
+	RemoveColumns(RetainedColumns, Columns, OutChanges.ReleasedColumns);
+}
+
+void FTerrainInterestManager::GetRegionCenters(TArray<FIntVector2D>& OutColumns) const
+{
+	for (const TPair<int32, FRegion>& Pair : Regions)
+	{
+		OutColumns.Add(FIntVector2D((Pair.Value.MinColumn.X + Pair.Value.MaxColumn.X) >> 1, (Pair.Value.MinColumn.Y + Pair.Value.MaxColumn.Y) >> 1));
+	}
+}
+
+float FTerrainInterestManager::GetRequestPriority(const FIntVector2D& ColumnCoord, const float OutOfViewScale) const
+{
+
+	const float AheadScale = FMath::Max(0.0f, CVarAheadDistanceScale.GetValueOnGameThread());
+	const float BehindScale = FMath::Max(1.0f, CVarBehindDistanceScale.GetValueOnGameThread());
+	const float AheadCos = FMath::Cos(FMath::DegreesToRadians(CVarPrefetchHalfAngle.GetValueOnGameThread()));
+
+	// A column is in view if any part of its bounding circle is inside the horizontal field of view
+	const float ColumnRadius = ColumnWorldSize * HALF_SQRT_2;
+	const FVector2D ColumnCenter((ColumnCoord.X + 0.5f) * ColumnWorldSize, (ColumnCoord.Y + 0.5f) * ColumnWorldSize);
+
+	float Priority = MAX_flt;
+	for (const FViewerState& State : Viewers)
+	{
+		const float DistanceSquared = GetDistanceSquared(ColumnCoord, FIntVector2D(State.ChunkPosition.X, State.ChunkPosition.Y));
+
+		bool bIsInView = State.ViewSector < 0;
+		if (!bIsInView)
+		{
+			const FVector2D ToColumn = ColumnCenter - FVector2D(State.Viewer.Location.X, State.Viewer.Location.Y);
+			const float DistanceToColumn = ToColumn.Size();
+
+			bIsInView = DistanceToColumn <= ColumnRadius;
+			if (!bIsInView)
+			{
+				const FVector2D ViewDirection = FVector2D(State.Viewer.ViewDirection).GetSafeNormal();
+				const float Angle = FMath::Acos(FMath::Clamp(FVector2D::DotProduct(ToColumn / DistanceToColumn, ViewDirection), -1.0f, 1.0f));
+				bIsInView = Angle <= State.Viewer.HalfFOV + FMath::Asin(ColumnRadius / DistanceToColumn);
+			}
+		}
+
+		float ViewerPriority = bIsInView ? DistanceSquared : DistanceSquared * OutOfViewScale;
+
+		if (State.HeadingSector >= 0 && DistanceSquared > 0.0f)
+		{
+			const FVector2D Heading = FVector2D(State.Viewer.Velocity).GetSafeNormal();
+			const FVector2D ToColumn = FVector2D(ColumnCoord.X - State.ChunkPosition.X, ColumnCoord.Y - State.ChunkPosition.Y).GetSafeNormal();
+			const float HeadingCos = FVector2D::DotProduct(Heading, ToColumn);
+			if (HeadingCos >= AheadCos)
+			{
+				ViewerPriority *= AheadScale;
+			}
+			else if (HeadingCos < 0.0f)
+			{
+				ViewerPriority *= BehindScale;
+			}
+		}
+
+		Priority = FMath::Min(Priority, ViewerPriority);
+	}
+
+	for (const TPair<int32, FRegion>& Pair : Regions)
+	{
+		const FRegion& Region = Pair.Value;
+		if (ColumnCoord >= Region.MinColumn && ColumnCoord <= Region.MaxColumn)
+		{
+			Priority = FMath::Min(Priority, FMath::Square(Region.Priority));
+		}
+	}
+	return Priority;
+
+}
+
+void FTerrainInterestManager::Empty()
+{
+	Viewers.Empty();
+	RequiredColumns.Empty();
+	RetainedColumns.Empty();
+	Circles.Empty();
+	Spheres.Empty();
+	Regions.Empty();
+}
+
+const FChunkOffsetTable& FTerrainInterestManager::FindOrBuildCircle(const int32 Radius)
+{
+	FChunkOffsetTable* Circle = Circles.Find(Radius);
+	if (Circle == nullptr)
+	{
+		Circle = &Circles.Add(Radius);
+		Circle->BuildCircle(Radius);
+	}
+	return *Circle;
+}
+
+void FTerrainInterestManager::UpdateMotion(FViewerState& State)
+{
+	State.PredictedColumn = FIntVector2D(State.ChunkPosition.X, State.ChunkPosition.Y);
+	State.HeadingSector = -1;
+	State.PrefetchLength = 0;
+
+	const FVector2D Velocity(State.Viewer.Velocity);
+	const float Travel = Velocity.Size() * FMath::Max(0.0f, CVarPrefetchSeconds.GetValueOnGameThread());
+
+	// Too slow to leave its column before the columns ahead could be generated anyway
+	if (Travel < ColumnWorldSize * 0.5f)
+	{
+		return;
+	}
+
+	const FVector2D Predicted = FVector2D(State.Viewer.Location) + Velocity.GetSafeNormal() * Travel;
+	State.PredictedColumn = FIntVector2D((int32)(Predicted.X / 100.0f) >> CHUNK_SHIFT, (int32)(Predicted.Y / 100.0f) >> CHUNK_SHIFT);
+	State.HeadingSector = FMath::FloorToInt(FRotator::ClampAxis(FMath::RadiansToDegrees(FMath::Atan2(Velocity.Y, Velocity.X)) + 22.5f) / 45.0f) % 8;
+	State.PrefetchLength = FMath::Min(FMath::CeilToInt(Travel / ColumnWorldSize), FMath::Max(0, CVarPrefetchMaxColumns.GetValueOnGameThread()));
+}
+
+void FTerrainInterestManager::GetPrefetchColumns(const FViewerState& State, TArray<FIntVector2D>& OutColumns)
+{
+	OutColumns.Reset();
+	if (State.HeadingSector < 0 || State.PrefetchLength <= 0)
+	{
+		return;
+	}
+
+	// The cone points at the middle of the heading sector, so it stays the same while the viewer keeps roughly the same heading
+	const float HeadingAngle = FMath::DegreesToRadians(State.HeadingSector * 45.0f);
+	const FVector2D Heading(FMath::Cos(HeadingAngle), FMath::Sin(HeadingAngle));
+	const float ConeCos = FMath::Cos(FMath::DegreesToRadians(CVarPrefetchHalfAngle.GetValueOnGameThread()));
+
+	const int32 LoadDistanceSquared = FMath::Square<int32>(State.Viewer.LoadDistance);
+	const FIntVector2D Center(State.ChunkPosition.X, State.ChunkPosition.Y);
+
+	for (const FChunkOffsetTable::FOffset& Offset : FindOrBuildCircle(State.Viewer.LoadDistance + State.PrefetchLength))
+	{
+		if (Offset.DistanceSquared < LoadDistanceSquared)
+		{
+			continue;
+		}
+
+		const FVector2D Direction = FVector2D(Offset.Offset.X, Offset.Offset.Y) / FMath::Sqrt((float)Offset.DistanceSquared);
+		if (FVector2D::DotProduct(Direction, Heading) >= ConeCos)
+		{
+			OutColumns.Add(FIntVector2D(Center.X + Offset.Offset.X, Center.Y + Offset.Offset.Y));
+		}
+	}
+}
+
+void FTerrainInterestManager::GetGainedColumns(const FIntVector2D& NewCenter, const int32 NewRadius, const FIntVector2D* OldCenter, const int32 OldRadius, TArray<FIntVector2D>& OutColumns)
+{
+	const int32 OldRadiusSquared = FMath::Square<int32>(OldRadius);
+
+	for (const FChunkOffsetTable::FOffset& Offset : FindOrBuildCircle(NewRadius))
+	{
+		const FIntVector2D ColumnCoord(NewCenter.X + Offset.Offset.X, NewCenter.Y + Offset.Offset.Y);
+		if (OldCenter == nullptr || GetDistanceSquared(ColumnCoord, *OldCenter) >= OldRadiusSquared)
+		{
+			OutColumns.Add(ColumnCoord);
+		}
+	}
+}
+
+void FTerrainInterestManager::GetRegionColumns(const FRegion& Region, TArray<FIntVector2D>& OutColumns)
+{
+	for (int32 ColumnY = Region.MinColumn.Y; ColumnY <= Region.MaxColumn.Y; ++ColumnY)
+	{
+		for (int32 ColumnX = Region.MinColumn.X; ColumnX <= Region.MaxColumn.X; ++ColumnX)
+		{
+			OutColumns.Add(FIntVector2D(ColumnX, ColumnY));
+		}
+	}
+}
+
+void FTerrainInterestManager::AddColumns(TMap<FIntVector2D, int32>& Counts, const TArray<FIntVector2D>& Columns, TArray<FIntVector2D>* OutEnteredColumns)
+{
+	for (const FIntVector2D& ColumnCoord : Columns)
+	{
+		int32& Count = Counts.FindOrAdd(ColumnCoord);
+		if (Count++ == 0 && OutEnteredColumns != nullptr)
+		{
+			OutEnteredColumns->Add(ColumnCoord);
+		}
+	}
+}
+
+void FTerrainInterestManager::RemoveColumns(TMap<FIntVector2D, int32>& Counts, const TArray<FIntVector2D>& Columns, TArray<FIntVector2D>& OutLeftColumns)
+{
+	for (const FIntVector2D& ColumnCoord : Columns)
+	{
+		int32* const Count = Counts.Find(ColumnCoord);
+		if (Count != nullptr && --(*Count) == 0)
+		{
+			Counts.Remove(ColumnCoord);
+			OutLeftColumns.Add(ColumnCoord);
+		}
+	}
+}
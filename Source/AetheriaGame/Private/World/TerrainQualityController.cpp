@@ -0,0 +1,175 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainQualityController.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+
+	TAutoConsoleVariable<int32> CVarAdaptiveQuality(
+		TEXT("Aetheria.Quality.Adaptive"),
+		1,
+		TEXT("1 lowers the terrain's load expansion and draw distance when the frame time, chunk memory or streaming backlog is over its limit, and raises them back once it isn't."));
+
+	TAutoConsoleVariable<float> CVarTargetFrameMs(
+		TEXT("Aetheria.Quality.TargetFrameMs"),
+		33.3f,
+		TEXT("Frame time in ms over which the terrain lowers its radii."));
+
+	TAutoConsoleVariable<int32> CVarMaxChunkMB(
+		TEXT("Aetheria.Quality.MaxChunkMB"),
+		1024,
+		TEXT("Memory in MB the voxels of the loaded chunks can take before the terrain lowers its radii."));
+
+	TAutoConsoleVariable<int32> CVarMaxBacklog(
+		TEXT("Aetheria.Quality.MaxBacklog"),
+		512,
+		TEXT("Number of columns and chunks waiting to be generated, meshed or given collision over which the terrain lowers its radii."));
+
+	TAutoConsoleVariable<float> CVarHeadroom(
+		TEXT("Aetheria.Quality.Headroom"),
+		0.75f,
+		TEXT("The radii are only raised when every input is under this fraction of its limit."));
+
+	TAutoConsoleVariable<float> CVarDownSeconds(
+		TEXT("Aetheria.Quality.DownSeconds"),
+		1.0f,
+		TEXT("Seconds an input has to stay over its limit before the radii are lowered by a chunk."));
+
+	TAutoConsoleVariable<float> CVarUpSeconds(
+		TEXT("Aetheria.Quality.UpSeconds"),
+		5.0f,
+		TEXT("Seconds every input has to stay under the headroom before the radii are raised by a chunk."));
+
+	TAutoConsoleVariable<float> CVarCooldownSeconds(
+		TEXT("Aetheria.Quality.CooldownSeconds"),
+		3.0f,
+		TEXT("Seconds after a change during which the radii don't change again, while the chunks it loads or unloads settle."));
+
+	const TCHAR* GetPressureName(const ETerrainPressure Pressure)
+	{
+		switch (Pressure)
+		{
+		case ETerrainPressure::FrameTime: return TEXT("frame time");
+		case ETerrainPressure::Memory: return TEXT("memory");
+		case ETerrainPressure::Backlog: return TEXT("backlog");
+		default: return TEXT("none");
+		}
+	}
+
+}
+
+FTerrainQualityController::FTerrainQualityController()
+{
+	FMemory::Memzero(LastInputs);
+	Reset();
+}
+
+bool FTerrainQualityController::Update(const float DeltaSeconds, const FInputs& Inputs, const FBounds& InBounds)
+{
+
+	Bounds = InBounds;
+	LastInputs = Inputs;
+
+	const int32 OldLevel = Level;
+	const int32 MaxLevel = Bounds.MaxLoadExpansionReduction + Bounds.MaxDrawDistanceReduction;
+
+	if (CVarAdaptiveQuality.GetValueOnGameThread() == 0)
+	{
+		Level = 0;
+		return Level != OldLevel;
+	}
+
+	SmoothedFrameSeconds += (Inputs.FrameSeconds - SmoothedFrameSeconds) * FMath::Min(1.0f, DeltaSeconds / 0.5f);
+
+	const float TargetFrameSeconds = FMath::Max(1.0f, CVarTargetFrameMs.GetValueOnGameThread()) * 0.001f;
+	const int64 MaxChunkBytes = (int64)FMath::Max(1, CVarMaxChunkMB.GetValueOnGameThread()) * 1024 * 1024;
+	const int32 MaxBacklog = FMath::Max(1, CVarMaxBacklog.GetValueOnGameThread());
+	const float Headroom = FMath::Clamp(CVarHeadroom.GetValueOnGameThread(), 0.0f, 1.0f);
+
+	Pressure = ETerrainPressure::None;
+	if (SmoothedFrameSeconds > TargetFrameSeconds)
+	{
+		Pressure = ETerrainPressure::FrameTime;
+	}
+	else if (Inputs.ChunkBytes > MaxChunkBytes)
+	{
+		Pressure = ETerrainPressure::Memory;
+	}
+	else if (Inputs.Backlog > MaxBacklog && !bFilling)
+	{
+		Pressure = ETerrainPressure::Backlog;
+	}
+
+	const bool bHasHeadroom = SmoothedFrameSeconds < TargetFrameSeconds * Headroom && Inputs.ChunkBytes < MaxChunkBytes * Headroom && Inputs.Backlog < MaxBacklog * Headroom;
+
+	// Once the fill drained, a backlog that builds up again means the terrain can't keep up
+	if (Inputs.Backlog < MaxBacklog * Headroom)
+	{
+		bFilling = false;
+	}
+
+	// The bounds can shrink when the parameters change
+	Level = FMath::Min(Level, MaxLevel);
+
+	if (CooldownSeconds > 0.0f)
+	{
+		CooldownSeconds -= DeltaSeconds;
+		return Level != OldLevel;
+	}
+
+	PressureSeconds = Pressure != ETerrainPressure::None ? PressureSeconds + DeltaSeconds : 0.0f;
+	HeadroomSeconds = bHasHeadroom ? HeadroomSeconds + DeltaSeconds : 0.0f;
+
+	if (PressureSeconds >= CVarDownSeconds.GetValueOnGameThread() && Level < MaxLevel)
+	{
+		++Level;
+		UE_LOG(LogStats, Log, TEXT("Terrain quality lowered to level %d of %d because of the %s"), Level, MaxLevel, GetPressureName(Pressure));
+	}
+	else if (HeadroomSeconds >= CVarUpSeconds.GetValueOnGameThread() && Level > 0)
+	{
+		--Level;
+		UE_LOG(LogStats, Log, TEXT("Terrain quality raised to level %d of %d"), Level, MaxLevel);
+	}
+
+	if (Level != OldLevel)
+	{
+		PressureSeconds = 0.0f;
+		HeadroomSeconds = 0.0f;
+		CooldownSeconds = CVarCooldownSeconds.GetValueOnGameThread();
+	}
+	return Level != OldLevel;
+
+}
+
+void FTerrainQualityController::OnColumnsEntered(const int32 NumColumns)
+{
+	const int32 MaxBacklog = FMath::Max(1, CVarMaxBacklog.GetValueOnGameThread());
+	const float Headroom = FMath::Clamp(CVarHeadroom.GetValueOnGameThread(), 0.0f, 1.0f);
+	if (NumColumns >= MaxBacklog * Headroom)
+	{
+		bFilling = true;
+	}
+}
+
+void FTerrainQualityController::Log() const
+{
+	UE_LOG(LogStats, Log, TEXT("Terrain Quality: level %d of %d, -%d load expansion, -%d draw distance"), Level,
+		Bounds.MaxLoadExpansionReduction + Bounds.MaxDrawDistanceReduction, GetLoadExpansionReduction(), GetDrawDistanceReduction());
+	UE_LOG(LogStats, Log, TEXT("    %.2f ms frame time (%.2f ms smoothed), %.1f MB of chunks, %d backlog%s, pressure: %s"), LastInputs.FrameSeconds * 1000.0f,
+		SmoothedFrameSeconds * 1000.0f, LastInputs.ChunkBytes / (1024.0 * 1024.0), LastInputs.Backlog, bFilling ? TEXT(" (filling)") : TEXT(""), GetPressureName(Pressure));
+}
+
+void FTerrainQualityController::Reset()
+{
+	Level = 0;
+	Bounds.MaxLoadExpansionReduction = 0;
+	Bounds.MaxDrawDistanceReduction = 0;
+	SmoothedFrameSeconds = 0.0f;
+	PressureSeconds = 0.0f;
+	HeadroomSeconds = 0.0f;
+	CooldownSeconds = 0.0f;
+	Pressure = ETerrainPressure::None;
+	bFilling = false;
+}
@@ -1,773 +1,1963 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#include "VoxelTerrain.h"
-
-#include "TerrainGenerator.h"
-#include "TerrainGenerationThread.h"
-
-#include "ChunkCollisionComponent.h"
-#include "ChunkMeshComponent.h"
-
-#include "VoxelPlayerController.h"
-
-#include "DebugLibrary.h"
-
-#include "ScopeLock.h"
-
-#define TERRAIN_LOG 0
-
-// Sets default values
-AVoxelTerrain::AVoxelTerrain(const class FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer)
-{
-
-	PrimaryActorTick.bCanEverTick = true;
-
-	TerrainGenParameters.bUseRidgedMulti = false;
-
-	TerrainGenParameters.Seed = 123;
-	TerrainGenParameters.NoiseOctaves = 2;
-	TerrainGenParameters.NoiseFrequency = 1.0f;
-	TerrainGenParameters.NoiseLacunarity = 2.0f;
-	TerrainGenParameters.NoisePersistance = 0.5f;
-	TerrainGenParameters.NoiseScale = 0.01f;
-
-	TerrainGenParameters.bCreateTrees = true;
-	TerrainGenParameters.TreeScale = 0.1f;
-	TerrainGenParameters.TreeOctaves = 2;
-	TerrainGenParameters.TreeDensity = 0.01f;
-
-	TerrainGenParameters.SnowVoxel = 1;
-	TerrainGenParameters.GrassVoxel = 10;
-	TerrainGenParameters.bSnowOnTrees = false;
-
-	TerrainParameters.DrawDistanceInChunks = 2;
-	TerrainParameters.LoadExpansionRadius = 2;
-	TerrainParameters.CollisionDistanceInChunks = 2;
-	TerrainParameters.AOBlurRadus = 3;
-	TerrainParameters.MaxUpdateTime = 0.001f;
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(0, 0, 0), nullptr)); // Air, Material stays NULL
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(1, 142, 14), nullptr)); // Grass
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(55, 55, 55), nullptr)); // Stone
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 255, 255), nullptr)); // Snow
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(0, 0, 255), nullptr)); // Blue
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 0, 0), nullptr)); // Red
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 0, 255), nullptr)); // Magenta
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(0, 255, 255), nullptr)); // Cyan
-	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 255, 0), nullptr)); // Yellow
-
-	// TESTING
-
-#if 0
-	static FString VoxelTerrainContext("VoxelTerrainContext");
-
-	UDataTable* VoxelTypeData = ConstructorHelpers::FObjectFinder<UDataTable>(TEXT("DataTable'/Game/Data/Voxels/Voxels.Voxels'")).Object;
-	VoxelTypeData->FindRow<FVoxelTypeData>(TEXT("1"), VoxelTerrainContext);
-	VoxelTypeData->RowMap.Num();
-#endif
-
-	// END TESTING
-}
-
-void AVoxelTerrain::BeginDestroy()
-{
-	// Deletes the generation thread
-	if (TerrainGenerationThread != nullptr)
-	{
-		TerrainGenerationThread->EnsureCompletion();
-		delete TerrainGenerationThread;
-		TerrainGenerationThread = nullptr;
-		UE_LOG(LogStats, Log, TEXT("Terrain Generation Thread Destroyed!!!"));
-	}
-
-	//if (ChunkUpdaterThread != nullptr)
-	//{
-	//	ChunkUpdaterThread->EnsureCompletion();
-	//	delete ChunkUpdaterThread;
-	//	ChunkUpdaterThread = nullptr;
-	//	UE_LOG(LogStats, Log, TEXT("Chunk Updater Thread Destroyed!!!"));
-	//}
-
-	// Empties all containers
-	LoadedChunksIndex.Empty();
-	LoadedChunkMeshComponents.Empty();
-	LoadedChunkCollisionComponents.Empty();
-
-	Super::BeginDestroy();
-}
-
-void AVoxelTerrain::BeginPlay()
-{
-	Super::BeginPlay();
-
-	// Use a thread to generate the terrain
-	TerrainGenerationThread = new FTerrainGenerationThread(this);
-	UE_LOG(LogStats, Log, TEXT("Terrain Generation Thread Created!!!"));
-
-}
-
-FIntVector3 AVoxelTerrain::WorldToChunkCoord(const FIntVector3& WorldCoord)
-{
-	return FIntVector3(WorldCoord.X >> CHUNK_SHIFT, WorldCoord.Y >> CHUNK_SHIFT, WorldCoord.Z >> CHUNK_SHIFT);
-}
-
-FIntVector3 AVoxelTerrain::ChunkToWorldCoord(const FIntVector3& ChunkCoord)
-{
-	return FIntVector3(ChunkCoord.X << CHUNK_SHIFT, ChunkCoord.Y << CHUNK_SHIFT, ChunkCoord.Z << CHUNK_SHIFT);
-}
-
-
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// UPDATE METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-void AVoxelTerrain::Tick(float DeltaSeconds)
-{
-
-	Super::Tick(DeltaSeconds);
-
-
-	//time += DeltaSeconds;
-	//if (time >= 2.0f)
-	//{
-	//	time -= 2.0f;
-	//	PRINT_STRING(10, FString(TEXT("Main Thread")));
-	//}
-
-
-	//if (time < 0.5)
-	//{
-	//	time = 1;
-	//	GET_ROLE(Role, RoleString);
-	//	GET_ROLE(GetRemoteRole(), RemoteRoleString);
-	//
-	//	PRINT_STRING(1000, FString::Printf(TEXT("VoxelTerrain, Role: %s, RemoteRole: %s"), *RoleString, *RemoteRoleString));
-	//}
-
-}
-
-bool AVoxelTerrain::IsChunkPending(const FIntVector3& ChunkCoord)
-{
-	return PendingChunks.Contains(ChunkCoord);
-}
-
-void AVoxelTerrain::LoadChunk(const FIntVector3& ChunkCoord)
-{
-	if (!HasChunk(ChunkCoord) && !IsChunkPending(ChunkCoord))
-	{
-		PendingChunks.Emplace(ChunkCoord);
-		TerrainGenerationThread->QueueChunk(ChunkCoord);
-	}
-	//PRINT(*FString::Printf(TEXT("Chunk Generated: <%d, %d, %d>, Index: %d"), ChunkCoord.X, ChunkCoord.Y, ChunkCoord.Z, NewChunkIndex));
-	//UE_LOG(LogStats, Log, TEXT("G - ChunkIndex: %d, Chunk Generated: <%d, %d, %d>, IsEmpty: %d"), NewChunkIndex, ChunkCoord.X, ChunkCoord.Y, ChunkCoord.Z, IsEmpty(NewChunk));
-}
-
-void AVoxelTerrain::AddChunk(FChunk& Chunk)
-{
-
-	{
-		FScopeLock ChunkLock(&LoadedChunksMutex);
-
-		const int32 NewChunkIndex = LoadedChunks.Emplace(Chunk);
-
-		LoadedChunksIndex.Add(Chunk.ChunkPosition, NewChunkIndex);
-
-#if TERRAIN_LOG
-		GET_THIS_ROLE(ChunkRole);
-		UE_LOG(LogStats, Log, TEXT("%s - ChunkIndex: %d, Chunk Added: <%d, %d, %d>"), *ChunkRole, NewChunkIndex, Chunk.ChunkPosition.X, Chunk.ChunkPosition.Y, Chunk.ChunkPosition.Z);
-#endif
-	}
-
-	UDebugLibrary::Println(this, 10, FString::Printf(TEXT("Chunk Added %s"), *Chunk.ChunkPosition.ToString()));
-
-	UpdateChunkHeightmap(Chunk.ChunkPosition);
-
-	PendingChunks.Remove(Chunk.ChunkPosition);
-
-	//PRINT_STRING(5, FString::Printf(TEXT("%s - ChunkIndex: %d, Chunk Added: <%d, %d, %d>"), *ChunkRole, NewChunkIndex, Chunk.ChunkPosition.X, Chunk.ChunkPosition.Y, Chunk.ChunkPosition.Z));
-}
-
-void AVoxelTerrain::UpdateChunkHeightmap(const FIntVector3& ChunkCoord)
-{
-
-	TIME_START();
-
-	TArray<uint8> Voxels;
-
-	GetChunkVoxelsArray(ChunkCoord, Voxels);
-
-	if (Voxels.Num() == 0)
-	{
-		return;
-	}
-
-	TArray<int8> Heights;
-	Heights.SetNumUninitialized(1 << (2 * CHUNK_SHIFT));
-
-	// Loop through each column until a solid voxel, then set the height to that height
-	for (int32 x = 0; x < CHUNK_SIZE; ++x)
-	{
-		for (int32 y = 0; y < CHUNK_SIZE; ++y)
-		{
-			int8 z = CHUNK_SIZE - 1;
-			for (; z >= 0; --z)
-			{
-				if (Voxels[x | (y << Y_SHIFT) | (z << Z_SHIFT)] != 0)
-				{
-					break;
-				}
-			}
-			Heights[x | (y << Y_SHIFT)] = z;
-		}
-	}
-
-	FChunk& Chunk = GetChunkAt(ChunkCoord);
-
-	{
-		// Copies the generated height into the actual chunk's heightmap
-		FScopeLock ChunksLock(&LoadedChunksMutex);
-		FMemory::Memcpy(&Chunk.HighestSolidVoxels[0], &Heights[0], Heights.Num() * sizeof(int8));
-	}
-
-	TIME_END();
-
-	//PRINT_STRING(10, FLOAT_STRING(ElapsedTime));
-
-	//PRINT_STRING(10, FString::Printf(TEXT("Heighmap Updated <%d, %d>"), HeightmapCoord.X, HeightmapCoord.Y));
-
-}
-
-void AVoxelTerrain::GenerateMesh(const FIntVector3& ChunkCoord)
-{
-
-	FScopeLock MeshLock(&LoadedChunkMeshesMutex);
-	UChunkMeshComponent* const MeshComponent = LoadedChunkMeshComponents.FindRef(ChunkCoord);
-
-	if (MeshComponent == nullptr) // Make a new mesh component if it's generated
-	{
-		UChunkMeshComponent* NewMesh = NewObject<UChunkMeshComponent>(this);
-
-		NewMesh->VoxelTerrain = this;
-		NewMesh->ChunkCoord = ChunkCoord;
-		NewMesh->HasLowPriorityUpdatePending = false;
-
-		NewMesh->SetRelativeLocation(ChunkToWorldCoord(ChunkCoord).ToFloat());
-		NewMesh->AttachToComponent(RootComponent, FAttachmentTransformRules(EAttachmentRule::KeepRelative, false));
-		NewMesh->RegisterComponent();
-
-		// Add to the TMap that stores all the meshes
-		LoadedChunkMeshComponents.Add(ChunkCoord, NewMesh);
-
-#if TERRAIN_LOG
-		UE_LOG(LogStats, Log, TEXT("<%d, %d, %d> Chunk Mesh Component Added to List"), ChunkCoord.X, ChunkCoord.Y, ChunkCoord.Z);
-#endif
-	}
-	else if (MeshComponent->HasLowPriorityUpdatePending) // if it has a low priority update pending (meaning either far away or AO
-	{
-		MeshComponent->MarkRenderStateDirty();
-		MeshComponent->HasLowPriorityUpdatePending = false;
-	}
-
-}
-
-void AVoxelTerrain::GenerateCollision(const FIntVector3& ChunkCoord)
-{
-	FScopeLock CollisionLock(&LoadedChunkCollisionsMutex);
-
-	const UChunkCollisionComponent* const CollisionComponent = LoadedChunkCollisionComponents.FindRef(ChunkCoord);
-
-	if (CollisionComponent == nullptr) // Generate a collision mesh if it doesn't exist
-	{
-		UChunkCollisionComponent* NewCollision = NewObject<UChunkCollisionComponent>(this);
-		NewCollision->VoxelTerrain = this;
-		NewCollision->ChunkCoord = ChunkCoord;
-
-		NewCollision->SetRelativeLocation(ChunkToWorldCoord(ChunkCoord).ToFloat());
-		NewCollision->AttachToComponent(RootComponent, FAttachmentTransformRules(EAttachmentRule::KeepRelative, false));
-		NewCollision->RegisterComponent();
-
-		LoadedChunkCollisionComponents.Add(ChunkCoord, NewCollision);
-
-		UDebugLibrary::Println(this, 10, ChunkCoord.ToString());
-	}
-}
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// VOXEL/CHUNK METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-FVoxelType AVoxelTerrain::GetVoxelType(const uint8& Voxel) const
-{
-	checkf(Voxel < TerrainParameters.VoxelTypes.Num(), TEXT("There are NO Voxel Type (%d)!!!! There are only (%d) Voxel Types!!!"), Voxel, TerrainParameters.VoxelTypes.Num());
-	return TerrainParameters.VoxelTypes[(int32)Voxel];
-}
-
-int32 AVoxelTerrain::GetNumVoxelTypes() const
-{
-	return TerrainParameters.VoxelTypes.Num();
-}
-
-uint8 AVoxelTerrain::GetVoxelAt(const int32& x, const int32& y, const int32& z)
-{
-
-	// Convert from global to local voxel coordinate
-	const FIntVector3 ChunkCoord(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
-	const int32& LocalX = x & CHUNK_SIZE_MASK;
-	const int32& LocalY = y & CHUNK_SIZE_MASK;
-	const int32& LocalZ = z & CHUNK_SIZE_MASK;
-
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-
-	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-	if (ChunkIndex != nullptr)
-	{
-		const FChunk& Chunk = LoadedChunks[*ChunkIndex];
-		return Chunk.Voxels[LocalX | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT)];
-	}
-	else // Return 0 (Air) if the chunk is not loaded
-	{
-		return (uint8)0;
-	}
-
-}
-
-void AVoxelTerrain::SetVoxelAt(const int32& x, const int32& y, const int32& z, uint8 Voxel)
-{
-
-	// Convert from global to local voxel coordinate
-	const FIntVector3 ChunkCoord(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
-	const int32& LocalX = x & CHUNK_SIZE_MASK;
-	const int32& LocalY = y & CHUNK_SIZE_MASK;
-	const int32& LocalZ = z & CHUNK_SIZE_MASK;
-
-	// Only mark chunk for re-mesh if something was changed
-	bool bIsVoxelSet = false;
-
-	{
-		// Lock the container
-		FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-		if (ChunkIndex != nullptr) // only set voxel if the chunk is loaded
-		{
-			FChunk& Chunk = LoadedChunks[*ChunkIndex];
-			Chunk.Voxels[LocalX | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT)] = Voxel;
-			bIsVoxelSet = true;
-		}
-	}
-
-	if (bIsVoxelSet)
-	{
-		MarkVoxelDirty(FIntVector3(x, y, z));
-	}
-
-
-}
-
-void AVoxelTerrain::MarkVoxelAreaDirty(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord)
-{
-	// TODO: Implement
-	// Just add blur radius to all sides and modulo each one to get chunk coordinate and update
-}
-
-void AVoxelTerrain::MarkVoxelDirty(const FIntVector3& VoxelCoord)
-{
-	const FIntVector3 ChunkCoord = WorldToChunkCoord(VoxelCoord);
-
-	const int32& LocalX = VoxelCoord.X & CHUNK_SIZE_MASK;
-	const int32& LocalY = VoxelCoord.Y & CHUNK_SIZE_MASK;
-	const int32& LocalZ = VoxelCoord.Z & CHUNK_SIZE_MASK;
-
-	// Already lockes so we dont want to lock it again.
-	UpdateChunkHeightmap(ChunkCoord);
-
-	FScopeLock LoadedCollisionLock(&LoadedChunkCollisionsMutex);
-	FScopeLock LoadedMeshLock(&LoadedChunkMeshesMutex);
-
-	// Check all neighbor chunks and if the voxel is close enough to the edge for them to be remeshed
-	TArray<bool> ShouldNeighborChunkUpdate;
-	ShouldNeighborChunkUpdate.SetNumUninitialized(9);
-	ShouldNeighborChunkUpdate[4] = true;
-	ShouldNeighborChunkUpdate[3] = LocalX - TerrainParameters.AOBlurRadus < 0;
-	ShouldNeighborChunkUpdate[5] = LocalX + TerrainParameters.AOBlurRadus >= CHUNK_SIZE;
-	ShouldNeighborChunkUpdate[1] = LocalY - TerrainParameters.AOBlurRadus < 0;
-	ShouldNeighborChunkUpdate[7] = LocalY + TerrainParameters.AOBlurRadus >= CHUNK_SIZE;
-	ShouldNeighborChunkUpdate[0] = ShouldNeighborChunkUpdate[3] && ShouldNeighborChunkUpdate[1];
-	ShouldNeighborChunkUpdate[2] = ShouldNeighborChunkUpdate[5] && ShouldNeighborChunkUpdate[1];
-	ShouldNeighborChunkUpdate[6] = ShouldNeighborChunkUpdate[3] && ShouldNeighborChunkUpdate[7];
-	ShouldNeighborChunkUpdate[8] = ShouldNeighborChunkUpdate[5] && ShouldNeighborChunkUpdate[7];
-
-	// Moore's neighbor
-	for (int32 i = 0; i < 9; ++i)
-	{
-		if (!ShouldNeighborChunkUpdate[i])
-		{
-			continue;
-		}
-
-		const int32 ChunkX = ChunkCoord.X + (i % 3 - 1);
-		const int32 ChunkY = ChunkCoord.Y + (i / 3 - 1);
-
-		// Update the meshes for all chunks in this column because ambient occlusion
-		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= 0; --ChunkZ)
-		{
-			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
-			UChunkMeshComponent* const ChunkMesh = LoadedChunkMeshComponents.FindRef(CurrentChunkCoord);
-			if (ChunkMesh != nullptr)
-			{
-				// TODO: Only do this for adjacent chunks, otherwise use MarkRenderStateDirty
-				ChunkMesh->HasLowPriorityUpdatePending = true;
-			}
-		}
-
-		// Same for collision
-		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= FMath::Max(0, ChunkCoord.Z - 1); --ChunkZ)
-		{
-			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
-			UChunkCollisionComponent* const ChunkCollision = LoadedChunkCollisionComponents.FindRef(CurrentChunkCoord);
-			if (ChunkCollision != nullptr)
-			{
-				ChunkCollision->MarkRenderStateDirty();
-			}
-		}
-
-	}
-
-
-}
-
-void AVoxelTerrain::MarkChunkDirty(const FIntVector3& ChunkCoord)
-{
-
-	// Already lockes so we dont want to lock it again.
-	UpdateChunkHeightmap(ChunkCoord);
-
-	FScopeLock LoadedCollisionLock(&LoadedChunkCollisionsMutex);
-	FScopeLock LoadedMeshLock(&LoadedChunkMeshesMutex);
-
-	// Moore's neighbor
-	for (int32 i = 0; i < 9; ++i)
-	{
-		const int32 ChunkX = ChunkCoord.X + (i % 3 - 1);
-		const int32 ChunkY = ChunkCoord.Y + (i / 3 - 1);
-
-		// Update the meshes for all chunks in this column because ambient occlusion
-		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= 0; --ChunkZ)
-		{
-			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
-			UChunkMeshComponent* const ChunkMesh = LoadedChunkMeshComponents.FindRef(CurrentChunkCoord);
-			if (ChunkMesh != nullptr)
-			{
-				// TODO: Only do this for adjacent chunks,otherwise use MarkRenderStateDirty
-				ChunkMesh->HasLowPriorityUpdatePending = true;
-			}
-		}
-
-		// Same for collision
-		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= FMath::Max(0, ChunkCoord.Z - 1); --ChunkZ)
-		{
-			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
-			UChunkCollisionComponent* const ChunkCollision = LoadedChunkCollisionComponents.FindRef(CurrentChunkCoord);
-			
-			if (ChunkCollision != nullptr)
-			{
-				ChunkCollision->MarkRenderStateDirty();
-			}
-
-		}
-
-	}
-}
-
-void AVoxelTerrain::GetChunkVoxelsArray(const FIntVector3& ChunkCoord, TArray<uint8>& OutVoxelsArray)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-	if (ChunkIndex != nullptr)
-	{
-		// Gets the chunk array
-		const FChunk& Chunk = LoadedChunks[*ChunkIndex];
-		OutVoxelsArray.SetNumUninitialized(Chunk.Voxels.Num());
-		FMemory::Memcpy(&OutVoxelsArray[0], &Chunk.Voxels[0], Chunk.Voxels.Num() * sizeof(uint8));
-	}
-}
-
-void AVoxelTerrain::GetVoxelsArray(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord, TArray<uint8>& OutVoxelsArray)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-
-	// Voxel to chunk coord
-	const FIntVector3& MinChunkCoord = WorldToChunkCoord(MinVoxelCoord);
-	const FIntVector3& MaxChunkCoord = WorldToChunkCoord(MaxVoxelCoord);
-	const FIntVector3& OutputDimensions = MaxVoxelCoord + FIntVector3(1) - MinVoxelCoord;
-
-	OutVoxelsArray.SetNumUninitialized(OutputDimensions.X * OutputDimensions.Y * OutputDimensions.Z);
-
-	// Loops through all chunks in between min and max
-	for (int32 ChunkZ = MinChunkCoord.Z; ChunkZ <= MaxChunkCoord.Z; ++ChunkZ)
-	{
-		for (int32 ChunkY = MinChunkCoord.Y; ChunkY <= MaxChunkCoord.Y; ++ChunkY)
-		{
-			for (int32 ChunkX = MinChunkCoord.X; ChunkX <= MaxChunkCoord.X; ++ChunkX)
-			{
-				const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
-				const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-				const FIntVector3 ChunkVoxelCoord(ChunkX << CHUNK_SHIFT, ChunkY << CHUNK_SHIFT, ChunkZ << CHUNK_SHIFT);
-
-				// The min and max coord may be only part of the chunk, and we don't want index out of bound
-				const FIntVector3 MinVoxelCoordInChunk = FIntVector3::Max(FIntVector3(0), MinVoxelCoord - ChunkVoxelCoord); // Inclusive
-				const FIntVector3 MaxVoxelCoordInChunk = FIntVector3::Min(FIntVector3(CHUNK_SIZE - 1), MaxVoxelCoord - ChunkVoxelCoord); // Inclusive
-
-				for (int32 LocalZ = MinVoxelCoordInChunk.Z; LocalZ <= MaxVoxelCoordInChunk.Z; ++LocalZ)
-				{
-					for (int32 LocalY = MinVoxelCoordInChunk.Y; LocalY <= MaxVoxelCoordInChunk.Y; ++LocalY)
-					{
-						const int32 OutputSizeX = MaxVoxelCoordInChunk.X - MinVoxelCoordInChunk.X + 1; // Num to copy from original array in the x axis
-						const int32 LocalXStart = MinVoxelCoordInChunk.X; // Start copy from where in the original array? 
-
-						const int32 LocalVoxelStartIndex = LocalXStart | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT);
-
-						const int32 OutputX = ChunkVoxelCoord.X + LocalXStart - MinVoxelCoord.X; // Location in output array
-						const int32 OutputY = ChunkVoxelCoord.Y + LocalY - MinVoxelCoord.Y; // Location in output array
-						const int32 OutputZ = ChunkVoxelCoord.Z + LocalZ - MinVoxelCoord.Z; // Location in output array
-
-						const int32 OutputIndex = OutputX + OutputY * OutputDimensions.X + OutputZ * OutputDimensions.X * OutputDimensions.Y;
-
-						if (ChunkIndex != nullptr)
-						{
-							FMemory::Memcpy(&OutVoxelsArray[OutputIndex], &LoadedChunks[*ChunkIndex].Voxels[LocalVoxelStartIndex], OutputSizeX * sizeof(uint8));
-						}
-						else
-						{
-							FMemory::Memset(&OutVoxelsArray[OutputIndex], 0, OutputSizeX * sizeof(uint8));
-						}
-					}
-				}
-
-			}
-		}
-	}
-
-}
-
-bool AVoxelTerrain::HasChunk(const FIntVector3& ChunkCoord)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-	return ChunkIndex != nullptr;
-}
-
-bool AVoxelTerrain::HasAllNeighborChunks(const FIntVector3& ChunkCoord)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-
-	// Moore's neighbor
-	for (int32 i = 0; i < 9; ++i)
-	{
-		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord + FIntVector3(i % 3 - 1, i / 3 - 1, 0));
-		if (ChunkIndex == nullptr)
-		{
-			return false;
-		}
-	}
-	return true;
-}
-
-FChunk& AVoxelTerrain::GetChunkAt(const FIntVector3& ChunkCoord)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-
-	checkf(ChunkIndex != nullptr, TEXT("FChunk& AVoxelTerrain::GetChunkAt(const FIntVector3&) -> Chunk <%s> is not loaded!!!!"), *ChunkCoord.ToString());
-
-	return LoadedChunks[*ChunkIndex];
-}
-
-FChunk& AVoxelTerrain::GetChunkAndIndexAt(const FIntVector3& ChunkCoord, int32& OutChunkIndex)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-
-	checkf(ChunkIndex != nullptr, TEXT("FChunk& AVoxelTerrain::GetChunkAndIndexAt(const FIntVector3&, int32&) -> Chunk <%s> is not loaded!!!!"), *ChunkCoord.ToString());
-
-	OutChunkIndex = *ChunkIndex;
-	return LoadedChunks[*ChunkIndex];
-}
-
-int32 AVoxelTerrain::GetChunkIndexAt(const FIntVector3& ChunkCoord)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-
-	checkf(ChunkIndex != nullptr, TEXT("int32 AVoxelTerrain::GetChunkIndexAt(const FIntVector3&) -> Chunk <%s> is not loaded!!!!"), *ChunkCoord.ToString());
-
-	return *ChunkIndex;
-}
-
-bool AVoxelTerrain::HasChunkColumn(const FIntVector2D& ChunkColumnCoord)
-{
-	// The Scope Lock is in HasChunk(), so we don't lock it here to prevent a dead lock
-	for (int32 i = 0; i < WORLD_HEIGHT_CHUNKS; ++i)
-	{
-		if (!HasChunk(FIntVector3(ChunkColumnCoord.X, ChunkColumnCoord.Y, i)))
-		{
-			return false;
-		}
-	}
-	return true;
-}
-
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// CHUNK MESH METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-/** Returns whether the mesh for the chunks at ChunkCoord is loaded. */
-bool AVoxelTerrain::HasChunkMesh(const FIntVector3& ChunkCoord)
-{
-	FScopeLock MeshLock(&LoadedChunkMeshesMutex);
-	const UChunkMeshComponent* const Mesh = LoadedChunkMeshComponents.FindRef(ChunkCoord);
-	return Mesh != nullptr;
-}
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// CHUNK COLLISION METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-bool AVoxelTerrain::HasChunkCollision(const FIntVector3& ChunkCoord)
-{
-	FScopeLock CollisionLock(&LoadedChunkCollisionsMutex);
-	const UChunkCollisionComponent* const Collision = LoadedChunkCollisionComponents.FindRef(ChunkCoord);
-	return Collision != nullptr;
-}
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// HEIGHTMAP METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-int32 AVoxelTerrain::GetHeightAt(const int32& x, const int32& y)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-
-	const int32 ChunkX = x >> CHUNK_SHIFT;
-	const int32 ChunkY = y >> CHUNK_SHIFT;
-
-	const int32 LocalX = x & CHUNK_SIZE_MASK;
-	const int32 LocalY = y & CHUNK_SIZE_MASK;
-
-	int32 Height = -1;
-
-	// We have to loop through the whole column and add the height values together
-	for (int32 ChunkZ = WORLD_HEIGHT_CHUNKS - 1; ChunkZ >= 0; --ChunkZ)
-	{
-		const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
-		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-
-		if (ChunkIndex != nullptr)
-		{
-			const int32& LocalHeight = LoadedChunks[*ChunkIndex].HighestSolidVoxels[LocalX | (LocalY << Y_SHIFT)];
-			if (LocalHeight >= 0)
-			{
-				const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
-				Height = ChunkVoxelZ + LocalHeight;
-				break;
-			}
-		}
-	}
-
-	return Height;
-}
-
-void AVoxelTerrain::GetChunkHeightsArray(const FIntVector2D& HeightmapCoord, TArray<int32>& OutHeightsArray)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-
-	OutHeightsArray.Init(-1, 1 << (2 * CHUNK_SHIFT));
-
-	const int32& ChunkX = HeightmapCoord.X;
-	const int32& ChunkY = HeightmapCoord.Y;
-
-	// Loops through the chunks and add the heights together
-	for (int32 ChunkZ = WORLD_HEIGHT_CHUNKS - 1; ChunkZ >= 0; --ChunkZ)
-	{
-		const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
-		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-
-		if (ChunkIndex != nullptr)
-		{
-			for (int32 LocalY = 0; LocalY < CHUNK_SIZE; ++LocalY) // For each height in this chunk
-			{
-				for (int32 LocalX = 0; LocalX < CHUNK_SIZE; ++LocalX) // For each height in this chunk
-				{
-					const int32 HeightIndex = LocalX | (LocalY << Y_SHIFT);
-					const int32& LocalHeight = LoadedChunks[*ChunkIndex].HighestSolidVoxels[HeightIndex]; // Height of this current voxel in chunk
-					const int32& OutputHeight = OutHeightsArray[HeightIndex]; // Current height stored in Output Array
-
-																			  // If the this height is larger than zero AND the output height does not already have a value
-					if (LocalHeight >= 0 && OutputHeight < 0)
-					{
-						const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
-						OutHeightsArray[HeightIndex] = ChunkVoxelZ + LocalHeight;
-					}
-				}
-			}
-		}
-	}
-}
-
-void AVoxelTerrain::GetHeightsArray(const FIntVector2D& MinHeightCoord, const FIntVector2D& MaxHeightCoord, TArray<int32>& OutHeightsArray)
-{
-	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
-
-	const FIntVector2D& MinHeightmapCoord = MinHeightCoord >> CHUNK_SHIFT;
-	const FIntVector2D& MaxHeightmapCoord = MaxHeightCoord >> CHUNK_SHIFT;
-	const FIntVector2D& OutputDimensions = MaxHeightCoord + FIntVector2D(1) - MinHeightCoord;
-
-	OutHeightsArray.Init(-1, OutputDimensions.X * OutputDimensions.Y);
-
-	// Loops through all possible chunk <x, y> coordinate
-	for (int32 ChunkY = MinHeightmapCoord.Y; ChunkY <= MaxHeightmapCoord.Y; ++ChunkY)
-	{
-		for (int32 ChunkX = MinHeightmapCoord.X; ChunkX <= MaxHeightmapCoord.X; ++ChunkX)
-		{
-			const FIntVector2D HeightmapVoxelCoord(ChunkX << CHUNK_SHIFT, ChunkY << CHUNK_SHIFT);
-
-			// The min and max coord may be only part of the chunk, and we don't want index out of bound
-			const FIntVector2D MinVoxelCoordInChunk = FIntVector2D::Max(FIntVector2D(0), MinHeightCoord - HeightmapVoxelCoord); // Inclusive
-			const FIntVector2D MaxVoxelCoordInChunk = FIntVector2D::Min(FIntVector2D(CHUNK_SIZE - 1), MaxHeightCoord - HeightmapVoxelCoord); // Inclusive
-
-																																			 // Add the heights together
-			for (int32 ChunkZ = WORLD_HEIGHT_CHUNKS - 1; ChunkZ >= 0; --ChunkZ)
-			{
-				const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
-				const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
-
-				if (ChunkIndex != nullptr)
-				{
-					for (int32 LocalY = MinVoxelCoordInChunk.Y; LocalY <= MaxVoxelCoordInChunk.Y; ++LocalY) // For each height in this chunk
-					{
-						for (int32 LocalX = MinVoxelCoordInChunk.X; LocalX <= MaxVoxelCoordInChunk.X; ++LocalX) // For each height in this chunk
-						{
-							const int32 LocalHeightIndex = LocalX | (LocalY << Y_SHIFT);
-							const int32& LocalHeight = LoadedChunks[*ChunkIndex].HighestSolidVoxels[LocalHeightIndex]; // Height of this current voxel in chunk
-
-							const int32 OutputX = HeightmapVoxelCoord.X + LocalX - MinHeightCoord.X; // Location in output array
-							const int32 OutputY = HeightmapVoxelCoord.Y + LocalY - MinHeightCoord.Y; // Location in output array
-							const int32 OutputIndex = OutputX + OutputY * OutputDimensions.X;
-							const int32& OutputHeight = OutHeightsArray[OutputIndex]; // Current height stored in Output Array
-																					  // If the this height is larger than zero AND the output height does not already have a value
-							if (LocalHeight >= 0 && OutputHeight < 0)
-							{
-								const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
-								OutHeightsArray[OutputIndex] = ChunkVoxelZ + LocalHeight;
-							}
-						}
-					}
-				}
-
-			}
-
-		}
-	}
-
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "VoxelTerrain.h"
+
+#include "TerrainGenerator.h"
+#include "TerrainGenerationThread.h"
+#include "TerrainGenerationQueue.h"
+#include "TerrainCompletionQueue.h"
+#include "TerrainGeneratorStats.h"
+#include "StructureRegistry.h"
+#include "NoiseTileCache.h"
+
+#include "ChunkCollisionComponent.h"
+#include "ChunkMeshComponent.h"
+
+#include "VoxelPlayerController.h"
+
+#include "DebugLibrary.h"
+
+#include "ScopeLock.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#define TERRAIN_LOG 0
+
+namespace
+{
+
+	TAutoConsoleVariable<int32> CVarRequestsPerTick(
+		TEXT("Aetheria.Streaming.RequestsPerTick"),
+		32,
+		TEXT("Number of chunk columns the terrain requests every tick, nearest to a viewer first. Columns that are already requested or loaded don't count."));
+
+	TAutoConsoleVariable<float> CVarOutOfViewDistanceScale(
+		TEXT("Aetheria.Streaming.OutOfViewDistanceScale"),
+		4.0f,
+		TEXT("The squared distance of the columns outside a viewer's field of view is multiplied by this when ordering requests. 4 requests them as if they were twice as far."));
+
+	TAutoConsoleVariable<int32> CVarMissingChunkStats(
+		TEXT("Aetheria.Streaming.MissingChunkStats"),
+		0,
+		TEXT("1 counts the chunks in the draw distance of the viewers that have no mesh yet every tick, and logs their average every second."));
+
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+
+	void LogTerrainFrameBudget(const TArray<FString>& Args, UWorld* World)
+	{
+		for (TActorIterator<AVoxelTerrain> It(World); It; ++It)
+		{
+			It->GetFrameBudget().Log();
+
+			if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+			{
+				It->GetFrameBudget().Reset();
+			}
+		}
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs LogTerrainFrameBudgetCommand(
+		TEXT("Aetheria.Terrain.FrameBudget"),
+		TEXT("Logs the time every kind of terrain work used per frame against its share of MaxUpdateTime. Usage: Aetheria.Terrain.FrameBudget [Reset]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&LogTerrainFrameBudget));
+
+	void LogMissingChunkStats(const TArray<FString>& Args, UWorld* World)
+	{
+		for (TActorIterator<AVoxelTerrain> It(World); It; ++It)
+		{
+			It->LogMissingChunkStats(Args.Num() > 0 && Args[0] == TEXT("Reset"));
+		}
+	}
+
+	void LogTerrainQuality(const TArray<FString>& Args, UWorld* World)
+	{
+		for (TActorIterator<AVoxelTerrain> It(World); It; ++It)
+		{
+			It->GetQuality().Log();
+
+			if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+			{
+				It->GetQuality().Reset();
+			}
+		}
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs LogTerrainQualityCommand(
+		TEXT("Aetheria.Terrain.Quality"),
+		TEXT("Logs how far the load expansion and draw distance are lowered and what the quality controller last saw. Reset goes back to full quality. Usage: Aetheria.Terrain.Quality [Reset]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&LogTerrainQuality));
+
+	FAutoConsoleCommandWithWorldAndArgs LogMissingChunkStatsCommand(
+		TEXT("Aetheria.Streaming.MissingChunks"),
+		TEXT("Logs how many chunks in the draw distance of the viewers had no mesh, on average and at most, since Aetheria.Streaming.MissingChunkStats was turned on. Usage: Aetheria.Streaming.MissingChunks [Reset]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&LogMissingChunkStats));
+
+}
+
+#endif
+
+// Sets default values
+AVoxelTerrain::AVoxelTerrain(const class FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+
+	PrimaryActorTick.bCanEverTick = true;
+
+	FMemory::Memzero(MissingChunkStats);
+	NextRegionId = 0;
+	SpawnRegion.RegionId = INDEX_NONE;
+	BeginPlaySeconds = 0.0;
+	TimeToPlayable = -1.0;
+
+	TerrainGenParameters.bUseRidgedMulti = false;
+
+	TerrainGenParameters.Seed = 123;
+	TerrainGenParameters.NoiseOctaves = 2;
+	TerrainGenParameters.NoiseFrequency = 1.0f;
+	TerrainGenParameters.NoiseLacunarity = 2.0f;
+	TerrainGenParameters.NoisePersistance = 0.5f;
+	TerrainGenParameters.NoiseScale = 0.01f;
+	TerrainGenParameters.DensitySampleSpacing = FIntVector3(1, 1, 1);
+
+	TerrainGenParameters.bCreateTrees = true;
+	TerrainGenParameters.TreeScale = 0.1f;
+	TerrainGenParameters.TreeOctaves = 2;
+	TerrainGenParameters.TreeDensity = 0.01f;
+
+	// Off so existing worlds and seeds keep generating the same terrain
+	TerrainGenParameters.bCreateCaves = false;
+	TerrainGenParameters.CaveScale = 0.04f;
+	TerrainGenParameters.CaveOctaves = 2;
+	TerrainGenParameters.CavePersistence = 0.5f;
+	TerrainGenParameters.CaveThreshold = 0.45f;
+	TerrainGenParameters.CaveMinHeight = 1;
+	TerrainGenParameters.CaveFadeHeight = 40;
+	TerrainGenParameters.CaveMaxHeight = 72;
+
+	TerrainGenParameters.SnowVoxel = 1;
+	TerrainGenParameters.GrassVoxel = 10;
+	TerrainGenParameters.bSnowOnTrees = false;
+
+	TerrainGenParameters.HeightmapRawWidth = 0;
+	TerrainGenParameters.HeightmapRawHeight = 0;
+	TerrainGenParameters.HeightmapOrigin = FIntVector2D(0, 0);
+	TerrainGenParameters.HeightmapMinHeight = 1;
+	TerrainGenParameters.HeightmapMaxHeight = WORLD_HEIGHT - 16;
+	TerrainGenParameters.HeightmapGrassDepth = 3;
+
+	TerrainParameters.DrawDistanceInChunks = 2;
+	TerrainParameters.LoadExpansionRadius = 2;
+	TerrainParameters.MinDrawDistanceInChunks = 1;
+	TerrainParameters.CollisionDistanceInChunks = 2;
+	TerrainParameters.AOBlurRadus = 3;
+	TerrainParameters.NumGenerationThreads = 0;
+	TerrainParameters.MaxUpdateTime = 0.001f;
+	TerrainParameters.SpawnRadiusInChunks = 1;
+	TerrainParameters.bCacheSpawnArea = false;
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(0, 0, 0), nullptr)); // Air, Material stays NULL
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(1, 142, 14), nullptr)); // Grass
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(55, 55, 55), nullptr)); // Stone
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 255, 255), nullptr)); // Snow
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(0, 0, 255), nullptr)); // Blue
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 0, 0), nullptr)); // Red
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 0, 255), nullptr)); // Magenta
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(0, 255, 255), nullptr)); // Cyan
+	TerrainParameters.VoxelTypes.Add(FVoxelType(FColor(255, 255, 0), nullptr)); // Yellow
+
+	// TESTING
+
+#if 0
+	static FString VoxelTerrainContext("VoxelTerrainContext");
+
+	UDataTable* VoxelTypeData = ConstructorHelpers::FObjectFinder<UDataTable>(TEXT("DataTable'/Game/Data/Voxels/Voxels.Voxels'")).Object;
+	VoxelTypeData->FindRow<FVoxelTypeData>(TEXT("1"), VoxelTerrainContext);
+	VoxelTypeData->RowMap.Num();
+#endif
+
+	// END TESTING
+}
+
+void AVoxelTerrain::BeginDestroy()
+{
+	// Deletes the generation threads, the queue has to be shut down first to wake up the waiting threads
+	if (GenerationQueue != nullptr)
+	{
+		GenerationQueue->Shutdown();
+
+		for (FTerrainGenerationThread* GenerationThread : GenerationThreads)
+		{
+			GenerationThread->EnsureCompletion();
+			delete GenerationThread;
+		}
+		GenerationThreads.Empty();
+
+		delete GenerationQueue;
+		GenerationQueue = nullptr;
+
+		// Frees the columns that were generated but never added
+		delete CompletionQueue;
+		CompletionQueue = nullptr;
+		UE_LOG(LogStats, Log, TEXT("Terrain Generation Threads Destroyed!!!"));
+	}
+
+	// Only after the threads are gone, they use it while generating
+	if (StructureRegistry != nullptr)
+	{
+		delete StructureRegistry;
+		StructureRegistry = nullptr;
+	}
+
+	//if (ChunkUpdaterThread != nullptr)
+	//{
+	//	ChunkUpdaterThread->EnsureCompletion();
+	//	delete ChunkUpdaterThread;
+	//	ChunkUpdaterThread = nullptr;
+	//	UE_LOG(LogStats, Log, TEXT("Chunk Updater Thread Destroyed!!!"));
+	//}
+
+	// Empties all containers
+	LoadedChunksIndex.Empty();
+	LoadedChunkMeshComponents.Empty();
+	LoadedChunkCollisionComponents.Empty();
+	ChunkLifecycle.Empty();
+	// Nobody can wait on a region of a terrain that is gone
+	for (TPair<int32, FRegionRequest>& Pair : RegionRequests)
+	{
+		if (!Pair.Value.bReady)
+		{
+			Pair.Value.Promise->SetValue(false);
+		}
+	}
+	RegionRequests.Empty();
+
+	Interest.Empty();
+	ViewerAnchors.Empty();
+	PendingRequests.Empty();
+	DirtyChunkMeshes.Empty();
+	PendingMeshes.Empty();
+	PendingCollisions.Empty();
+	PendingUnloads.Empty();
+	UnloadingColumns.Empty();
+
+	Super::BeginDestroy();
+}
+
+void AVoxelTerrain::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BeginPlaySeconds = FPlatformTime::Seconds();
+	TimeToPlayable = -1.0;
+
+	// The biome graph is compiled once, before any generation thread can read it
+	TerrainGenParameters.BiomeProgram.Reset();
+	if (TerrainGenParameters.BiomeGraph.Biomes.Num() > 0)
+	{
+		FString Error;
+		TerrainGenParameters.BiomeProgram = FBiomeProgram::Compile(TerrainGenParameters.BiomeGraph, TerrainGenParameters.Seed, Error);
+		if (!TerrainGenParameters.BiomeProgram.IsValid())
+		{
+			UE_LOG(LogStats, Warning, TEXT("Invalid biome graph, using the built-in terrain: %s"), *Error);
+		}
+	}
+
+	// The heightmap is only opened here, its tiles are read by the generation threads as they need them
+	TerrainGenParameters.HeightmapSource.Reset();
+	if (!TerrainGenParameters.HeightmapFile.IsEmpty())
+	{
+		FString Error;
+		TerrainGenParameters.HeightmapSource = FHeightmapSource::Open(TerrainGenParameters.HeightmapFile, TerrainGenParameters.HeightmapRawWidth, TerrainGenParameters.HeightmapRawHeight, Error);
+		if (!TerrainGenParameters.HeightmapSource.IsValid())
+		{
+			UE_LOG(LogStats, Warning, TEXT("Invalid heightmap, using the noise terrain: %s"), *Error);
+		}
+	}
+
+	// Use a pool of threads to generate the terrain
+	int32 NumGenerationThreads = TerrainParameters.NumGenerationThreads;
+	if (NumGenerationThreads <= 0)
+	{
+		// Leave a core for the game thread and one for the render thread
+		NumGenerationThreads = FPlatformMisc::NumberOfCores() - 2;
+	}
+	NumGenerationThreads = FMath::Max(1, NumGenerationThreads);
+
+	StructureRegistry = new FStructureRegistry();
+
+	GenerationQueue = new FTerrainGenerationQueue();
+	CompletionQueue = new FTerrainCompletionQueue();
+	for (int32 i = 0; i < NumGenerationThreads; ++i)
+	{
+		GenerationThreads.Add(new FTerrainGenerationThread(this, GenerationQueue, CompletionQueue, i));
+	}
+	UE_LOG(LogStats, Log, TEXT("%d Terrain Generation Threads Created!!!"), NumGenerationThreads);
+
+	// The area the first player spawns in is requested before anything else, and is held until it can be stood on
+	if (TerrainParameters.SpawnRadiusInChunks > 0)
+	{
+		const FVector SpawnLocation = FindSpawnLocation();
+		const float SpawnExtent = TerrainParameters.SpawnRadiusInChunks * CHUNK_SIZE * 100.0f;
+		const FBox SpawnBounds(FVector(SpawnLocation.X - SpawnExtent, SpawnLocation.Y - SpawnExtent, 0.0f), FVector(SpawnLocation.X + SpawnExtent, SpawnLocation.Y + SpawnExtent, WORLD_HEIGHT * 100.0f - 1.0f));
+		SpawnRegion = RequestRegion(SpawnBounds, ETerrainRegionStage::Collision);
+		WarmStartRegion(RegionRequests[SpawnRegion.RegionId]);
+	}
+
+}
+
+FIntVector3 AVoxelTerrain::WorldToChunkCoord(const FIntVector3& WorldCoord)
+{
+	return FIntVector3(WorldCoord.X >> CHUNK_SHIFT, WorldCoord.Y >> CHUNK_SHIFT, WorldCoord.Z >> CHUNK_SHIFT);
+}
+
+FIntVector3 AVoxelTerrain::ChunkToWorldCoord(const FIntVector3& ChunkCoord)
+{
+	return FIntVector3(ChunkCoord.X << CHUNK_SHIFT, ChunkCoord.Y << CHUNK_SHIFT, ChunkCoord.Z << CHUNK_SHIFT);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// UPDATE METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AVoxelTerrain::Tick(float DeltaSeconds)
+{
+
+	Super::Tick(DeltaSeconds);
+
+	FrameBudget.BeginFrame(TerrainParameters.MaxUpdateTime);
+
+	const bool bQualityChanged = UpdateQuality();
+
+	// Generate the columns closest to the viewers first, and release the columns they left behind
+	TArray<FTerrainViewer> Viewers;
+	GatherViewers(Viewers);
+
+	FTerrainInterestManager::FChanges Changes;
+	Interest.SetViewers(Viewers, Changes);
+	// The first load, a teleport or a bigger draw distance fills the backlog without the game falling behind
+	if (!bQualityChanged)
+	{
+		Quality.OnColumnsEntered(Changes.EnteredColumns.Num());
+	}
+	const bool bViewersMoved = Changes.bViewersMoved;
+	if (bViewersMoved || Changes.bPrefetchChanged)
+	{
+		UpdateGenerationViewers();
+	}
+
+	ApplyInterestChanges(Changes);
+	if (bViewersMoved || Changes.bViewsTurned || Changes.bPrefetchChanged)
+	{
+		SortPendingRequests();
+	}
+	RequestPendingColumns();
+
+	AddCompletedColumns();
+
+	ApplyStructureSpills();
+
+	UpdateReadyChunks(bViewersMoved);
+
+	// In the same order as ETerrainWork, the time one doesn't use goes to the ones after it
+	CollidePendingChunks();
+
+	MeshPendingChunks();
+
+	UnloadPendingColumns();
+
+	FrameBudget.EndFrame();
+
+	UpdateRegionRequests();
+
+	UpdateSpawnRegion();
+
+	UpdateMissingChunkStats(DeltaSeconds);
+
+	//time += DeltaSeconds;
+	//if (time >= 2.0f)
+	//{
+	//	time -= 2.0f;
+	//	PRINT_STRING(10, FString(TEXT("Main Thread")));
+	//}
+
+
+	//if (time < 0.5)
+	//{
+	//	time = 1;
+	//	GET_ROLE(Role, RoleString);
+	//	GET_ROLE(GetRemoteRole(), RemoteRoleString);
+	//
+	//	PRINT_STRING(1000, FString::Printf(TEXT("VoxelTerrain, Role: %s, RemoteRole: %s"), *RoleString, *RemoteRoleString));
+	//}
+
+}
+
+void AVoxelTerrain::AddCompletedColumns()
+{
+
+	// Columns that don't fit in the budget wait for the next tick
+	FTerrainCompletionQueue::FCompletedColumn Completed;
+	while (FrameBudget.HasTime(ETerrainWork::Insertion))
+	{
+		if (!CompletionQueue->Pop(Completed))
+		{
+			FrameBudget.Finish(ETerrainWork::Insertion);
+			break;
+		}
+
+		FTerrainFrameBudget::FScopedItem Item(FrameBudget, ETerrainWork::Insertion);
+		if (AddColumn(*Completed.Column))
+		{
+			FTerrainGeneratorStats::Get().AddResidentLatency(FPlatformTime::Cycles() - Completed.GeneratedCycles);
+		}
+		Completed.Column.Reset();
+	}
+
+}
+
+void AVoxelTerrain::ApplyStructureSpills()
+{
+
+	TArray<FStructureRegistry::FSpill> Spills;
+	StructureRegistry->TakeSpills(Spills);
+	if (Spills.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FStructureRegistry::FSpill> PendingSpills;
+	TSet<FIntVector3> DirtyChunks;
+
+	{
+		FScopeLock ChunkLock(&LoadedChunksMutex);
+
+		for (const FStructureRegistry::FSpill& Spill : Spills)
+		{
+			// The column will get the structure from the registry or from a later tick
+			if (IsColumnPending(Spill.ColumnCoord))
+			{
+				PendingSpills.Add(Spill);
+				continue;
+			}
+
+			const FStructureTemplate& Template = FStructureLibrary::Get().GetTemplate(Spill.Structure.Template);
+			const int32 MinChunkZ = FMath::Max(0, (Spill.Structure.Position.Z + Template.GetMin().Z) >> CHUNK_SHIFT);
+			const int32 MaxChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, (Spill.Structure.Position.Z + Template.GetMax().Z - 1) >> CHUNK_SHIFT);
+
+			for (int32 ChunkZ = MinChunkZ; ChunkZ <= MaxChunkZ; ++ChunkZ)
+			{
+				const FIntVector3 ChunkCoord(Spill.ColumnCoord.X, Spill.ColumnCoord.Y, ChunkZ);
+				const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+				if (ChunkIndex != nullptr)
+				{
+					Template.Stamp(Spill.Structure.Position, ChunkToWorldCoord(ChunkCoord), FIntVector3(CHUNK_SIZE), LoadedChunks[*ChunkIndex].Voxels.GetData());
+					DirtyChunks.Add(ChunkCoord);
+				}
+			}
+		}
+	}
+
+	if (PendingSpills.Num() > 0)
+	{
+		StructureRegistry->ReturnSpills(PendingSpills);
+	}
+
+	for (const FIntVector3& ChunkCoord : DirtyChunks)
+	{
+		MarkChunkDirty(ChunkCoord);
+	}
+
+}
+
+bool AVoxelTerrain::IsColumnPending(const FIntVector2D& ColumnCoord)
+{
+	return ChunkLifecycle.IsRequested(ColumnCoord);
+}
+
+bool AVoxelTerrain::LoadColumn(const FIntVector2D& ColumnCoord)
+{
+	// A column that comes back before its voxels were released is generated again from scratch
+	if (ChunkLifecycle.IsUnloading(ColumnCoord))
+	{
+		FinishUnloadColumn(ColumnCoord);
+		UnloadingColumns.Remove(ColumnCoord);
+	}
+
+	if (!ChunkLifecycle.Request(ColumnCoord))
+	{
+		return false;
+	}
+
+	GenerationQueue->Enqueue(ColumnCoord);
+	return true;
+}
+
+void AVoxelTerrain::CancelColumn(const FIntVector2D& ColumnCoord)
+{
+	if (ChunkLifecycle.Cancel(ColumnCoord))
+	{
+		GenerationQueue->Cancel(ColumnCoord);
+	}
+}
+
+void AVoxelTerrain::UnloadColumn(const FIntVector2D& ColumnCoord)
+{
+
+	if (!ChunkLifecycle.IsLoaded(ColumnCoord))
+	{
+		return;
+	}
+
+	// The neighbors stop counting the column right away, its voxels are released on a later tick
+	ChunkLifecycle.BeginUnload(ColumnCoord);
+	UnloadingColumns.Add(ColumnCoord);
+
+	{
+		FScopeLock MeshLock(&LoadedChunkMeshesMutex);
+		for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+		{
+			const FIntVector3 ChunkCoord(ColumnCoord.X, ColumnCoord.Y, ChunkZ);
+			UChunkMeshComponent* MeshComponent = nullptr;
+			if (LoadedChunkMeshComponents.RemoveAndCopyValue(ChunkCoord, MeshComponent))
+			{
+				MeshComponent->DestroyComponent();
+			}
+			DirtyChunkMeshes.Remove(ChunkCoord);
+		}
+	}
+
+	{
+		FScopeLock CollisionLock(&LoadedChunkCollisionsMutex);
+		for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+		{
+			UChunkCollisionComponent* CollisionComponent = nullptr;
+			if (LoadedChunkCollisionComponents.RemoveAndCopyValue(FIntVector3(ColumnCoord.X, ColumnCoord.Y, ChunkZ), CollisionComponent))
+			{
+				CollisionComponent->DestroyComponent();
+			}
+		}
+	}
+
+}
+
+void AVoxelTerrain::FinishUnloadColumn(const FIntVector2D& ColumnCoord)
+{
+
+	if (!ChunkLifecycle.IsUnloading(ColumnCoord))
+	{
+		return;
+	}
+
+	{
+		FScopeLock ChunkLock(&LoadedChunksMutex);
+		for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+		{
+			int32 ChunkIndex;
+			if (!LoadedChunksIndex.RemoveAndCopyValue(FIntVector3(ColumnCoord.X, ColumnCoord.Y, ChunkZ), ChunkIndex))
+			{
+				continue;
+			}
+
+			// The last chunk takes the place of the removed one, so only its index changes
+			LoadedChunks.RemoveAtSwap(ChunkIndex, 1, false);
+			if (ChunkIndex < LoadedChunks.Num())
+			{
+				LoadedChunksIndex[LoadedChunks[ChunkIndex].ChunkPosition] = ChunkIndex;
+			}
+		}
+	}
+
+	ChunkLifecycle.FinishUnload(ColumnCoord);
+
+	StructureRegistry->RemoveColumn(ColumnCoord);
+
+}
+
+bool AVoxelTerrain::AddColumn(FChunkColumn& Column)
+{
+
+	// The column was cancelled while it was being generated, or it was requested again after being cancelled and already arrived
+	if (!ChunkLifecycle.IsRequested(Column.ColumnPosition))
+	{
+		// Its structures were registered when it was generated
+		if (!ChunkLifecycle.IsLoaded(Column.ColumnPosition))
+		{
+			StructureRegistry->RemoveColumn(Column.ColumnPosition);
+		}
+		return false;
+	}
+
+	{
+		FScopeLock ChunkLock(&LoadedChunksMutex);
+
+		for (FChunk& Chunk : Column.Chunks)
+		{
+			if (LoadedChunksIndex.Contains(Chunk.ChunkPosition))
+			{
+				continue;
+			}
+
+			const int32 NewChunkIndex = LoadedChunks.Emplace(MoveTemp(Chunk));
+
+			LoadedChunksIndex.Add(LoadedChunks[NewChunkIndex].ChunkPosition, NewChunkIndex);
+
+#if TERRAIN_LOG
+			GET_THIS_ROLE(ChunkRole);
+			UE_LOG(LogStats, Log, TEXT("%s - ChunkIndex: %d, Chunk Added: <%d, %d, %d>"), *ChunkRole, NewChunkIndex, LoadedChunks[NewChunkIndex].ChunkPosition.X, LoadedChunks[NewChunkIndex].ChunkPosition.Y, LoadedChunks[NewChunkIndex].ChunkPosition.Z);
+#endif
+		}
+	}
+
+	UDebugLibrary::Println(this, 10, FString::Printf(TEXT("Column Added %s"), *Column.ColumnPosition.ToString()));
+
+	// Promotes the neighbors this column was the last one missing for
+	ChunkLifecycle.SetGenerated(Column.ColumnPosition);
+
+	return true;
+
+}
+
+void AVoxelTerrain::UpdateChunkHeightmap(const FIntVector3& ChunkCoord)
+{
+
+	TIME_START();
+
+	TArray<uint8> Voxels;
+
+	GetChunkVoxelsArray(ChunkCoord, Voxels);
+
+	if (Voxels.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int8> Heights;
+	Heights.SetNumUninitialized(1 << (2 * CHUNK_SHIFT));
+
+	// Loop through each column until a solid voxel, then set the height to that height
+	for (int32 x = 0; x < CHUNK_SIZE; ++x)
+	{
+		for (int32 y = 0; y < CHUNK_SIZE; ++y)
+		{
+			int8 z = CHUNK_SIZE - 1;
+			for (; z >= 0; --z)
+			{
+				if (Voxels[x | (y << Y_SHIFT) | (z << Z_SHIFT)] != 0)
+				{
+					break;
+				}
+			}
+			Heights[x | (y << Y_SHIFT)] = z;
+		}
+	}
+
+	FChunk& Chunk = GetChunkAt(ChunkCoord);
+
+	{
+		// Copies the generated height into the actual chunk's heightmap
+		FScopeLock ChunksLock(&LoadedChunksMutex);
+		FMemory::Memcpy(&Chunk.HighestSolidVoxels[0], &Heights[0], Heights.Num() * sizeof(int8));
+	}
+
+	TIME_END();
+
+	//PRINT_STRING(10, FLOAT_STRING(ElapsedTime));
+
+	//PRINT_STRING(10, FString::Printf(TEXT("Heighmap Updated <%d, %d>"), HeightmapCoord.X, HeightmapCoord.Y));
+
+}
+
+void AVoxelTerrain::AddViewerAnchor(AActor* Actor, const int32 DrawDistanceInChunks, const int32 CollisionDistanceInChunks)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	RemoveViewerAnchor(Actor);
+
+	FViewerAnchor& Anchor = ViewerAnchors[ViewerAnchors.AddUninitialized()];
+	Anchor.Actor = Actor;
+	Anchor.DrawDistanceInChunks = DrawDistanceInChunks > 0 ? DrawDistanceInChunks : TerrainParameters.DrawDistanceInChunks;
+	Anchor.CollisionDistanceInChunks = CollisionDistanceInChunks > 0 ? CollisionDistanceInChunks : TerrainParameters.CollisionDistanceInChunks;
+}
+
+void AVoxelTerrain::RemoveViewerAnchor(AActor* Actor)
+{
+	ViewerAnchors.RemoveAll([Actor](const FViewerAnchor& Anchor) { return Anchor.Actor.Get() == Actor; });
+}
+
+FTerrainRegionHandle AVoxelTerrain::RequestRegion(const FBox& Bounds, const ETerrainRegionStage RequiredStage, const float Priority)
+{
+
+	// Changing the bounds from world position into block then chunk position
+	const FIntVector3 MinVoxel = FIntVector3::Floor(Bounds.Min * 0.01f);
+	const FIntVector3 MaxVoxel = FIntVector3::Floor(Bounds.Max * 0.01f);
+	const FIntVector3 MinChunk(MinVoxel.X >> CHUNK_SHIFT, MinVoxel.Y >> CHUNK_SHIFT, FMath::Clamp(MinVoxel.Z >> CHUNK_SHIFT, 0, WORLD_HEIGHT_CHUNKS - 1));
+	const FIntVector3 MaxChunk(MaxVoxel.X >> CHUNK_SHIFT, MaxVoxel.Y >> CHUNK_SHIFT, FMath::Clamp(MaxVoxel.Z >> CHUNK_SHIFT, 0, WORLD_HEIGHT_CHUNKS - 1));
+
+	FTerrainRegionHandle Handle;
+
+	for (TPair<int32, FRegionRequest>& Pair : RegionRequests)
+	{
+		FRegionRequest& Request = Pair.Value;
+		if (Request.MinChunk == MinChunk && Request.MaxChunk == MaxChunk && Request.Stage == RequiredStage)
+		{
+			++Request.NumUsers;
+			Handle.RegionId = Pair.Key;
+			Handle.Future = Request.Future;
+			return Handle;
+		}
+	}
+
+	const int32 RegionId = NextRegionId++;
+	FRegionRequest& Request = RegionRequests.Add(RegionId);
+	Request.MinChunk = MinChunk;
+	Request.MaxChunk = MaxChunk;
+	Request.Stage = RequiredStage;
+	Request.NumUsers = 1;
+	Request.bReady = false;
+	Request.Promise = MakeShareable(new TPromise<bool>());
+	Request.Future = Request.Promise->GetFuture().Share();
+
+	// The columns of the region join the union like the ones around a viewer, so they are requested, meshed and kept the same way
+	FTerrainInterestManager::FChanges Changes;
+	Interest.AddRegion(RegionId, FIntVector2D(MinChunk.X, MinChunk.Y), FIntVector2D(MaxChunk.X, MaxChunk.Y), RequiredStage != ETerrainRegionStage::Voxels, Priority, Changes);
+	ApplyInterestChanges(Changes);
+	SortPendingRequests();
+	UpdateGenerationViewers();
+
+	// Some of it may already be loaded
+	QueueRegionChunks(Request, true, true);
+
+	Handle.RegionId = RegionId;
+	Handle.Future = Request.Future;
+	return Handle;
+
+}
+
+void AVoxelTerrain::ReleaseRegion(const int32 RegionId)
+{
+
+	FRegionRequest* const Request = RegionRequests.Find(RegionId);
+	if (Request == nullptr || --Request->NumUsers > 0)
+	{
+		return;
+	}
+
+	if (!Request->bReady)
+	{
+		Request->Promise->SetValue(false);
+	}
+	RegionRequests.Remove(RegionId);
+
+	FTerrainInterestManager::FChanges Changes;
+	Interest.RemoveRegion(RegionId, Changes);
+	ApplyInterestChanges(Changes);
+	UpdateGenerationViewers();
+
+}
+
+void AVoxelTerrain::UpdateGenerationViewers()
+{
+
+	// Where moving viewers are heading counts as a viewer too, so the columns ahead of them are generated sooner
+	TArray<FIntVector2D> ViewerColumnPositions;
+	for (int32 i = 0; i < Interest.Num(); ++i)
+	{
+		const FIntVector2D ViewerColumnPosition(Interest.GetViewerChunkPosition(i).X, Interest.GetViewerChunkPosition(i).Y);
+		ViewerColumnPositions.Add(ViewerColumnPosition);
+		if (Interest.GetPredictedColumn(i) != ViewerColumnPosition)
+		{
+			ViewerColumnPositions.Add(Interest.GetPredictedColumn(i));
+		}
+	}
+
+	// And so does every requested region
+	Interest.GetRegionCenters(ViewerColumnPositions);
+
+	GenerationQueue->SetViewers(ViewerColumnPositions);
+
+}
+
+void AVoxelTerrain::QueueRegionChunks(const FRegionRequest& Request, const bool bQueueMeshes, const bool bQueueCollisions)
+{
+
+	if (Request.Stage == ETerrainRegionStage::Voxels)
+	{
+		return;
+	}
+
+	for (int32 ColumnY = Request.MinChunk.Y; ColumnY <= Request.MaxChunk.Y; ++ColumnY)
+	{
+		for (int32 ColumnX = Request.MinChunk.X; ColumnX <= Request.MaxChunk.X; ++ColumnX)
+		{
+			const FIntVector2D ColumnCoord(ColumnX, ColumnY);
+			if (bQueueMeshes && ChunkLifecycle.GetUnmeshedColumns().Contains(ColumnCoord))
+			{
+				QueueReadyChunkMeshes(ColumnCoord);
+			}
+
+			if (!bQueueCollisions || Request.Stage != ETerrainRegionStage::Collision)
+			{
+				continue;
+			}
+
+			for (int32 ChunkZ = Request.MinChunk.Z; ChunkZ <= Request.MaxChunk.Z; ++ChunkZ)
+			{
+				const FIntVector3 ChunkCoord(ColumnX, ColumnY, ChunkZ);
+				if (ChunkLifecycle.NeedsCollision(ChunkCoord))
+				{
+					PendingCollisions.AddUnique(ChunkCoord);
+				}
+			}
+		}
+	}
+
+}
+
+bool AVoxelTerrain::IsRegionReady(const FRegionRequest& Request) const
+{
+
+	for (int32 ColumnY = Request.MinChunk.Y; ColumnY <= Request.MaxChunk.Y; ++ColumnY)
+	{
+		for (int32 ColumnX = Request.MinChunk.X; ColumnX <= Request.MaxChunk.X; ++ColumnX)
+		{
+			if (!ChunkLifecycle.IsLoaded(FIntVector2D(ColumnX, ColumnY)))
+			{
+				return false;
+			}
+
+			if (Request.Stage == ETerrainRegionStage::Voxels)
+			{
+				continue;
+			}
+
+			for (int32 ChunkZ = Request.MinChunk.Z; ChunkZ <= Request.MaxChunk.Z; ++ChunkZ)
+			{
+				const FIntVector3 ChunkCoord(ColumnX, ColumnY, ChunkZ);
+
+				if (!ChunkLifecycle.HasMesh(ChunkCoord))
+				{
+					return false;
+				}
+
+				if (Request.Stage == ETerrainRegionStage::Collision && !ChunkLifecycle.HasCollision(ChunkCoord))
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+
+}
+
+void AVoxelTerrain::UpdateRegionRequests()
+{
+	for (TPair<int32, FRegionRequest>& Pair : RegionRequests)
+	{
+		FRegionRequest& Request = Pair.Value;
+		if (!Request.bReady && IsRegionReady(Request))
+		{
+			Request.bReady = true;
+			Request.Promise->SetValue(true);
+		}
+	}
+}
+
+FVector AVoxelTerrain::FindSpawnLocation() const
+{
+	TActorIterator<APlayerStart> It(GetWorld());
+	return It ? It->GetActorLocation() : GetActorLocation();
+}
+
+void AVoxelTerrain::WarmStartRegion(const FRegionRequest& Request)
+{
+
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	// Meshes and collision need every neighbor, so the columns around the region are generated too
+	TArray<FIntVector2D> Columns;
+	for (int32 ColumnY = Request.MinChunk.Y - 1; ColumnY <= Request.MaxChunk.Y + 1; ++ColumnY)
+	{
+		for (int32 ColumnX = Request.MinChunk.X - 1; ColumnX <= Request.MaxChunk.X + 1; ++ColumnX)
+		{
+			const FIntVector2D ColumnCoord(ColumnX, ColumnY);
+			if (ChunkLifecycle.Request(ColumnCoord))
+			{
+				Columns.Add(ColumnCoord);
+			}
+		}
+	}
+
+	// Only the noise is saved, the surface and the structures are placed again so they are registered like any other column's
+	FString SnapshotFilename;
+	TArray<FNoiseTileKey> SnapshotKeys;
+	int32 NumSnapshotTiles = 0;
+	if (TerrainParameters.bCacheSpawnArea && FNoiseTileCache::IsEnabled())
+	{
+		for (const FIntVector2D& ColumnCoord : Columns)
+		{
+			SnapshotKeys.Add(UTerrainGenerator::GetNoiseTileKey(TerrainGenParameters, ColumnCoord));
+		}
+
+		const FNoiseTileKey RegionKey = UTerrainGenerator::GetNoiseTileKey(TerrainGenParameters, FIntVector2D(Request.MinChunk.X, Request.MinChunk.Y));
+		SnapshotFilename = FPaths::Combine(FPaths::GameSavedDir(), TEXT("TerrainCache"),
+			FString::Printf(TEXT("Spawn_%d_%08x_%d_%d_%d_%d.tiles"), RegionKey.Seed, RegionKey.ParameterHash, Request.MinChunk.X, Request.MinChunk.Y, Request.MaxChunk.X, Request.MaxChunk.Y));
+		NumSnapshotTiles = FNoiseTileCache::Get().LoadTiles(SnapshotFilename);
+	}
+
+	// Nothing else can run before the first frame, so every core generates
+	TArray<FChunkColumn> GeneratedColumns;
+	GeneratedColumns.SetNum(Columns.Num());
+	ParallelFor(Columns.Num(), [&](int32 ColumnIndex)
+	{
+		UTerrainGenerator::GenerateColumn(this, Columns[ColumnIndex], GeneratedColumns[ColumnIndex], TerrainGenParameters);
+	});
+
+	for (FChunkColumn& Column : GeneratedColumns)
+	{
+		AddColumn(Column);
+	}
+	ApplyStructureSpills();
+
+	const double GeneratedSeconds = FPlatformTime::Seconds();
+
+	for (int32 ColumnY = Request.MinChunk.Y; ColumnY <= Request.MaxChunk.Y; ++ColumnY)
+	{
+		for (int32 ColumnX = Request.MinChunk.X; ColumnX <= Request.MaxChunk.X; ++ColumnX)
+		{
+			for (int32 ChunkZ = Request.MinChunk.Z; ChunkZ <= Request.MaxChunk.Z; ++ChunkZ)
+			{
+				const FIntVector3 ChunkCoord(ColumnX, ColumnY, ChunkZ);
+
+				if (ChunkLifecycle.NeedsMesh(ChunkCoord))
+				{
+					GenerateMesh(ChunkCoord);
+					ChunkLifecycle.SetMeshed(ChunkCoord);
+				}
+			}
+		}
+	}
+
+	const double MeshedSeconds = FPlatformTime::Seconds();
+
+	if (Request.Stage == ETerrainRegionStage::Collision)
+	{
+		for (int32 ColumnY = Request.MinChunk.Y; ColumnY <= Request.MaxChunk.Y; ++ColumnY)
+		{
+			for (int32 ColumnX = Request.MinChunk.X; ColumnX <= Request.MaxChunk.X; ++ColumnX)
+			{
+				for (int32 ChunkZ = Request.MinChunk.Z; ChunkZ <= Request.MaxChunk.Z; ++ChunkZ)
+				{
+					const FIntVector3 ChunkCoord(ColumnX, ColumnY, ChunkZ);
+					if (ChunkLifecycle.NeedsCollision(ChunkCoord))
+					{
+						GenerateCollision(ChunkCoord);
+						ChunkLifecycle.SetCollided(ChunkCoord);
+					}
+				}
+			}
+		}
+	}
+
+	const double CollidedSeconds = FPlatformTime::Seconds();
+
+	// Written again whenever some of the noise wasn't in it, like the first time or after the spawn radius grew
+	if (!SnapshotFilename.IsEmpty() && NumSnapshotTiles < SnapshotKeys.Num())
+	{
+		FNoiseTileCache::Get().SaveTiles(SnapshotFilename, SnapshotKeys);
+	}
+
+	UE_LOG(LogStats, Log, TEXT("Warm started %d columns in %.1f ms: %.1f ms generating (%d of %d noise tiles from the snapshot), %.1f ms meshing, %.1f ms collision"),
+		Columns.Num(), (CollidedSeconds - StartSeconds) * 1000.0, (GeneratedSeconds - StartSeconds) * 1000.0, NumSnapshotTiles, SnapshotKeys.Num(),
+		(MeshedSeconds - GeneratedSeconds) * 1000.0, (CollidedSeconds - MeshedSeconds) * 1000.0);
+
+	UpdateRegionRequests();
+
+}
+
+void AVoxelTerrain::UpdateSpawnRegion()
+{
+
+	if (SpawnRegion.RegionId == INDEX_NONE || !SpawnRegion.Future.IsReady())
+	{
+		return;
+	}
+
+	if (SpawnRegion.Future.Get())
+	{
+		const double Seconds = FPlatformTime::Seconds();
+		TimeToPlayable = Seconds - BeginPlaySeconds;
+		UE_LOG(LogStats, Log, TEXT("Spawn area playable %.1f ms after BeginPlay, %.2f seconds after launch"), TimeToPlayable * 1000.0, Seconds - GStartTime);
+	}
+
+	// The viewers were set this tick, so the columns they need stay loaded
+	ReleaseRegion(SpawnRegion.RegionId);
+	SpawnRegion.RegionId = INDEX_NONE;
+
+}
+
+void AVoxelTerrain::LogMissingChunkStats(const bool bReset)
+{
+	UE_LOG(LogStats, Log, TEXT("Missing chunks in draw distance: %.1f seconds, %.2f average, %d max"), MissingChunkStats.Seconds,
+		MissingChunkStats.Seconds > 0.0 ? MissingChunkStats.MissingChunkSeconds / MissingChunkStats.Seconds : 0.0, MissingChunkStats.MaxMissingChunks);
+
+	if (bReset)
+	{
+		FMemory::Memzero(MissingChunkStats);
+	}
+}
+
+void AVoxelTerrain::UpdateMissingChunkStats(const float DeltaSeconds)
+{
+
+	if (CVarMissingChunkStats.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	// Overlapping viewers count the chunks they share once each, which is fine to compare runs with the same viewers
+	int32 NumMissing = 0;
+	for (int32 i = 0; i < Interest.Num(); ++i)
+	{
+		const FIntVector3& ViewerChunkPosition = Interest.GetViewerChunkPosition(i);
+		for (const FChunkOffsetTable::FOffset& Offset : Interest.GetCircle(Interest.GetViewer(i).DrawDistance))
+		{
+			for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+			{
+				const FIntVector3 ChunkCoord(ViewerChunkPosition.X + Offset.Offset.X, ViewerChunkPosition.Y + Offset.Offset.Y, ChunkZ);
+				if (!ChunkLifecycle.HasMesh(ChunkCoord))
+				{
+					++NumMissing;
+				}
+			}
+		}
+	}
+
+	MissingChunkStats.Seconds += DeltaSeconds;
+	MissingChunkStats.MissingChunkSeconds += NumMissing * DeltaSeconds;
+	MissingChunkStats.MaxMissingChunks = FMath::Max(MissingChunkStats.MaxMissingChunks, NumMissing);
+
+	MissingChunkStats.WindowSeconds += DeltaSeconds;
+	MissingChunkStats.WindowMissingChunkSeconds += NumMissing * DeltaSeconds;
+	MissingChunkStats.WindowMaxMissingChunks = FMath::Max(MissingChunkStats.WindowMaxMissingChunks, NumMissing);
+
+	if (MissingChunkStats.WindowSeconds >= 1.0)
+	{
+		UE_LOG(LogStats, Log, TEXT("Missing chunks in draw distance: %.2f average, %d max over the last %.2f seconds"),
+			MissingChunkStats.WindowMissingChunkSeconds / MissingChunkStats.WindowSeconds, MissingChunkStats.WindowMaxMissingChunks, MissingChunkStats.WindowSeconds);
+
+		MissingChunkStats.WindowSeconds = 0.0;
+		MissingChunkStats.WindowMissingChunkSeconds = 0.0;
+		MissingChunkStats.WindowMaxMissingChunks = 0;
+	}
+
+}
+
+void AVoxelTerrain::GatherViewers(TArray<FTerrainViewer>& OutViewers)
+{
+
+	// Lowered by the quality controller, but never below the minimum draw distance unless they were set lower
+	const int32 LoadExpansion = TerrainParameters.LoadExpansionRadius - Quality.GetLoadExpansionReduction();
+	const int32 DrawDistanceReduction = Quality.GetDrawDistanceReduction();
+	auto GetReducedDistance = [&](const int32 Distance)
+	{
+		return FMath::Max(FMath::Min(Distance, TerrainParameters.MinDrawDistanceInChunks), Distance - DrawDistanceReduction);
+	};
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* const PlayerController = Iterator->Get();
+		if (PlayerController == nullptr)
+		{
+			continue;
+		}
+
+		FTerrainViewer& Viewer = OutViewers[OutViewers.AddUninitialized()];
+		Viewer.Key = PlayerController;
+		Viewer.Location = PlayerController->GetFocalLocation();
+		Viewer.Velocity = PlayerController->GetPawnOrSpectator() != nullptr ? PlayerController->GetPawnOrSpectator()->GetVelocity() : FVector::ZeroVector;
+		Viewer.DrawDistance = GetReducedDistance(TerrainParameters.DrawDistanceInChunks);
+		Viewer.LoadDistance = Viewer.DrawDistance + LoadExpansion;
+		Viewer.CollisionDistance = GetReducedDistance(TerrainParameters.CollisionDistanceInChunks);
+
+		// Only local players have a camera, the ones on the server are streamed around in every direction
+		if (PlayerController->PlayerCameraManager != nullptr && PlayerController->IsLocalController())
+		{
+			Viewer.ViewDirection = PlayerController->PlayerCameraManager->GetCameraRotation().Vector();
+			Viewer.HalfFOV = FMath::DegreesToRadians(PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f);
+		}
+		else
+		{
+			Viewer.ViewDirection = FVector::ZeroVector;
+			Viewer.HalfFOV = PI;
+		}
+	}
+
+	ViewerAnchors.RemoveAll([](const FViewerAnchor& Anchor) { return !Anchor.Actor.IsValid(); });
+	for (const FViewerAnchor& Anchor : ViewerAnchors)
+	{
+		FTerrainViewer& Viewer = OutViewers[OutViewers.AddUninitialized()];
+		Viewer.Key = Anchor.Actor.Get();
+		Viewer.Location = Anchor.Actor->GetActorLocation();
+		Viewer.Velocity = Anchor.Actor->GetVelocity();
+		Viewer.ViewDirection = FVector::ZeroVector;
+		Viewer.HalfFOV = PI;
+		Viewer.DrawDistance = GetReducedDistance(Anchor.DrawDistanceInChunks);
+		Viewer.LoadDistance = Viewer.DrawDistance + LoadExpansion;
+		Viewer.CollisionDistance = GetReducedDistance(Anchor.CollisionDistanceInChunks);
+	}
+
+}
+
+bool AVoxelTerrain::UpdateQuality()
+{
+
+	// The game's delta is scaled by time dilation, the controller watches the real frames
+	const float FrameSeconds = FApp::GetDeltaTime();
+
+	FTerrainQualityController::FInputs Inputs;
+	Inputs.FrameSeconds = FrameSeconds;
+	// Only the game thread adds or removes chunks, so the count can be read without the lock
+	Inputs.ChunkBytes = (int64)LoadedChunks.Num() * ((1 << (3 * CHUNK_SHIFT)) * sizeof(uint8) + (1 << (2 * CHUNK_SHIFT)) * sizeof(int8));
+	Inputs.Backlog = PendingRequests.Num() + GenerationQueue->Num() + PendingMeshes.Num() + PendingCollisions.Num();
+
+	// Meshes need one column loaded around them, so the load expansion isn't lowered past it
+	FTerrainQualityController::FBounds Bounds;
+	Bounds.MaxLoadExpansionReduction = FMath::Max(0, TerrainParameters.LoadExpansionRadius - 1);
+	Bounds.MaxDrawDistanceReduction = FMath::Max(0, TerrainParameters.DrawDistanceInChunks - TerrainParameters.MinDrawDistanceInChunks);
+
+	return Quality.Update(FrameSeconds, Inputs, Bounds);
+
+}
+
+void AVoxelTerrain::ApplyInterestChanges(const FTerrainInterestManager::FChanges& Changes)
+{
+
+	PendingRequests.Append(Changes.EnteredColumns);
+
+	for (const FIntVector2D& ColumnCoord : Changes.LeftColumns)
+	{
+		CancelColumn(ColumnCoord);
+	}
+
+	for (const FIntVector2D& ColumnCoord : Changes.ReleasedColumns)
+	{
+		if (ChunkLifecycle.IsLoaded(ColumnCoord))
+		{
+			PendingUnloads.Add(ColumnCoord);
+		}
+	}
+
+}
+
+void AVoxelTerrain::SortPendingRequests()
+{
+
+	struct FRequest
+	{
+		FIntVector2D ColumnCoord;
+		float Priority;
+	};
+
+	const float OutOfViewScale = FMath::Max(1.0f, CVarOutOfViewDistanceScale.GetValueOnGameThread());
+
+	// Drops the columns that left the union, were requested since or are queued twice
+	TArray<FRequest> Requests;
+	Requests.Reserve(PendingRequests.Num());
+	TSet<FIntVector2D> QueuedColumns;
+	QueuedColumns.Reserve(PendingRequests.Num());
+	for (const FIntVector2D& ColumnCoord : PendingRequests)
+	{
+		bool bAlreadyQueued = false;
+		QueuedColumns.Add(ColumnCoord, &bAlreadyQueued);
+		if (!bAlreadyQueued && Interest.IsRequired(ColumnCoord) && !IsColumnPending(ColumnCoord) && !ChunkLifecycle.IsLoaded(ColumnCoord))
+		{
+			FRequest& Request = Requests[Requests.AddUninitialized()];
+			Request.ColumnCoord = ColumnCoord;
+			Request.Priority = Interest.GetRequestPriority(ColumnCoord, OutOfViewScale);
+		}
+	}
+
+	Requests.Sort([](const FRequest& A, const FRequest& B)
+	{
+		return A.Priority < B.Priority;
+	});
+
+	PendingRequests.Reset(Requests.Num());
+	for (const FRequest& Request : Requests)
+	{
+		PendingRequests.Add(Request.ColumnCoord);
+	}
+
+}
+
+void AVoxelTerrain::RequestPendingColumns()
+{
+
+	// Columns that left the union or are already requested or loaded are skipped without using up the budget
+	int32 RequestBudget = FMath::Max(1, CVarRequestsPerTick.GetValueOnGameThread());
+	int32 NumRequested = 0;
+	for (; NumRequested < PendingRequests.Num() && RequestBudget > 0; ++NumRequested)
+	{
+		const FIntVector2D& ColumnCoord = PendingRequests[NumRequested];
+		if (Interest.IsRequired(ColumnCoord) && LoadColumn(ColumnCoord))
+		{
+			--RequestBudget;
+		}
+	}
+	PendingRequests.RemoveAt(0, NumRequested, false);
+
+}
+
+void AVoxelTerrain::UpdateReadyChunks(const bool bViewersMoved)
+{
+
+	TArray<FIntVector2D> ReadyColumns;
+	ChunkLifecycle.TakeReadyColumns(ReadyColumns);
+
+	if (bViewersMoved)
+	{
+		// Columns that were out of draw distance when they became ready can only come into range when a viewer moves
+		PendingMeshes.Reset();
+		if (ChunkLifecycle.GetUnmeshedColumns().Num() > 0)
+		{
+			for (int32 i = 0; i < Interest.Num(); ++i)
+			{
+				const FIntVector3& ViewerChunkPosition = Interest.GetViewerChunkPosition(i);
+				for (const FChunkOffsetTable::FOffset& Offset : Interest.GetCircle(Interest.GetViewer(i).DrawDistance))
+				{
+					const FIntVector2D ColumnCoord(ViewerChunkPosition.X + Offset.Offset.X, ViewerChunkPosition.Y + Offset.Offset.Y);
+					if (ChunkLifecycle.GetUnmeshedColumns().Contains(ColumnCoord))
+					{
+						QueueReadyChunkMeshes(ColumnCoord);
+					}
+				}
+			}
+
+			for (const TPair<int32, FRegionRequest>& Pair : RegionRequests)
+			{
+				if (!Pair.Value.bReady)
+				{
+					QueueRegionChunks(Pair.Value, true, false);
+				}
+			}
+		}
+	}
+	else
+	{
+		for (const FIntVector2D& ColumnCoord : ReadyColumns)
+		{
+			if (Interest.IsInDrawDistance(ColumnCoord))
+			{
+				QueueReadyChunkMeshes(ColumnCoord);
+			}
+		}
+	}
+
+	// The collision spheres are small, so they are walked again whenever something in them could have changed
+	if (!bViewersMoved && ReadyColumns.Num() == 0)
+	{
+		return;
+	}
+
+	PendingCollisions.Reset();
+	for (int32 i = 0; i < Interest.Num(); ++i)
+	{
+		const FIntVector3& ViewerChunkPosition = Interest.GetViewerChunkPosition(i);
+		for (const FChunkOffsetTable::FOffset& Offset : Interest.GetSphere(Interest.GetViewer(i).CollisionDistance))
+		{
+			const FIntVector3 ChunkCoord = ViewerChunkPosition + Offset.Offset;
+			if (ChunkCoord.Z < 0 || ChunkCoord.Z >= WORLD_HEIGHT_CHUNKS)
+			{
+				continue;
+			}
+
+			if (ChunkLifecycle.NeedsCollision(ChunkCoord))
+			{
+				PendingCollisions.AddUnique(ChunkCoord);
+			}
+		}
+	}
+
+	// Regions that need collision get it no matter how far the viewers are
+	for (const TPair<int32, FRegionRequest>& Pair : RegionRequests)
+	{
+		if (!Pair.Value.bReady)
+		{
+			QueueRegionChunks(Pair.Value, false, true);
+		}
+	}
+
+}
+
+void AVoxelTerrain::QueueReadyChunkMeshes(const FIntVector2D& ColumnCoord)
+{
+	for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+	{
+		const FIntVector3 ChunkCoord(ColumnCoord.X, ColumnCoord.Y, ChunkZ);
+
+		if (ChunkLifecycle.NeedsMesh(ChunkCoord))
+		{
+			PendingMeshes.Add(ChunkCoord);
+		}
+	}
+}
+
+void AVoxelTerrain::CollidePendingChunks()
+{
+
+	int32 NumCollided = 0;
+	for (; NumCollided < PendingCollisions.Num() && FrameBudget.HasTime(ETerrainWork::Collision); ++NumCollided)
+	{
+		// The chunk may have been unloaded since it was queued
+		const FIntVector3& ChunkCoord = PendingCollisions[NumCollided];
+		if (ChunkLifecycle.NeedsCollision(ChunkCoord))
+		{
+			FTerrainFrameBudget::FScopedItem Item(FrameBudget, ETerrainWork::Collision);
+			GenerateCollision(ChunkCoord);
+			ChunkLifecycle.SetCollided(ChunkCoord);
+		}
+	}
+	PendingCollisions.RemoveAt(0, NumCollided, false);
+
+	if (PendingCollisions.Num() == 0)
+	{
+		FrameBudget.Finish(ETerrainWork::Collision);
+	}
+
+}
+
+void AVoxelTerrain::MeshPendingChunks()
+{
+
+	int32 NumMeshed = 0;
+	for (; NumMeshed < PendingMeshes.Num() && FrameBudget.HasTime(ETerrainWork::Meshing); ++NumMeshed)
+	{
+		// The chunk may have been meshed or unloaded since it was queued
+		const FIntVector3& ChunkCoord = PendingMeshes[NumMeshed];
+		if (ChunkLifecycle.NeedsMesh(ChunkCoord))
+		{
+			FTerrainFrameBudget::FScopedItem Item(FrameBudget, ETerrainWork::Meshing);
+			GenerateMesh(ChunkCoord);
+			ChunkLifecycle.SetMeshed(ChunkCoord);
+		}
+	}
+	PendingMeshes.RemoveAt(0, NumMeshed, false);
+
+	if (PendingMeshes.Num() > 0)
+	{
+		return;
+	}
+
+	// Low priority updates come after the chunks that have no mesh at all
+	FScopeLock MeshLock(&LoadedChunkMeshesMutex);
+
+	for (TSet<FIntVector3>::TIterator It = DirtyChunkMeshes.CreateIterator(); It; ++It)
+	{
+		if (!FrameBudget.HasTime(ETerrainWork::Meshing))
+		{
+			return;
+		}
+
+		UChunkMeshComponent* const MeshComponent = LoadedChunkMeshComponents.FindRef(*It);
+		if (MeshComponent != nullptr && MeshComponent->HasLowPriorityUpdatePending)
+		{
+			FTerrainFrameBudget::FScopedItem Item(FrameBudget, ETerrainWork::Meshing);
+			MeshComponent->MarkRenderStateDirty();
+			MeshComponent->HasLowPriorityUpdatePending = false;
+		}
+		It.RemoveCurrent();
+	}
+
+	FrameBudget.Finish(ETerrainWork::Meshing);
+
+}
+
+void AVoxelTerrain::UnloadPendingColumns()
+{
+
+	// The columns whose components were released on an earlier tick give back their voxels first
+	int32 NumFinished = 0;
+	for (; NumFinished < UnloadingColumns.Num() && FrameBudget.HasTime(ETerrainWork::Unloading); ++NumFinished)
+	{
+		FTerrainFrameBudget::FScopedItem Item(FrameBudget, ETerrainWork::Unloading);
+		FinishUnloadColumn(UnloadingColumns[NumFinished]);
+	}
+	UnloadingColumns.RemoveAt(0, NumFinished, false);
+
+	if (UnloadingColumns.Num() > 0)
+	{
+		return;
+	}
+
+	for (TSet<FIntVector2D>::TIterator It = PendingUnloads.CreateIterator(); It; ++It)
+	{
+		if (!FrameBudget.HasTime(ETerrainWork::Unloading))
+		{
+			return;
+		}
+
+		// A viewer may have come back since the column was queued
+		if (!Interest.IsRetained(*It))
+		{
+			FTerrainFrameBudget::FScopedItem Item(FrameBudget, ETerrainWork::Unloading);
+			UnloadColumn(*It);
+		}
+		It.RemoveCurrent();
+	}
+
+	FrameBudget.Finish(ETerrainWork::Unloading);
+
+}
+
+void AVoxelTerrain::GenerateMesh(const FIntVector3& ChunkCoord)
+{
+
+	FScopeLock MeshLock(&LoadedChunkMeshesMutex);
+	UChunkMeshComponent* const MeshComponent = LoadedChunkMeshComponents.FindRef(ChunkCoord);
+
+	if (MeshComponent == nullptr) // Make a new mesh component if it's generated
+	{
+		UChunkMeshComponent* NewMesh = NewObject<UChunkMeshComponent>(this);
+
+		NewMesh->VoxelTerrain = this;
+		NewMesh->ChunkCoord = ChunkCoord;
+		NewMesh->HasLowPriorityUpdatePending = false;
+
+		NewMesh->SetRelativeLocation(ChunkToWorldCoord(ChunkCoord).ToFloat());
+		NewMesh->AttachToComponent(RootComponent, FAttachmentTransformRules(EAttachmentRule::KeepRelative, false));
+		NewMesh->RegisterComponent();
+
+		// Add to the TMap that stores all the meshes
+		LoadedChunkMeshComponents.Add(ChunkCoord, NewMesh);
+
+#if TERRAIN_LOG
+		UE_LOG(LogStats, Log, TEXT("<%d, %d, %d> Chunk Mesh Component Added to List"), ChunkCoord.X, ChunkCoord.Y, ChunkCoord.Z);
+#endif
+	}
+	else if (MeshComponent->HasLowPriorityUpdatePending) // if it has a low priority update pending (meaning either far away or AO
+	{
+		MeshComponent->MarkRenderStateDirty();
+		MeshComponent->HasLowPriorityUpdatePending = false;
+	}
+
+}
+
+void AVoxelTerrain::GenerateCollision(const FIntVector3& ChunkCoord)
+{
+	FScopeLock CollisionLock(&LoadedChunkCollisionsMutex);
+
+	const UChunkCollisionComponent* const CollisionComponent = LoadedChunkCollisionComponents.FindRef(ChunkCoord);
+
+	if (CollisionComponent == nullptr) // Generate a collision mesh if it doesn't exist
+	{
+		UChunkCollisionComponent* NewCollision = NewObject<UChunkCollisionComponent>(this);
+		NewCollision->VoxelTerrain = this;
+		NewCollision->ChunkCoord = ChunkCoord;
+
+		NewCollision->SetRelativeLocation(ChunkToWorldCoord(ChunkCoord).ToFloat());
+		NewCollision->AttachToComponent(RootComponent, FAttachmentTransformRules(EAttachmentRule::KeepRelative, false));
+		NewCollision->RegisterComponent();
+
+		LoadedChunkCollisionComponents.Add(ChunkCoord, NewCollision);
+
+		UDebugLibrary::Println(this, 10, ChunkCoord.ToString());
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// VOXEL/CHUNK METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FVoxelType AVoxelTerrain::GetVoxelType(const uint8& Voxel) const
+{
+	checkf(Voxel < TerrainParameters.VoxelTypes.Num(), TEXT("There are NO Voxel Type (%d)!!!! There are only (%d) Voxel Types!!!"), Voxel, TerrainParameters.VoxelTypes.Num());
+	return TerrainParameters.VoxelTypes[(int32)Voxel];
+}
+
+int32 AVoxelTerrain::GetNumVoxelTypes() const
+{
+	return TerrainParameters.VoxelTypes.Num();
+}
+
+uint8 AVoxelTerrain::GetVoxelAt(const int32& x, const int32& y, const int32& z)
+{
+
+	// Convert from global to local voxel coordinate
+	const FIntVector3 ChunkCoord(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+	const int32& LocalX = x & CHUNK_SIZE_MASK;
+	const int32& LocalY = y & CHUNK_SIZE_MASK;
+	const int32& LocalZ = z & CHUNK_SIZE_MASK;
+
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+
+	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+	if (ChunkIndex != nullptr)
+	{
+		const FChunk& Chunk = LoadedChunks[*ChunkIndex];
+		return Chunk.Voxels[LocalX | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT)];
+	}
+	else // Return 0 (Air) if the chunk is not loaded
+	{
+		return (uint8)0;
+	}
+
+}
+
+void AVoxelTerrain::SetVoxelAt(const int32& x, const int32& y, const int32& z, uint8 Voxel)
+{
+
+	// Convert from global to local voxel coordinate
+	const FIntVector3 ChunkCoord(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+	const int32& LocalX = x & CHUNK_SIZE_MASK;
+	const int32& LocalY = y & CHUNK_SIZE_MASK;
+	const int32& LocalZ = z & CHUNK_SIZE_MASK;
+
+	// Only mark chunk for re-mesh if something was changed
+	bool bIsVoxelSet = false;
+
+	{
+		// Lock the container
+		FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+		if (ChunkIndex != nullptr) // only set voxel if the chunk is loaded
+		{
+			FChunk& Chunk = LoadedChunks[*ChunkIndex];
+			Chunk.Voxels[LocalX | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT)] = Voxel;
+			bIsVoxelSet = true;
+		}
+	}
+
+	if (bIsVoxelSet)
+	{
+		MarkVoxelDirty(FIntVector3(x, y, z));
+	}
+
+
+}
+
+void AVoxelTerrain::MarkVoxelAreaDirty(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord)
+{
+	// TODO: Implement
+	// Just add blur radius to all sides and modulo each one to get chunk coordinate and update
+}
+
+void AVoxelTerrain::MarkVoxelDirty(const FIntVector3& VoxelCoord)
+{
+	const FIntVector3 ChunkCoord = WorldToChunkCoord(VoxelCoord);
+
+	const int32& LocalX = VoxelCoord.X & CHUNK_SIZE_MASK;
+	const int32& LocalY = VoxelCoord.Y & CHUNK_SIZE_MASK;
+	const int32& LocalZ = VoxelCoord.Z & CHUNK_SIZE_MASK;
+
+	// Already lockes so we dont want to lock it again.
+	UpdateChunkHeightmap(ChunkCoord);
+
+	FScopeLock LoadedCollisionLock(&LoadedChunkCollisionsMutex);
+	FScopeLock LoadedMeshLock(&LoadedChunkMeshesMutex);
+
+	// Check all neighbor chunks and if the voxel is close enough to the edge for them to be remeshed
+	TArray<bool> ShouldNeighborChunkUpdate;
+	ShouldNeighborChunkUpdate.SetNumUninitialized(9);
+	ShouldNeighborChunkUpdate[4] = true;
+	ShouldNeighborChunkUpdate[3] = LocalX - TerrainParameters.AOBlurRadus < 0;
+	ShouldNeighborChunkUpdate[5] = LocalX + TerrainParameters.AOBlurRadus >= CHUNK_SIZE;
+	ShouldNeighborChunkUpdate[1] = LocalY - TerrainParameters.AOBlurRadus < 0;
+	ShouldNeighborChunkUpdate[7] = LocalY + TerrainParameters.AOBlurRadus >= CHUNK_SIZE;
+	ShouldNeighborChunkUpdate[0] = ShouldNeighborChunkUpdate[3] && ShouldNeighborChunkUpdate[1];
+	ShouldNeighborChunkUpdate[2] = ShouldNeighborChunkUpdate[5] && ShouldNeighborChunkUpdate[1];
+	ShouldNeighborChunkUpdate[6] = ShouldNeighborChunkUpdate[3] && ShouldNeighborChunkUpdate[7];
+	ShouldNeighborChunkUpdate[8] = ShouldNeighborChunkUpdate[5] && ShouldNeighborChunkUpdate[7];
+
+	// Moore's neighbor
+	for (int32 i = 0; i < 9; ++i)
+	{
+		if (!ShouldNeighborChunkUpdate[i])
+		{
+			continue;
+		}
+
+		const int32 ChunkX = ChunkCoord.X + (i % 3 - 1);
+		const int32 ChunkY = ChunkCoord.Y + (i / 3 - 1);
+
+		// Update the meshes for all chunks in this column because ambient occlusion
+		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= 0; --ChunkZ)
+		{
+			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
+			UChunkMeshComponent* const ChunkMesh = LoadedChunkMeshComponents.FindRef(CurrentChunkCoord);
+			if (ChunkMesh != nullptr)
+			{
+				// TODO: Only do this for adjacent chunks, otherwise use MarkRenderStateDirty
+				ChunkMesh->HasLowPriorityUpdatePending = true;
+				DirtyChunkMeshes.Add(CurrentChunkCoord);
+			}
+		}
+
+		// Same for collision
+		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= FMath::Max(0, ChunkCoord.Z - 1); --ChunkZ)
+		{
+			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
+			UChunkCollisionComponent* const ChunkCollision = LoadedChunkCollisionComponents.FindRef(CurrentChunkCoord);
+			if (ChunkCollision != nullptr)
+			{
+				ChunkCollision->MarkRenderStateDirty();
+			}
+		}
+
+	}
+
+
+}
+
+void AVoxelTerrain::MarkChunkDirty(const FIntVector3& ChunkCoord)
+{
+
+	// Already lockes so we dont want to lock it again.
+	UpdateChunkHeightmap(ChunkCoord);
+
+	FScopeLock LoadedCollisionLock(&LoadedChunkCollisionsMutex);
+	FScopeLock LoadedMeshLock(&LoadedChunkMeshesMutex);
+
+	// Moore's neighbor
+	for (int32 i = 0; i < 9; ++i)
+	{
+		const int32 ChunkX = ChunkCoord.X + (i % 3 - 1);
+		const int32 ChunkY = ChunkCoord.Y + (i / 3 - 1);
+
+		// Update the meshes for all chunks in this column because ambient occlusion
+		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= 0; --ChunkZ)
+		{
+			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
+			UChunkMeshComponent* const ChunkMesh = LoadedChunkMeshComponents.FindRef(CurrentChunkCoord);
+			if (ChunkMesh != nullptr)
+			{
+				// TODO: Only do this for adjacent chunks,otherwise use MarkRenderStateDirty
+				ChunkMesh->HasLowPriorityUpdatePending = true;
+				DirtyChunkMeshes.Add(CurrentChunkCoord);
+			}
+		}
+
+		// Same for collision
+		for (int32 ChunkZ = FMath::Min(WORLD_HEIGHT_CHUNKS - 1, ChunkCoord.Z + 1); ChunkZ >= FMath::Max(0, ChunkCoord.Z - 1); --ChunkZ)
+		{
+			const FIntVector3 CurrentChunkCoord(ChunkX, ChunkY, ChunkZ);
+			UChunkCollisionComponent* const ChunkCollision = LoadedChunkCollisionComponents.FindRef(CurrentChunkCoord);
+			
+			if (ChunkCollision != nullptr)
+			{
+				ChunkCollision->MarkRenderStateDirty();
+			}
+
+		}
+
+	}
+}
+
+void AVoxelTerrain::GetChunkVoxelsArray(const FIntVector3& ChunkCoord, TArray<uint8>& OutVoxelsArray)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+	if (ChunkIndex != nullptr)
+	{
+		// Gets the chunk array
+		const FChunk& Chunk = LoadedChunks[*ChunkIndex];
+		OutVoxelsArray.SetNumUninitialized(Chunk.Voxels.Num());
+		FMemory::Memcpy(&OutVoxelsArray[0], &Chunk.Voxels[0], Chunk.Voxels.Num() * sizeof(uint8));
+	}
+}
+
+void AVoxelTerrain::GetVoxelsArray(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord, TArray<uint8>& OutVoxelsArray)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+
+	// Voxel to chunk coord
+	const FIntVector3& MinChunkCoord = WorldToChunkCoord(MinVoxelCoord);
+	const FIntVector3& MaxChunkCoord = WorldToChunkCoord(MaxVoxelCoord);
+	const FIntVector3& OutputDimensions = MaxVoxelCoord + FIntVector3(1) - MinVoxelCoord;
+
+	OutVoxelsArray.SetNumUninitialized(OutputDimensions.X * OutputDimensions.Y * OutputDimensions.Z);
+
+	// Loops through all chunks in between min and max
+	for (int32 ChunkZ = MinChunkCoord.Z; ChunkZ <= MaxChunkCoord.Z; ++ChunkZ)
+	{
+		for (int32 ChunkY = MinChunkCoord.Y; ChunkY <= MaxChunkCoord.Y; ++ChunkY)
+		{
+			for (int32 ChunkX = MinChunkCoord.X; ChunkX <= MaxChunkCoord.X; ++ChunkX)
+			{
+				const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
+				const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+				const FIntVector3 ChunkVoxelCoord(ChunkX << CHUNK_SHIFT, ChunkY << CHUNK_SHIFT, ChunkZ << CHUNK_SHIFT);
+
+				// The min and max coord may be only part of the chunk, and we don't want index out of bound
+				const FIntVector3 MinVoxelCoordInChunk = FIntVector3::Max(FIntVector3(0), MinVoxelCoord - ChunkVoxelCoord); // Inclusive
+				const FIntVector3 MaxVoxelCoordInChunk = FIntVector3::Min(FIntVector3(CHUNK_SIZE - 1), MaxVoxelCoord - ChunkVoxelCoord); // Inclusive
+
+				for (int32 LocalZ = MinVoxelCoordInChunk.Z; LocalZ <= MaxVoxelCoordInChunk.Z; ++LocalZ)
+				{
+					for (int32 LocalY = MinVoxelCoordInChunk.Y; LocalY <= MaxVoxelCoordInChunk.Y; ++LocalY)
+					{
+						const int32 OutputSizeX = MaxVoxelCoordInChunk.X - MinVoxelCoordInChunk.X + 1; // Num to copy from original array in the x axis
+						const int32 LocalXStart = MinVoxelCoordInChunk.X; // Start copy from where in the original array? 
+
+						const int32 LocalVoxelStartIndex = LocalXStart | (LocalY << Y_SHIFT) | (LocalZ << Z_SHIFT);
+
+						const int32 OutputX = ChunkVoxelCoord.X + LocalXStart - MinVoxelCoord.X; // Location in output array
+						const int32 OutputY = ChunkVoxelCoord.Y + LocalY - MinVoxelCoord.Y; // Location in output array
+						const int32 OutputZ = ChunkVoxelCoord.Z + LocalZ - MinVoxelCoord.Z; // Location in output array
+
+						const int32 OutputIndex = OutputX + OutputY * OutputDimensions.X + OutputZ * OutputDimensions.X * OutputDimensions.Y;
+
+						if (ChunkIndex != nullptr)
+						{
+							FMemory::Memcpy(&OutVoxelsArray[OutputIndex], &LoadedChunks[*ChunkIndex].Voxels[LocalVoxelStartIndex], OutputSizeX * sizeof(uint8));
+						}
+						else
+						{
+							FMemory::Memset(&OutVoxelsArray[OutputIndex], 0, OutputSizeX * sizeof(uint8));
+						}
+					}
+				}
+
+			}
+		}
+	}
+
+}
+
+bool AVoxelTerrain::HasChunk(const FIntVector3& ChunkCoord)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+	return ChunkIndex != nullptr;
+}
+
+bool AVoxelTerrain::HasAllNeighborChunks(const FIntVector3& ChunkCoord)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+
+	// Moore's neighbor
+	for (int32 i = 0; i < 9; ++i)
+	{
+		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord + FIntVector3(i % 3 - 1, i / 3 - 1, 0));
+		if (ChunkIndex == nullptr)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FChunk& AVoxelTerrain::GetChunkAt(const FIntVector3& ChunkCoord)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+
+	checkf(ChunkIndex != nullptr, TEXT("FChunk& AVoxelTerrain::GetChunkAt(const FIntVector3&) -> Chunk <%s> is not loaded!!!!"), *ChunkCoord.ToString());
+
+	return LoadedChunks[*ChunkIndex];
+}
+
+FChunk& AVoxelTerrain::GetChunkAndIndexAt(const FIntVector3& ChunkCoord, int32& OutChunkIndex)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+
+	checkf(ChunkIndex != nullptr, TEXT("FChunk& AVoxelTerrain::GetChunkAndIndexAt(const FIntVector3&, int32&) -> Chunk <%s> is not loaded!!!!"), *ChunkCoord.ToString());
+
+	OutChunkIndex = *ChunkIndex;
+	return LoadedChunks[*ChunkIndex];
+}
+
+int32 AVoxelTerrain::GetChunkIndexAt(const FIntVector3& ChunkCoord)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+	const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+
+	checkf(ChunkIndex != nullptr, TEXT("int32 AVoxelTerrain::GetChunkIndexAt(const FIntVector3&) -> Chunk <%s> is not loaded!!!!"), *ChunkCoord.ToString());
+
+	return *ChunkIndex;
+}
+
+bool AVoxelTerrain::HasChunkColumn(const FIntVector2D& ChunkColumnCoord)
+{
+	// The Scope Lock is in HasChunk(), so we don't lock it here to prevent a dead lock
+	for (int32 i = 0; i < WORLD_HEIGHT_CHUNKS; ++i)
+	{
+		if (!HasChunk(FIntVector3(ChunkColumnCoord.X, ChunkColumnCoord.Y, i)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// CHUNK MESH METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns whether the mesh for the chunks at ChunkCoord is loaded. */
+bool AVoxelTerrain::HasChunkMesh(const FIntVector3& ChunkCoord)
+{
+	FScopeLock MeshLock(&LoadedChunkMeshesMutex);
+	const UChunkMeshComponent* const Mesh = LoadedChunkMeshComponents.FindRef(ChunkCoord);
+	return Mesh != nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// CHUNK COLLISION METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool AVoxelTerrain::HasChunkCollision(const FIntVector3& ChunkCoord)
+{
+	FScopeLock CollisionLock(&LoadedChunkCollisionsMutex);
+	const UChunkCollisionComponent* const Collision = LoadedChunkCollisionComponents.FindRef(ChunkCoord);
+	return Collision != nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// HEIGHTMAP METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int32 AVoxelTerrain::GetHeightAt(const int32& x, const int32& y)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+
+	const int32 ChunkX = x >> CHUNK_SHIFT;
+	const int32 ChunkY = y >> CHUNK_SHIFT;
+
+	const int32 LocalX = x & CHUNK_SIZE_MASK;
+	const int32 LocalY = y & CHUNK_SIZE_MASK;
+
+	int32 Height = -1;
+
+	// We have to loop through the whole column and add the height values together
+	for (int32 ChunkZ = WORLD_HEIGHT_CHUNKS - 1; ChunkZ >= 0; --ChunkZ)
+	{
+		const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
+		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+
+		if (ChunkIndex != nullptr)
+		{
+			const int32& LocalHeight = LoadedChunks[*ChunkIndex].HighestSolidVoxels[LocalX | (LocalY << Y_SHIFT)];
+			if (LocalHeight >= 0)
+			{
+				const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
+				Height = ChunkVoxelZ + LocalHeight;
+				break;
+			}
+		}
+	}
+
+	return Height;
+}
+
+void AVoxelTerrain::GetChunkHeightsArray(const FIntVector2D& HeightmapCoord, TArray<int32>& OutHeightsArray)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+
+	OutHeightsArray.Init(-1, 1 << (2 * CHUNK_SHIFT));
+
+	const int32& ChunkX = HeightmapCoord.X;
+	const int32& ChunkY = HeightmapCoord.Y;
+
+	// Loops through the chunks and add the heights together
+	for (int32 ChunkZ = WORLD_HEIGHT_CHUNKS - 1; ChunkZ >= 0; --ChunkZ)
+	{
+		const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
+		const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+
+		if (ChunkIndex != nullptr)
+		{
+			for (int32 LocalY = 0; LocalY < CHUNK_SIZE; ++LocalY) // For each height in this chunk
+			{
+				for (int32 LocalX = 0; LocalX < CHUNK_SIZE; ++LocalX) // For each height in this chunk
+				{
+					const int32 HeightIndex = LocalX | (LocalY << Y_SHIFT);
+					const int32& LocalHeight = LoadedChunks[*ChunkIndex].HighestSolidVoxels[HeightIndex]; // Height of this current voxel in chunk
+					const int32& OutputHeight = OutHeightsArray[HeightIndex]; // Current height stored in Output Array
+
+																			  // If the this height is larger than zero AND the output height does not already have a value
+					if (LocalHeight >= 0 && OutputHeight < 0)
+					{
+						const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
+						OutHeightsArray[HeightIndex] = ChunkVoxelZ + LocalHeight;
+					}
+				}
+			}
+		}
+	}
+}
+
+void AVoxelTerrain::GetHeightsArray(const FIntVector2D& MinHeightCoord, const FIntVector2D& MaxHeightCoord, TArray<int32>& OutHeightsArray)
+{
+	FScopeLock LoadedChunksLock(&LoadedChunksMutex);
+
+	const FIntVector2D& MinHeightmapCoord = MinHeightCoord >> CHUNK_SHIFT;
+	const FIntVector2D& MaxHeightmapCoord = MaxHeightCoord >> CHUNK_SHIFT;
+	const FIntVector2D& OutputDimensions = MaxHeightCoord + FIntVector2D(1) - MinHeightCoord;
+
+	OutHeightsArray.Init(-1, OutputDimensions.X * OutputDimensions.Y);
+
+	// Loops through all possible chunk <x, y> coordinate
+	for (int32 ChunkY = MinHeightmapCoord.Y; ChunkY <= MaxHeightmapCoord.Y; ++ChunkY)
+	{
+		for (int32 ChunkX = MinHeightmapCoord.X; ChunkX <= MaxHeightmapCoord.X; ++ChunkX)
+		{
+			const FIntVector2D HeightmapVoxelCoord(ChunkX << CHUNK_SHIFT, ChunkY << CHUNK_SHIFT);
+
+			// The min and max coord may be only part of the chunk, and we don't want index out of bound
+			const FIntVector2D MinVoxelCoordInChunk = FIntVector2D::Max(FIntVector2D(0), MinHeightCoord - HeightmapVoxelCoord); // Inclusive
+			const FIntVector2D MaxVoxelCoordInChunk = FIntVector2D::Min(FIntVector2D(CHUNK_SIZE - 1), MaxHeightCoord - HeightmapVoxelCoord); // Inclusive
+
+																																			 // Add the heights together
+			for (int32 ChunkZ = WORLD_HEIGHT_CHUNKS - 1; ChunkZ >= 0; --ChunkZ)
+			{
+				const FIntVector3 ChunkCoord(ChunkX, ChunkY, ChunkZ);
+				const int32* const ChunkIndex = LoadedChunksIndex.Find(ChunkCoord);
+
+				if (ChunkIndex != nullptr)
+				{
+					for (int32 LocalY = MinVoxelCoordInChunk.Y; LocalY <= MaxVoxelCoordInChunk.Y; ++LocalY) // For each height in this chunk
+					{
+						for (int32 LocalX = MinVoxelCoordInChunk.X; LocalX <= MaxVoxelCoordInChunk.X; ++LocalX) // For each height in this chunk
+						{
+							const int32 LocalHeightIndex = LocalX | (LocalY << Y_SHIFT);
+							const int32& LocalHeight = LoadedChunks[*ChunkIndex].HighestSolidVoxels[LocalHeightIndex]; // Height of this current voxel in chunk
+
+							const int32 OutputX = HeightmapVoxelCoord.X + LocalX - MinHeightCoord.X; // Location in output array
+							const int32 OutputY = HeightmapVoxelCoord.Y + LocalY - MinHeightCoord.Y; // Location in output array
+							const int32 OutputIndex = OutputX + OutputY * OutputDimensions.X;
+							const int32& OutputHeight = OutHeightsArray[OutputIndex]; // Current height stored in Output Array
+																					  // If the this height is larger than zero AND the output height does not already have a value
+							if (LocalHeight >= 0 && OutputHeight < 0)
+							{
+								const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
+								OutHeightsArray[OutputIndex] = ChunkVoxelZ + LocalHeight;
+							}
+						}
+					}
+				}
+
+			}
+
+		}
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,781 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "BiomeGraph.h"
+
+#include "ChunkUtils.h"
+
+#include "HAL/IConsoleManager.h"
+#include "ScopeLock.h"
+
+namespace
+{
+
+	/* The last program that was compiled, for Aetheria.BiomeGraph.Profile */
+	FBiomeProgramPtr LastCompiled;
+	FCriticalSection LastCompiledMutex;
+
+	/** Piecewise linear curve through Points, which are sorted by X. Flat past both ends. */
+	float EvaluateCurve(const FVector2D* Points, int32 NumPoints, float X)
+	{
+		if (X <= Points[0].X)
+		{
+			return Points[0].Y;
+		}
+
+		for (int32 i = 1; i < NumPoints; ++i)
+		{
+			if (X < Points[i].X)
+			{
+				const float Alpha = (X - Points[i - 1].X) / (Points[i].X - Points[i - 1].X);
+				return Points[i - 1].Y + (Points[i].Y - Points[i - 1].Y) * Alpha;
+			}
+		}
+
+		return Points[NumPoints - 1].Y;
+	}
+
+	int32 CountBits(uint32 Bits)
+	{
+		int32 Count = 0;
+		for (; Bits != 0; Bits &= Bits - 1)
+		{
+			++Count;
+		}
+		return Count;
+	}
+
+	uint32 GetGraphHash(const FBiomeGraph& Graph, int32 Seed)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Seed), GetTypeHash(Graph.SelectorNode));
+
+		for (const FBiomeNode& Node : Graph.Nodes)
+		{
+			Hash = HashCombine(Hash, (uint32)Node.Type);
+			Hash = HashCombine(Hash, GetTypeHash(Node.InputA));
+			Hash = HashCombine(Hash, GetTypeHash(Node.InputB));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Value));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Channel));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Scale));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Octaves));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Frequency));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Lacunarity));
+			Hash = HashCombine(Hash, GetTypeHash(Node.Persistence));
+			Hash = HashCombine(Hash, (uint32)Node.bIgnoreZ);
+			for (const FVector2D& Point : Node.CurvePoints)
+			{
+				Hash = HashCombine(Hash, HashCombine(GetTypeHash(Point.X), GetTypeHash(Point.Y)));
+			}
+		}
+
+		for (const FBiome& Biome : Graph.Biomes)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Biome.MaxSelector));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.DensityNode));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.SurfaceVoxel));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.TreeDensity));
+			for (const FBiomeLayer& Layer : Biome.Layers)
+			{
+				Hash = HashCombine(Hash, HashCombine(GetTypeHash(Layer.MaxDensity), GetTypeHash(Layer.Voxel)));
+			}
+		}
+
+		return Hash;
+	}
+
+	bool IsNodeIndex(const FBiomeGraph& Graph, int32 Index, int32 Before)
+	{
+		return Index >= 0 && Index < Before && Index < Graph.Nodes.Num();
+	}
+
+}
+
+FBiomeProgramPtr FBiomeProgram::Compile(const FBiomeGraph& Graph, int32 Seed, FString& OutError)
+{
+
+	const int32 NumNodes = Graph.Nodes.Num();
+
+	// Validate everything up front, so the rest of the compiler can trust the graph
+	if (Graph.Biomes.Num() == 0 || Graph.Biomes.Num() > 32)
+	{
+		OutError = FString::Printf(TEXT("A biome graph needs 1 - 32 biomes, it has %d"), Graph.Biomes.Num());
+		return FBiomeProgramPtr();
+	}
+
+	if (Graph.SelectorNode != -1 && !IsNodeIndex(Graph, Graph.SelectorNode, NumNodes))
+	{
+		OutError = FString::Printf(TEXT("The selector node %d doesn't exist"), Graph.SelectorNode);
+		return FBiomeProgramPtr();
+	}
+
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		const FBiomeNode& Node = Graph.Nodes[i];
+		switch (Node.Type)
+		{
+		case EBiomeNodeType::Add:
+		case EBiomeNodeType::Multiply:
+		case EBiomeNodeType::Min:
+		case EBiomeNodeType::Max:
+			if (!IsNodeIndex(Graph, Node.InputA, i) || !IsNodeIndex(Graph, Node.InputB, i))
+			{
+				OutError = FString::Printf(TEXT("Node %d reads a node that doesn't come before it"), i);
+				return FBiomeProgramPtr();
+			}
+			break;
+		case EBiomeNodeType::Curve:
+			if (!IsNodeIndex(Graph, Node.InputA, i) || Node.CurvePoints.Num() == 0)
+			{
+				OutError = FString::Printf(TEXT("Curve node %d needs an earlier input and at least one point"), i);
+				return FBiomeProgramPtr();
+			}
+			break;
+		case EBiomeNodeType::Fractal:
+		case EBiomeNodeType::RidgedMulti:
+			if (Node.Octaves < 1)
+			{
+				OutError = FString::Printf(TEXT("Noise node %d needs at least one octave"), i);
+				return FBiomeProgramPtr();
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	for (int32 BiomeIndex = 0; BiomeIndex < Graph.Biomes.Num(); ++BiomeIndex)
+	{
+		const FBiome& Biome = Graph.Biomes[BiomeIndex];
+		if (!IsNodeIndex(Graph, Biome.DensityNode, NumNodes))
+		{
+			OutError = FString::Printf(TEXT("Biome %d has no density node"), BiomeIndex);
+			return FBiomeProgramPtr();
+		}
+
+		bool bValidVoxels = Biome.SurfaceVoxel >= 0 && Biome.SurfaceVoxel <= MAX_uint8;
+		for (const FBiomeLayer& Layer : Biome.Layers)
+		{
+			bValidVoxels &= Layer.Voxel >= 0 && Layer.Voxel <= MAX_uint8;
+		}
+		if (!bValidVoxels)
+		{
+			OutError = FString::Printf(TEXT("Biome %d has a voxel outside of 0 - 255"), BiomeIndex);
+			return FBiomeProgramPtr();
+		}
+	}
+
+	// Each node is lowered to one operation on earlier nodes, or to a constant.
+	// Binary operations with a constant side don't read it from a register: adding or multiplying becomes an affine
+	// operation, and chains of affine operations are composed into one. The rounding of composed chains can differ in the last bit.
+	struct FValue
+	{
+		bool bConstant;
+		EOp Op;
+		int32 A;
+		int32 B;
+		float Scale;
+		float Bias;
+		bool bDependsOnZ;
+	};
+
+	TArray<FValue> Values;
+	Values.SetNumUninitialized(NumNodes);
+
+	TArray<FVector2D> SortedCurvePoints;
+
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		const FBiomeNode& Node = Graph.Nodes[i];
+		FValue& Value = Values[i];
+		Value.bConstant = false;
+		Value.A = -1;
+		Value.B = -1;
+		Value.Scale = 1.0f;
+		Value.Bias = 0.0f;
+		Value.bDependsOnZ = false;
+
+		switch (Node.Type)
+		{
+		case EBiomeNodeType::Constant:
+			Value.bConstant = true;
+			Value.Op = EOp::Fill;
+			Value.Bias = Node.Value;
+			break;
+		case EBiomeNodeType::Height:
+			Value.Op = EOp::Height;
+			Value.bDependsOnZ = true;
+			break;
+		case EBiomeNodeType::Fractal:
+		case EBiomeNodeType::RidgedMulti:
+			Value.Op = Node.Type == EBiomeNodeType::Fractal ? EOp::Fractal : EOp::RidgedMulti;
+			Value.bDependsOnZ = !Node.bIgnoreZ;
+			break;
+		case EBiomeNodeType::Add:
+		case EBiomeNodeType::Multiply:
+		case EBiomeNodeType::Min:
+		case EBiomeNodeType::Max:
+		{
+			const FValue& A = Values[Node.InputA];
+			const FValue& B = Values[Node.InputB];
+			if (A.bConstant && B.bConstant)
+			{
+				Value.bConstant = true;
+				Value.Op = EOp::Fill;
+				Value.Bias = Node.Type == EBiomeNodeType::Add ? A.Bias + B.Bias
+					: Node.Type == EBiomeNodeType::Multiply ? A.Bias * B.Bias
+					: Node.Type == EBiomeNodeType::Min ? FMath::Min(A.Bias, B.Bias)
+					: FMath::Max(A.Bias, B.Bias);
+			}
+			else if (A.bConstant || B.bConstant)
+			{
+				const int32 Input = A.bConstant ? Node.InputB : Node.InputA;
+				const float Constant = A.bConstant ? A.Bias : B.Bias;
+
+				if (Node.Type == EBiomeNodeType::Add || Node.Type == EBiomeNodeType::Multiply)
+				{
+					Value.Op = EOp::Affine;
+					Value.Scale = Node.Type == EBiomeNodeType::Multiply ? Constant : 1.0f;
+					Value.Bias = Node.Type == EBiomeNodeType::Add ? Constant : 0.0f;
+
+					const FValue& Inner = Values[Input];
+					if (Inner.Op == EOp::Affine)
+					{
+						Value.A = Inner.A;
+						Value.Bias = Inner.Bias * Value.Scale + Value.Bias;
+						Value.Scale = Inner.Scale * Value.Scale;
+					}
+					else
+					{
+						Value.A = Input;
+					}
+				}
+				else
+				{
+					// B = -1 means the other side is the constant in Bias
+					Value.Op = Node.Type == EBiomeNodeType::Min ? EOp::Min : EOp::Max;
+					Value.A = Input;
+					Value.Bias = Constant;
+				}
+			}
+			else
+			{
+				Value.Op = Node.Type == EBiomeNodeType::Add ? EOp::Add
+					: Node.Type == EBiomeNodeType::Multiply ? EOp::Multiply
+					: Node.Type == EBiomeNodeType::Min ? EOp::Min
+					: EOp::Max;
+				Value.A = Node.InputA;
+				Value.B = Node.InputB;
+			}
+
+			Value.bDependsOnZ = (Value.A >= 0 && Values[Value.A].bDependsOnZ) || (Value.B >= 0 && Values[Value.B].bDependsOnZ);
+			break;
+		}
+		case EBiomeNodeType::Curve:
+		{
+			SortedCurvePoints = Node.CurvePoints;
+			SortedCurvePoints.Sort([](const FVector2D& A, const FVector2D& B) { return A.X < B.X; });
+
+			const FValue& A = Values[Node.InputA];
+			if (A.bConstant)
+			{
+				Value.bConstant = true;
+				Value.Op = EOp::Fill;
+				Value.Bias = EvaluateCurve(SortedCurvePoints.GetData(), SortedCurvePoints.Num(), A.Bias);
+			}
+			else
+			{
+				Value.Op = EOp::Curve;
+				Value.A = Node.InputA;
+				Value.bDependsOnZ = A.bDependsOnZ;
+			}
+			break;
+		}
+		}
+	}
+
+	if (Graph.SelectorNode >= 0 && Values[Graph.SelectorNode].bDependsOnZ)
+	{
+		OutError = TEXT("The selector node depends on z, biomes are picked per column");
+		return FBiomeProgramPtr();
+	}
+
+	// Which biomes need each node, walking back from the roots. Nodes nothing needs are dropped.
+	const uint32 AllBiomes = Graph.Biomes.Num() == 32 ? MAX_uint32 : (1u << Graph.Biomes.Num()) - 1;
+	TArray<uint32> Masks;
+	TArray<bool> SelectorNeeds;
+	TArray<bool> IsRoot;
+	Masks.Init(0, NumNodes);
+	SelectorNeeds.Init(false, NumNodes);
+	IsRoot.Init(false, NumNodes);
+
+	if (Graph.SelectorNode >= 0)
+	{
+		Masks[Graph.SelectorNode] = AllBiomes;
+		SelectorNeeds[Graph.SelectorNode] = true;
+		IsRoot[Graph.SelectorNode] = true;
+	}
+	for (int32 BiomeIndex = 0; BiomeIndex < Graph.Biomes.Num(); ++BiomeIndex)
+	{
+		Masks[Graph.Biomes[BiomeIndex].DensityNode] |= 1u << BiomeIndex;
+		IsRoot[Graph.Biomes[BiomeIndex].DensityNode] = true;
+	}
+
+	for (int32 i = NumNodes - 1; i >= 0; --i)
+	{
+		const FValue& Value = Values[i];
+		const int32 Inputs[] = { Value.A, Value.B };
+		for (const int32 Input : Inputs)
+		{
+			if (Input >= 0)
+			{
+				Masks[Input] |= Masks[i];
+				SelectorNeeds[Input] |= SelectorNeeds[i];
+			}
+		}
+	}
+
+	// Emit the instructions, one register per node that is kept
+	TSharedPtr<FBiomeProgram, ESPMode::ThreadSafe> Program = MakeShareable(new FBiomeProgram());
+	Program->Hash = GetGraphHash(Graph, Seed);
+
+	TArray<int32> Registers;
+	Registers.Init(-1, NumNodes);
+	TArray<int32> GeneratorChannels;
+
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		const FValue& Value = Values[i];
+		const FBiomeNode& Node = Graph.Nodes[i];
+
+		// Constants are folded into whatever reads them, so they are only needed when a biome or the selector reads them directly
+		if (Masks[i] == 0 || (Value.bConstant && !IsRoot[i]))
+		{
+			continue;
+		}
+
+		Registers[i] = Program->NumRegisters++;
+
+		FInstruction Instruction;
+		FMemory::Memzero(Instruction);
+		Instruction.Op = Value.Op;
+		Instruction.Dest = Registers[i];
+		Instruction.A = Value.A >= 0 ? Registers[Value.A] : -1;
+		Instruction.B = Value.B >= 0 ? Registers[Value.B] : -1;
+		Instruction.Scale = Value.Scale;
+		Instruction.Bias = Value.Bias;
+		Instruction.Generator = -1;
+		Instruction.BiomeMask = SelectorNeeds[i] ? AllBiomes : Masks[i];
+		Instruction.Node = i;
+
+		if (Value.Op == EOp::Fractal || Value.Op == EOp::RidgedMulti)
+		{
+			Instruction.Generator = GeneratorChannels.Find(Node.Channel);
+			if (Instruction.Generator == INDEX_NONE)
+			{
+				Instruction.Generator = GeneratorChannels.Add(Node.Channel);
+				Program->Generators.Emplace(Seed, (uint32)Node.Channel);
+			}
+			Instruction.NoiseScale = Node.Scale;
+			Instruction.Octaves = Node.Octaves;
+			Instruction.Frequency = Node.Frequency;
+			Instruction.Lacunarity = Node.Lacunarity;
+			Instruction.Persistence = Node.Persistence;
+			Instruction.bIgnoreZ = Node.bIgnoreZ;
+		}
+		else if (Value.Op == EOp::Curve)
+		{
+			SortedCurvePoints = Node.CurvePoints;
+			SortedCurvePoints.Sort([](const FVector2D& A, const FVector2D& B) { return A.X < B.X; });
+			Instruction.FirstCurvePoint = Program->CurvePoints.Num();
+			Instruction.NumCurvePoints = SortedCurvePoints.Num();
+			Program->CurvePoints.Append(SortedCurvePoints);
+		}
+
+		if (SelectorNeeds[i])
+		{
+			Program->SelectorInstructions.Add(Instruction);
+		}
+		else if (!Value.bDependsOnZ)
+		{
+			Program->ColumnInstructions.Add(Instruction);
+		}
+		else
+		{
+			Program->VoxelInstructions.Add(Instruction);
+		}
+	}
+
+	Program->SelectorRegister = Graph.SelectorNode >= 0 ? Registers[Graph.SelectorNode] : -1;
+
+	for (const FBiome& Biome : Graph.Biomes)
+	{
+		FCompiledBiome& Compiled = *new(Program->Biomes) FCompiledBiome();
+		Compiled.DensityRegister = Registers[Biome.DensityNode];
+		Compiled.Layers = Biome.Layers;
+		Compiled.Layers.Sort([](const FBiomeLayer& A, const FBiomeLayer& B) { return A.MaxDensity < B.MaxDensity; });
+		Compiled.Surface.SurfaceVoxel = (uint8)Biome.SurfaceVoxel;
+		Compiled.Surface.TreeDensity = Biome.TreeDensity;
+
+		Program->BiomeMaxSelectors.Add(Biome.MaxSelector);
+	}
+
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		Program->NodeNames.Add(Graph.Nodes[i].Name.IsNone() ? FString::Printf(TEXT("Node %d"), i) : Graph.Nodes[i].Name.ToString());
+	}
+
+#if BIOME_GRAPH_PROFILING
+	Program->Profile.SetNumZeroed(Program->SelectorInstructions.Num() + Program->ColumnInstructions.Num() + Program->VoxelInstructions.Num() + 1);
+#endif
+
+	{
+		FScopeLock LastCompiledLock(&LastCompiledMutex);
+		LastCompiled = Program;
+	}
+
+	return Program;
+
+}
+
+void FBiomeProgram::Run(const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, TArray<uint8>& OutBiomes, int32& OutAirHeight) const
+{
+
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+	const int32 ColumnOffset = SelectorInstructions.Num();
+	const int32 VoxelOffset = ColumnOffset + ColumnInstructions.Num();
+
+	TArray<float> Registers;
+	Registers.SetNumUninitialized(FMath::Max(NumRegisters, 1) * VoxelsSize.X);
+
+	OutBiomes.SetNumUninitialized(SliceSize);
+	OutAirHeight = 0;
+
+	for (int32 LocalY = 0; LocalY < VoxelsSize.Y; ++LocalY)
+	{
+		const FIntVector3 RowOrigin(VoxelsOrigin.X, VoxelsOrigin.Y + LocalY, VoxelsOrigin.Z);
+
+		// Pick the biome of every column in the row, and only run what those biomes need
+		uint8* const RowBiomes = &OutBiomes[LocalY * VoxelsSize.X];
+		const uint32 RowBiomeMask = SelectRowBiomes(RowOrigin, VoxelsSize.X, Registers.GetData(), RowBiomes);
+
+		RunInstructions(ColumnInstructions, ColumnOffset, RowBiomeMask, RowOrigin, VoxelsSize.X, Registers.GetData());
+
+		for (int32 z = 0; z < VoxelsSize.Z; ++z)
+		{
+			RunInstructions(VoxelInstructions, VoxelOffset, RowBiomeMask, FIntVector3(RowOrigin.X, RowOrigin.Y, VoxelsOrigin.Z + z), VoxelsSize.X, Registers.GetData());
+
+#if BIOME_GRAPH_PROFILING
+			const uint32 StartCycles = FPlatformTime::Cycles();
+#endif
+
+			uint8* const Row = &Voxels[LocalY * VoxelsSize.X + z * SliceSize];
+			bool bAnySolid = false;
+			for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+			{
+				const FCompiledBiome& Biome = Biomes[RowBiomes[LocalX]];
+				const uint8 Voxel = Biome.Classify(Registers[Biome.DensityRegister * VoxelsSize.X + LocalX]);
+
+				Row[LocalX] = Voxel;
+				bAnySolid |= Voxel != 0;
+			}
+
+			if (bAnySolid)
+			{
+				OutAirHeight = FMath::Max(OutAirHeight, z + 1);
+			}
+
+#if BIOME_GRAPH_PROFILING
+			FPlatformAtomics::InterlockedAdd(&Profile.Last().Cycles, (int64)(FPlatformTime::Cycles() - StartCycles));
+			FPlatformAtomics::InterlockedIncrement(&Profile.Last().Rows);
+#endif
+		}
+	}
+
+}
+
+void FBiomeProgram::RunSurface(const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<int32>& OutHeights, TArray<uint8>& OutTopVoxels, TArray<uint8>& OutBiomes) const
+{
+
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+	const int32 ColumnOffset = SelectorInstructions.Num();
+	const int32 VoxelOffset = ColumnOffset + ColumnInstructions.Num();
+
+	TArray<float> Registers;
+	Registers.SetNumUninitialized(FMath::Max(NumRegisters, 1) * VoxelsSize.X);
+
+	OutHeights.SetNumZeroed(SliceSize);
+	OutTopVoxels.SetNumZeroed(SliceSize);
+	OutBiomes.SetNumUninitialized(SliceSize);
+
+	for (int32 LocalY = 0; LocalY < VoxelsSize.Y; ++LocalY)
+	{
+		const FIntVector3 RowOrigin(VoxelsOrigin.X, VoxelsOrigin.Y + LocalY, VoxelsOrigin.Z);
+
+		uint8* const RowBiomes = &OutBiomes[LocalY * VoxelsSize.X];
+		const uint32 RowBiomeMask = SelectRowBiomes(RowOrigin, VoxelsSize.X, Registers.GetData(), RowBiomes);
+
+		RunInstructions(ColumnInstructions, ColumnOffset, RowBiomeMask, RowOrigin, VoxelsSize.X, Registers.GetData());
+
+		int32* const RowHeights = &OutHeights[LocalY * VoxelsSize.X];
+		uint8* const RowTopVoxels = &OutTopVoxels[LocalY * VoxelsSize.X];
+
+		// From the top down, until every column of the row found its ground. The layers under the surface are never evaluated.
+		int32 ColumnsLeft = VoxelsSize.X;
+		for (int32 z = VoxelsSize.Z - 1; z >= 0 && ColumnsLeft > 0; --z)
+		{
+			RunInstructions(VoxelInstructions, VoxelOffset, RowBiomeMask, FIntVector3(RowOrigin.X, RowOrigin.Y, VoxelsOrigin.Z + z), VoxelsSize.X, Registers.GetData());
+
+			for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+			{
+				if (RowHeights[LocalX] != 0)
+				{
+					continue;
+				}
+
+				const FCompiledBiome& Biome = Biomes[RowBiomes[LocalX]];
+				const uint8 Voxel = Biome.Classify(Registers[Biome.DensityRegister * VoxelsSize.X + LocalX]);
+				if (Voxel != 0)
+				{
+					RowHeights[LocalX] = z + 1;
+					RowTopVoxels[LocalX] = Voxel;
+					--ColumnsLeft;
+				}
+			}
+		}
+	}
+
+}
+
+uint32 FBiomeProgram::SelectRowBiomes(const FIntVector3& RowOrigin, int32 Count, float* Registers, uint8* OutRowBiomes) const
+{
+
+	if (SelectorRegister < 0)
+	{
+		FMemory::Memzero(OutRowBiomes, Count);
+		return 1;
+	}
+
+	const uint32 AllBiomes = Biomes.Num() == 32 ? MAX_uint32 : (1u << Biomes.Num()) - 1;
+	RunInstructions(SelectorInstructions, 0, AllBiomes, RowOrigin, Count, Registers);
+
+	uint32 RowBiomeMask = 0;
+	const float* const Selector = &Registers[SelectorRegister * Count];
+	for (int32 LocalX = 0; LocalX < Count; ++LocalX)
+	{
+		int32 Biome = 0;
+		while (Biome < Biomes.Num() - 1 && !(Selector[LocalX] < BiomeMaxSelectors[Biome]))
+		{
+			++Biome;
+		}
+		OutRowBiomes[LocalX] = (uint8)Biome;
+		RowBiomeMask |= 1u << Biome;
+	}
+	return RowBiomeMask;
+
+}
+
+void FBiomeProgram::RunInstructions(const TArray<FInstruction>& Instructions, int32 ProfileOffset, uint32 RowBiomeMask, const FIntVector3& RowOrigin, int32 Count, float* Registers) const
+{
+
+	for (int32 InstructionIndex = 0; InstructionIndex < Instructions.Num(); ++InstructionIndex)
+	{
+		const FInstruction& Instruction = Instructions[InstructionIndex];
+		if ((Instruction.BiomeMask & RowBiomeMask) == 0)
+		{
+			continue;
+		}
+
+#if BIOME_GRAPH_PROFILING
+		const uint32 StartCycles = FPlatformTime::Cycles();
+#endif
+
+		float* const Dest = Registers + Instruction.Dest * Count;
+		const float* const A = Instruction.A >= 0 ? Registers + Instruction.A * Count : nullptr;
+		const float* const B = Instruction.B >= 0 ? Registers + Instruction.B * Count : nullptr;
+
+		switch (Instruction.Op)
+		{
+		case EOp::Fill:
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = Instruction.Bias;
+			}
+			break;
+		case EOp::Height:
+		{
+			const float Height = (float)RowOrigin.Z / (float)WORLD_HEIGHT;
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = Height;
+			}
+			break;
+		}
+		case EOp::Fractal:
+		case EOp::RidgedMulti:
+		{
+			const FNoiseGenerator& Generator = Generators[Instruction.Generator];
+			const double StartX = (double)RowOrigin.X * Instruction.NoiseScale;
+			const double Y = (double)RowOrigin.Y * Instruction.NoiseScale;
+			const double Z = Instruction.bIgnoreZ ? 0.0 : (double)RowOrigin.Z * Instruction.NoiseScale;
+			if (Instruction.Op == EOp::Fractal)
+			{
+				Generator.Fractal3DRow(StartX, Instruction.NoiseScale, Y, Z, Count, Dest, Instruction.Octaves, Instruction.Frequency, Instruction.Lacunarity, Instruction.Persistence);
+			}
+			else
+			{
+				Generator.RidgedMulti3DRow(StartX, Instruction.NoiseScale, Y, Z, Count, Dest, Instruction.Octaves, Instruction.Frequency, Instruction.Lacunarity);
+			}
+			break;
+		}
+		case EOp::Add:
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = A[i] + B[i];
+			}
+			break;
+		case EOp::Multiply:
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = A[i] * B[i];
+			}
+			break;
+		case EOp::Min:
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = FMath::Min(A[i], B != nullptr ? B[i] : Instruction.Bias);
+			}
+			break;
+		case EOp::Max:
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = FMath::Max(A[i], B != nullptr ? B[i] : Instruction.Bias);
+			}
+			break;
+		case EOp::Affine:
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = A[i] * Instruction.Scale + Instruction.Bias;
+			}
+			break;
+		case EOp::Curve:
+		{
+			const FVector2D* const Points = &CurvePoints[Instruction.FirstCurvePoint];
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Dest[i] = EvaluateCurve(Points, Instruction.NumCurvePoints, A[i]);
+			}
+			break;
+		}
+		}
+
+#if BIOME_GRAPH_PROFILING
+		FInstructionProfile& InstructionProfile = Profile[ProfileOffset + InstructionIndex];
+		FPlatformAtomics::InterlockedAdd(&InstructionProfile.Cycles, (int64)(FPlatformTime::Cycles() - StartCycles));
+		FPlatformAtomics::InterlockedIncrement(&InstructionProfile.Rows);
+#endif
+	}
+
+}
+
+void FBiomeProgram::LogProfile() const
+{
+
+	static const TCHAR* const OpNames[] = { TEXT("Fill"), TEXT("Height"), TEXT("Fractal"), TEXT("RidgedMulti"), TEXT("Add"), TEXT("Multiply"), TEXT("Min"), TEXT("Max"), TEXT("Affine"), TEXT("Curve") };
+
+	UE_LOG(LogStats, Log, TEXT("Biome Program: %d biomes, %d registers, %d noise generators"), Biomes.Num(), NumRegisters, Generators.Num());
+
+	const TArray<FInstruction>* const Lists[] = { &SelectorInstructions, &ColumnInstructions, &VoxelInstructions };
+	const TCHAR* const ListNames[] = { TEXT("Selector"), TEXT("Column"), TEXT("Voxel") };
+
+#if BIOME_GRAPH_PROFILING
+	// The cost of an instruction is split evenly between the biomes that need it. The selector is paid by every biome.
+	TArray<double> BiomeMilliseconds;
+	BiomeMilliseconds.Init(0.0, Biomes.Num());
+	int32 ProfileIndex = 0;
+#endif
+
+	for (int32 ListIndex = 0; ListIndex < 3; ++ListIndex)
+	{
+		UE_LOG(LogStats, Log, TEXT("  %s instructions: %d"), ListNames[ListIndex], Lists[ListIndex]->Num());
+
+		for (const FInstruction& Instruction : *Lists[ListIndex])
+		{
+#if BIOME_GRAPH_PROFILING
+			const FInstructionProfile& InstructionProfile = Profile[ProfileIndex++];
+			const double Milliseconds = InstructionProfile.Cycles * FPlatformTime::GetSecondsPerCycle() * 1000.0;
+			UE_LOG(LogStats, Log, TEXT("    r%d = %s (%s): %.2f ms over %lld rows"), Instruction.Dest, OpNames[(int32)Instruction.Op], *NodeNames[Instruction.Node], Milliseconds, InstructionProfile.Rows);
+
+			const int32 NumUsers = CountBits(Instruction.BiomeMask);
+			for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+			{
+				if (Instruction.BiomeMask & (1u << Biome))
+				{
+					BiomeMilliseconds[Biome] += Milliseconds / NumUsers;
+				}
+			}
+#else
+			UE_LOG(LogStats, Log, TEXT("    r%d = %s (%s), biomes 0x%x"), Instruction.Dest, OpNames[(int32)Instruction.Op], *NodeNames[Instruction.Node], Instruction.BiomeMask);
+#endif
+		}
+	}
+
+#if BIOME_GRAPH_PROFILING
+	const FInstructionProfile& ClassifyProfile = Profile.Last();
+	UE_LOG(LogStats, Log, TEXT("  Classifying voxels: %.2f ms over %lld rows"), ClassifyProfile.Cycles * FPlatformTime::GetSecondsPerCycle() * 1000.0, ClassifyProfile.Rows);
+
+	for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+	{
+		UE_LOG(LogStats, Log, TEXT("  Biome %d: %.2f ms of noise and math"), Biome, BiomeMilliseconds[Biome]);
+	}
+#else
+	UE_LOG(LogStats, Log, TEXT("  Build with BIOME_GRAPH_PROFILING 1 to time the instructions"));
+#endif
+
+}
+
+void FBiomeProgram::ResetProfile() const
+{
+#if BIOME_GRAPH_PROFILING
+	for (FInstructionProfile& InstructionProfile : Profile)
+	{
+		FPlatformAtomics::InterlockedExchange(&InstructionProfile.Cycles, 0);
+		FPlatformAtomics::InterlockedExchange(&InstructionProfile.Rows, 0);
+	}
+#endif
+}
+
+FBiomeProgramPtr FBiomeProgram::GetLastCompiled()
+{
+	FScopeLock LastCompiledLock(&LastCompiledMutex);
+	return LastCompiled;
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+
+	void LogBiomeGraphProfile(const TArray<FString>& Args)
+	{
+		const FBiomeProgramPtr Program = FBiomeProgram::GetLastCompiled();
+		if (!Program.IsValid())
+		{
+			UE_LOG(LogStats, Log, TEXT("No biome graph has been compiled"));
+			return;
+		}
+
+		Program->LogProfile();
+
+		if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+		{
+			Program->ResetProfile();
+		}
+	}
+
+	FAutoConsoleCommand LogBiomeGraphProfileCommand(
+		TEXT("Aetheria.BiomeGraph.Profile"),
+		TEXT("Logs the instructions of the last compiled biome graph, and the time spent in each one and each biome in profiling builds. Usage: Aetheria.BiomeGraph.Profile [Reset]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&LogBiomeGraphProfile));
+
+}
+
+#endif
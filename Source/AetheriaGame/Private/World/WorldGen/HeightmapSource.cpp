@@ -0,0 +1,274 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "HeightmapSource.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "ScopeLock.h"
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+namespace
+{
+
+	TAutoConsoleVariable<int32> CVarHeightmapCacheMB(
+		TEXT("Aetheria.Heightmap.CacheMB"),
+		32,
+		TEXT("Memory in MB the tiles of the heightmap file can take, the least recently read ones are dropped first. At least one tile is always kept."));
+
+	int64 GetMaxBytes()
+	{
+		return (int64)FMath::Max(0, CVarHeightmapCacheMB.GetValueOnAnyThread()) * 1024 * 1024;
+	}
+
+	FORCEINLINE int32 GetTileBytes(const TArray<uint16>& Tile)
+	{
+		return Tile.Num() * sizeof(uint16);
+	}
+
+}
+
+FHeightmapSource::FHeightmapSource(IFileHandle* InFileHandle, int32 InWidth, int32 InHeight, uint32 InHash)
+	: FileHandle(InFileHandle), Width(InWidth), Height(InHeight), Hash(InHash), UseCounter(0)
+{
+}
+
+FHeightmapSource::~FHeightmapSource()
+{
+	delete FileHandle;
+}
+
+FHeightmapSourcePtr FHeightmapSource::Open(const FString& Filename, int32 RawWidth, int32 RawHeight, FString& OutError)
+{
+
+	FString FullFilename = FPaths::IsRelative(Filename) ? FPaths::Combine(FPaths::GameDir(), Filename) : Filename;
+	FullFilename = FPaths::ConvertRelativePathToFull(FullFilename);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FullFilename))
+	{
+		OutError = FString::Printf(TEXT("%s doesn't exist"), *FullFilename);
+		return FHeightmapSourcePtr();
+	}
+
+	uint32 FileHash = GetTypeHash(FullFilename);
+	FileHash = HashCombine(FileHash, GetTypeHash(PlatformFile.GetTimeStamp(*FullFilename).GetTicks()));
+
+	FString RawFilename = FullFilename;
+	if (FPaths::GetExtension(FullFilename) == TEXT("png"))
+	{
+		if (!DecodePNG(FullFilename, RawFilename, RawWidth, RawHeight, OutError))
+		{
+			return FHeightmapSourcePtr();
+		}
+	}
+
+	const int64 FileSize = PlatformFile.FileSize(*RawFilename);
+
+	// A raw file without dimensions is taken to be square, like the ones most terrain tools export
+	if (RawWidth <= 0 || RawHeight <= 0)
+	{
+		RawWidth = RawHeight = FMath::FloorToInt(FMath::Sqrt((double)(FileSize / sizeof(uint16))));
+	}
+
+	if (RawWidth <= 0 || FileSize != (int64)RawWidth * RawHeight * sizeof(uint16))
+	{
+		OutError = FString::Printf(TEXT("%s has %lld bytes, a %dx%d 16 bit heightmap has %lld"), *RawFilename, FileSize, RawWidth, RawHeight, (int64)RawWidth * RawHeight * sizeof(uint16));
+		return FHeightmapSourcePtr();
+	}
+
+	IFileHandle* const FileHandle = PlatformFile.OpenRead(*RawFilename);
+	if (FileHandle == nullptr)
+	{
+		OutError = FString::Printf(TEXT("%s can't be opened"), *RawFilename);
+		return FHeightmapSourcePtr();
+	}
+
+	FileHash = HashCombine(FileHash, GetTypeHash(RawWidth));
+	FileHash = HashCombine(FileHash, GetTypeHash(RawHeight));
+
+	return MakeShareable(new FHeightmapSource(FileHandle, RawWidth, RawHeight, FileHash));
+
+}
+
+bool FHeightmapSource::DecodePNG(const FString& Filename, FString& OutRawFilename, int32& OutWidth, int32& OutHeight, FString& OutError)
+{
+
+	TArray<uint8> CompressedData;
+	if (!FFileHelper::LoadFileToArray(CompressedData, *Filename))
+	{
+		OutError = FString::Printf(TEXT("%s can't be read"), *Filename);
+		return false;
+	}
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	const IImageWrapperPtr ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(CompressedData.GetData(), CompressedData.Num()))
+	{
+		OutError = FString::Printf(TEXT("%s isn't a valid PNG"), *Filename);
+		return false;
+	}
+
+	OutWidth = ImageWrapper->GetWidth();
+	OutHeight = ImageWrapper->GetHeight();
+
+	// The decoded file is named after the PNG's time stamp, so editing the PNG decodes it again
+	const FDateTime TimeStamp = FPlatformFileManager::Get().GetPlatformFile().GetTimeStamp(*Filename);
+	OutRawFilename = FPaths::Combine(FPaths::GameSavedDir(), TEXT("Heightmaps"),
+		FString::Printf(TEXT("%s_%dx%d_%lld.r16"), *FPaths::GetBaseFilename(Filename), OutWidth, OutHeight, TimeStamp.GetTicks()));
+	OutRawFilename = FPaths::ConvertRelativePathToFull(OutRawFilename);
+
+	if (FPaths::FileExists(OutRawFilename))
+	{
+		return true;
+	}
+
+	// The wrapper swaps the PNG's big endian samples into the platform's order
+	const TArray<uint8>* RawData = nullptr;
+	if (!ImageWrapper->GetRaw(ERGBFormat::Gray, 16, RawData) || RawData == nullptr)
+	{
+		OutError = FString::Printf(TEXT("%s can't be decoded as 16 bit grayscale"), *Filename);
+		return false;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(*RawData, *OutRawFilename))
+	{
+		OutError = FString::Printf(TEXT("%s can't be written"), *OutRawFilename);
+		return false;
+	}
+
+	UE_LOG(LogStats, Log, TEXT("Decoded heightmap %s into %s"), *Filename, *OutRawFilename);
+	return true;
+
+}
+
+void FHeightmapSource::ReadRect(int32 MinX, int32 MinY, int32 SizeX, int32 SizeY, uint16* OutSamples) const
+{
+
+	// A rectangle of a column only touches one to four tiles, the last one is kept so the lock is rarely taken
+	FIntPoint LastTileCoord(-1, -1);
+	FTilePtr Tile;
+	int32 TileWidth = 0;
+
+	for (int32 LocalY = 0; LocalY < SizeY; ++LocalY)
+	{
+		const int32 SampleY = FMath::Clamp(MinY + LocalY, 0, Height - 1);
+
+		for (int32 LocalX = 0; LocalX < SizeX; ++LocalX)
+		{
+			const int32 SampleX = FMath::Clamp(MinX + LocalX, 0, Width - 1);
+
+			const FIntPoint TileCoord(SampleX / TILE_SIZE, SampleY / TILE_SIZE);
+			if (TileCoord != LastTileCoord)
+			{
+				Tile = GetTile(TileCoord);
+				TileWidth = FMath::Min(TILE_SIZE, Width - TileCoord.X * TILE_SIZE);
+				LastTileCoord = TileCoord;
+			}
+
+			OutSamples[LocalX + LocalY * SizeX] = (*Tile)[(SampleX % TILE_SIZE) + (SampleY % TILE_SIZE) * TileWidth];
+		}
+	}
+
+}
+
+int64 FHeightmapSource::GetCachedBytes() const
+{
+	FScopeLock TilesLock(&TilesMutex);
+
+	int64 NumBytes = 0;
+	for (const TPair<FIntPoint, FCachedTile>& Pair : Tiles)
+	{
+		NumBytes += GetTileBytes(*Pair.Value.Samples);
+	}
+	return NumBytes;
+}
+
+FHeightmapSource::FTilePtr FHeightmapSource::GetTile(const FIntPoint& TileCoord) const
+{
+
+	{
+		FScopeLock TilesLock(&TilesMutex);
+
+		FCachedTile* const CachedTile = Tiles.Find(TileCoord);
+		if (CachedTile != nullptr)
+		{
+			CachedTile->LastUse = ++UseCounter;
+			return CachedTile->Samples;
+		}
+	}
+
+	// Read without holding the cache, so the threads that only need cached tiles don't wait on the disk
+	const FTilePtr NewTile = ReadTile(TileCoord);
+
+	FScopeLock TilesLock(&TilesMutex);
+
+	// Another thread read the same tile at the same time, they are identical
+	FCachedTile* const CachedTile = Tiles.Find(TileCoord);
+	if (CachedTile != nullptr)
+	{
+		CachedTile->LastUse = ++UseCounter;
+		return CachedTile->Samples;
+	}
+
+	// There are only a few hundred tiles, so the oldest one is found with a linear search
+	const int64 MaxBytes = GetMaxBytes() - GetTileBytes(*NewTile);
+	int64 NumBytes = 0;
+	for (const TPair<FIntPoint, FCachedTile>& Pair : Tiles)
+	{
+		NumBytes += GetTileBytes(*Pair.Value.Samples);
+	}
+	while (NumBytes > MaxBytes && Tiles.Num() > 0)
+	{
+		const FIntPoint* OldestCoord = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<FIntPoint, FCachedTile>& Pair : Tiles)
+		{
+			if (Pair.Value.LastUse < OldestUse)
+			{
+				OldestUse = Pair.Value.LastUse;
+				OldestCoord = &Pair.Key;
+			}
+		}
+
+		NumBytes -= GetTileBytes(*Tiles[*OldestCoord].Samples);
+		Tiles.Remove(FIntPoint(*OldestCoord));
+	}
+
+	FCachedTile& Added = Tiles.Add(TileCoord);
+	Added.Samples = NewTile;
+	Added.LastUse = ++UseCounter;
+	return NewTile;
+
+}
+
+FHeightmapSource::FTilePtr FHeightmapSource::ReadTile(const FIntPoint& TileCoord) const
+{
+
+	const int32 MinX = TileCoord.X * TILE_SIZE;
+	const int32 MinY = TileCoord.Y * TILE_SIZE;
+	const int32 TileWidth = FMath::Min(TILE_SIZE, Width - MinX);
+	const int32 TileHeight = FMath::Min(TILE_SIZE, Height - MinY);
+
+	TArray<uint16>* const Samples = new TArray<uint16>();
+	Samples->SetNumZeroed(TileWidth * TileHeight);
+
+	FScopeLock FileLock(&FileMutex);
+
+	// Every row of the tile is contiguous in the file, the rows of a tile are Width samples apart
+	for (int32 LocalY = 0; LocalY < TileHeight; ++LocalY)
+	{
+		const int64 Offset = ((int64)(MinY + LocalY) * Width + MinX) * sizeof(uint16);
+		if (!FileHandle->Seek(Offset) || !FileHandle->Read((uint8*)&(*Samples)[LocalY * TileWidth], TileWidth * sizeof(uint16)))
+		{
+			UE_LOG(LogStats, Warning, TEXT("Failed to read row %d of the heightmap, it is left at 0"), MinY + LocalY);
+		}
+	}
+
+	return FTilePtr(Samples);
+
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "NoiseGenerator.h"
+
+namespace
+{
+
+	/* Random order of 0 - 255, repeated twice */
+	void ShuffleTable(FRandomStream& Random, int32* Table)
+	{
+		for (int32 i = 0; i < 256; ++i)
+		{
+			Table[i] = i;
+		}
+
+		for (int32 i = 255; i > 0; --i)
+		{
+			Swap(Table[i], Table[Random.RandRange(0, i)]);
+		}
+
+		FMemory::Memcpy(Table + 256, Table, 256 * sizeof(int32));
+	}
+
+	/*
+	The octaves of a row of points StartX + i * StepX.
+	The points of every octave are moved by a lattice point next to the row, picked so that its coordinates add up to a multiple of 3.
+	Moving by such a point moves the simplex grid onto itself, so only the cell indices change and they are put back with the offsets.
+	The local coordinates are computed in double and are smaller than the row is long, so they lose nothing when they are made floats.
+	*/
+	struct FRowOctaves
+	{
+		TArray<float, TInlineAllocator<8 * 64>> Coordinates;
+		TArray<FNoiseRowOctave, TInlineAllocator<8>> Octaves;
+
+		FRowOctaves(double StartX, double StepX, double Y, double Z, int32 Count, int32 NumOctaves, float Frequency, float Lacunarity, float Persistence)
+		{
+			NumOctaves = FMath::Max(NumOctaves, 0);
+			Coordinates.SetNumUninitialized(Count * NumOctaves);
+			Octaves.SetNumUninitialized(NumOctaves);
+
+			double OctaveFrequency = Frequency;
+			float Amplitude = 1.0f;
+			for (int32 Octave = 0; Octave < NumOctaves; ++Octave)
+			{
+				int64 LatticeX = (int64)FMath::FloorToDouble(StartX * OctaveFrequency);
+				const int64 LatticeY = (int64)FMath::FloorToDouble(Y * OctaveFrequency);
+				const int64 LatticeZ = (int64)FMath::FloorToDouble(Z * OctaveFrequency);
+
+				int64 Remainder = (LatticeX + LatticeY + LatticeZ) % 3;
+				if (Remainder < 0)
+				{
+					Remainder += 3;
+				}
+				LatticeX -= Remainder;
+
+				// The skewed cell of a point moves by the lattice point plus a third of its coordinate sum in every axis
+				const int64 Skew = (LatticeX + LatticeY + LatticeZ) / 3;
+
+				float* X = &Coordinates[Octave * Count];
+				for (int32 i = 0; i < Count; ++i)
+				{
+					X[i] = (float)((StartX + i * StepX) * OctaveFrequency - LatticeX);
+				}
+
+				FNoiseRowOctave& Row = Octaves[Octave];
+				Row.X = X;
+				Row.Y = (float)(Y * OctaveFrequency - LatticeY);
+				Row.Z = (float)(Z * OctaveFrequency - LatticeZ);
+				Row.OffsetX = (int32)((LatticeX + Skew) & 0xff);
+				Row.OffsetY = (int32)((LatticeY + Skew) & 0xff);
+				Row.OffsetZ = (int32)((LatticeZ + Skew) & 0xff);
+				Row.Amplitude = Amplitude;
+
+				OctaveFrequency *= Lacunarity;
+				Amplitude *= Persistence;
+			}
+		}
+	};
+
+}
+
+FNoiseGenerator::FNoiseGenerator()
+	: Tables(FSimplexNoiseBatch::GetDefaultTables())
+{
+}
+
+FNoiseGenerator::FNoiseGenerator(int32 Seed, uint32 Channel)
+{
+	FRandomStream Random((int32)HashCombine(GetTypeHash(Seed), GetTypeHash(Channel)));
+	ShuffleTable(Random, Tables.Perm);
+	ShuffleTable(Random, Tables.Gradients);
+}
+
+float FNoiseGenerator::Noise3D(double x, double y, double z) const
+{
+	return Fractal3D(x, y, z, 1, 1.0f, 2.0f, 0.5f);
+}
+
+float FNoiseGenerator::Fractal3D(double x, double y, double z, int32 Octaves, float Frequency, float Lacunarity, float Persistence) const
+{
+	float Value;
+	Fractal3DRow(x, 0.0, y, z, 1, &Value, Octaves, Frequency, Lacunarity, Persistence);
+	return Value;
+}
+
+float FNoiseGenerator::RidgedMulti3D(double x, double y, double z, int32 Octaves, float Frequency, float Lacunarity) const
+{
+	float Value;
+	RidgedMulti3DRow(x, 0.0, y, z, 1, &Value, Octaves, Frequency, Lacunarity);
+	return Value;
+}
+
+void FNoiseGenerator::Fractal3DRow(double StartX, double StepX, double Y, double Z, int32 Count, float* Out, int32 Octaves, float Frequency, float Lacunarity, float Persistence) const
+{
+	const FRowOctaves Row(StartX, StepX, Y, Z, Count, Octaves, Frequency, Lacunarity, Persistence);
+	FSimplexNoiseBatch::Fractal3DOctaves(Tables, Row.Octaves.GetData(), Row.Octaves.Num(), Count, Out);
+}
+
+int32 FNoiseGenerator::Fractal3DRowBands(double StartX, double StepX, double Y, double Z, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper, int32 Octaves, float Frequency, float Lacunarity, float Persistence) const
+{
+	const FRowOctaves Row(StartX, StepX, Y, Z, Count, Octaves, Frequency, Lacunarity, Persistence);
+	return FSimplexNoiseBatch::Fractal3DOctavesBands(Tables, Row.Octaves.GetData(), Row.Octaves.Num(), Count, OutBands, Offset, Scale, Lower, Upper);
+}
+
+void FNoiseGenerator::RidgedMulti3DRow(double StartX, double StepX, double Y, double Z, int32 Count, float* Out, int32 Octaves, float Frequency, float Lacunarity) const
+{
+	const FRowOctaves Row(StartX, StepX, Y, Z, Count, Octaves, Frequency, Lacunarity, 1.0f / Lacunarity);
+	FSimplexNoiseBatch::RidgedMulti3DOctaves(Tables, Row.Octaves.GetData(), Row.Octaves.Num(), Count, Out);
+}
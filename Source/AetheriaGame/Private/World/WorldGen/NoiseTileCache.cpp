@@ -0,0 +1,254 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "NoiseTileCache.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "ScopeLock.h"
+
+namespace
+{
+
+	TAutoConsoleVariable<int32> CVarNoiseTileCacheMaxMB(
+		TEXT("Aetheria.NoiseTileCache.MaxMB"),
+		64,
+		TEXT("Memory in MB the terrain generator can keep noise tiles in, so neighbor columns don't evaluate the same noise twice. 0 turns the cache off."));
+
+	int64 GetMaxBytes()
+	{
+		return (int64)FMath::Max(0, CVarNoiseTileCacheMaxMB.GetValueOnAnyThread()) * 1024 * 1024;
+	}
+
+	// Changed whenever FNoiseTile or the way it is written changes, older files are ignored
+	const uint32 TILE_FILE_MAGIC = 0x41544E54;
+	const int32 TILE_FILE_VERSION = 1;
+
+	void SerializeTile(FArchive& Ar, FNoiseTileKey& Key, FNoiseTile& Tile)
+	{
+		Ar << Key.Seed << Key.ParameterHash << Key.TileCoord.X << Key.TileCoord.Y;
+		Ar << Tile.Origin.X << Tile.Origin.Y << Tile.Origin.Z;
+		Ar << Tile.Size.X << Tile.Size.Y << Tile.Size.Z;
+		Ar << Tile.Voxels << Tile.Biomes << Tile.TreeProbs << Tile.ColorNoises << Tile.AirHeight;
+	}
+
+}
+
+FNoiseTileCache::FNoiseTileCache()
+	: UseCounter(0), NumBytes(0), Hits(0), Misses(0), Evictions(0)
+{
+}
+
+FNoiseTileCache& FNoiseTileCache::Get()
+{
+	static FNoiseTileCache Cache;
+	return Cache;
+}
+
+bool FNoiseTileCache::IsEnabled()
+{
+	return GetMaxBytes() > 0;
+}
+
+FNoiseTilePtr FNoiseTileCache::Find(const FNoiseTileKey& Key)
+{
+	FScopeLock CacheLock(&CacheMutex);
+
+	FEntry* const Entry = Entries.Find(Key);
+	if (Entry == nullptr)
+	{
+		++Misses;
+		return FNoiseTilePtr();
+	}
+
+	++Hits;
+	Entry->LastUse = ++UseCounter;
+	return Entry->Tile;
+}
+
+void FNoiseTileCache::Add(const FNoiseTileKey& Key, const FNoiseTilePtr& Tile)
+{
+	const int64 MaxBytes = GetMaxBytes();
+	const int64 TileBytes = Tile->GetAllocatedSize();
+
+	FScopeLock CacheLock(&CacheMutex);
+
+	// Another thread generated the same tile at the same time, they are identical
+	if (Entries.Contains(Key) || TileBytes > MaxBytes)
+	{
+		return;
+	}
+
+	EvictToFit(MaxBytes - TileBytes);
+
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Tile = Tile;
+	Entry.NumBytes = TileBytes;
+	Entry.LastUse = ++UseCounter;
+	NumBytes += TileBytes;
+}
+
+void FNoiseTileCache::Empty()
+{
+	FScopeLock CacheLock(&CacheMutex);
+
+	Entries.Empty();
+	NumBytes = 0;
+}
+
+int32 FNoiseTileCache::SaveTiles(const FString& Filename, const TArray<FNoiseTileKey>& Keys) const
+{
+
+	TArray<FNoiseTilePtr> Tiles;
+	TArray<FNoiseTileKey> TileKeys;
+	{
+		FScopeLock CacheLock(&CacheMutex);
+
+		for (const FNoiseTileKey& Key : Keys)
+		{
+			const FEntry* const Entry = Entries.Find(Key);
+			if (Entry != nullptr)
+			{
+				Tiles.Add(Entry->Tile);
+				TileKeys.Add(Key);
+			}
+		}
+	}
+
+	// The tiles are immutable, so they are written without holding the cache
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	uint32 Magic = TILE_FILE_MAGIC;
+	int32 Version = TILE_FILE_VERSION;
+	int32 NumTiles = Tiles.Num();
+	Writer << Magic << Version << NumTiles;
+
+	for (int32 i = 0; i < Tiles.Num(); ++i)
+	{
+		FNoiseTile Tile = *Tiles[i];
+		SerializeTile(Writer, TileKeys[i], Tile);
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Filename))
+	{
+		UE_LOG(LogStats, Warning, TEXT("%s can't be written"), *Filename);
+		return 0;
+	}
+	return NumTiles;
+
+}
+
+int32 FNoiseTileCache::LoadTiles(const FString& Filename)
+{
+
+	TArray<uint8> Bytes;
+	if (!IsEnabled() || !FFileHelper::LoadFileToArray(Bytes, *Filename, FILEREAD_Silent))
+	{
+		return 0;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 NumTiles = 0;
+	Reader << Magic << Version << NumTiles;
+	if (Reader.IsError() || Magic != TILE_FILE_MAGIC || Version != TILE_FILE_VERSION)
+	{
+		return 0;
+	}
+
+	int32 NumAdded = 0;
+	for (int32 i = 0; i < NumTiles; ++i)
+	{
+		FNoiseTileKey Key;
+		FNoiseTile* const Tile = new FNoiseTile();
+		SerializeTile(Reader, Key, *Tile);
+
+		// A truncated file keeps the tiles read before the end
+		if (Reader.IsError())
+		{
+			delete Tile;
+			break;
+		}
+
+		Add(Key, MakeShareable(Tile));
+		++NumAdded;
+	}
+	return NumAdded;
+
+}
+
+FNoiseTileCache::FStats FNoiseTileCache::GetStats() const
+{
+	FScopeLock CacheLock(&CacheMutex);
+
+	FStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Evictions = Evictions;
+	Stats.NumTiles = Entries.Num();
+	Stats.NumBytes = NumBytes;
+	return Stats;
+}
+
+void FNoiseTileCache::ResetStats()
+{
+	FScopeLock CacheLock(&CacheMutex);
+
+	Hits = 0;
+	Misses = 0;
+	Evictions = 0;
+}
+
+void FNoiseTileCache::EvictToFit(int64 MaxBytes)
+{
+	// There are only a few hundred tiles, so the oldest one is found with a linear search
+	while (NumBytes > MaxBytes && Entries.Num() > 0)
+	{
+		const FNoiseTileKey* OldestKey = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<FNoiseTileKey, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUse < OldestUse)
+			{
+				OldestUse = Pair.Value.LastUse;
+				OldestKey = &Pair.Key;
+			}
+		}
+
+		NumBytes -= Entries[*OldestKey].NumBytes;
+		Entries.Remove(FNoiseTileKey(*OldestKey));
+		++Evictions;
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+
+	void LogNoiseTileCacheStats(const TArray<FString>& Args)
+	{
+		FNoiseTileCache& Cache = FNoiseTileCache::Get();
+		const FNoiseTileCache::FStats Stats = Cache.GetStats();
+
+		UE_LOG(LogStats, Log, TEXT("Noise Tile Cache: %d tiles, %.1f MB of %d MB"), Stats.NumTiles, Stats.NumBytes / (1024.0 * 1024.0), CVarNoiseTileCacheMaxMB.GetValueOnAnyThread());
+		UE_LOG(LogStats, Log, TEXT("    %lld hits, %lld misses, %.1f%% hit rate, %lld evictions"), Stats.Hits, Stats.Misses, Stats.GetHitRate() * 100.0, Stats.Evictions);
+
+		if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+		{
+			Cache.ResetStats();
+		}
+	}
+
+	FAutoConsoleCommand LogNoiseTileCacheStatsCommand(
+		TEXT("Aetheria.NoiseTileCache.Stats"),
+		TEXT("Logs the size and hit rate of the noise tile cache. Usage: Aetheria.NoiseTileCache.Stats [Reset]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&LogNoiseTileCacheStats));
+
+}
+
+#endif
@@ -0,0 +1,360 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "SimplexNoiseBatch.h"
+
+#include "SimplexNoiseBatchKernel.h"
+
+#include "CommandLine.h"
+#include "Parse.h"
+
+#if SIMPLEX_NOISE_BATCH_X86
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace SimplexNoiseBatchScalar
+{
+
+	/* 1 lane, the fallback for platforms without any of the other instruction sets */
+	struct FNoiseVectorScalar
+	{
+		typedef float FFloat;
+		typedef int32 FInt;
+		typedef bool FMask;
+
+		enum { Width = 1 };
+
+		static FORCEINLINE FFloat Load(const float* P) { return *P; }
+		static FORCEINLINE void Store(float* P, const FFloat& A) { *P = A; }
+		static FORCEINLINE FFloat Set(float F) { return F; }
+		static FORCEINLINE FFloat Add(const FFloat& A, const FFloat& B) { return A + B; }
+		static FORCEINLINE FFloat Sub(const FFloat& A, const FFloat& B) { return A - B; }
+		static FORCEINLINE FFloat Mul(const FFloat& A, const FFloat& B) { return A * B; }
+		static FORCEINLINE FFloat Min(const FFloat& A, const FFloat& B) { return A < B ? A : B; }
+		static FORCEINLINE FFloat Max(const FFloat& A, const FFloat& B) { return A > B ? A : B; }
+		static FORCEINLINE FFloat Abs(const FFloat& A) { return FMath::Abs(A); }
+		static FORCEINLINE FFloat FlipSign(const FFloat& A, const FInt& SignBits) { return SignBits != 0 ? -A : A; }
+
+		static FORCEINLINE FMask GreaterThan(const FFloat& A, const FFloat& B) { return A > B; }
+		static FORCEINLINE FMask GreaterEqual(const FFloat& A, const FFloat& B) { return A >= B; }
+		static FORCEINLINE FMask LessThan(const FFloat& A, const FFloat& B) { return A < B; }
+		static FORCEINLINE FFloat Select(const FMask& Mask, const FFloat& A, const FFloat& B) { return Mask ? A : B; }
+
+		static FORCEINLINE FMask MaskAnd(const FMask& A, const FMask& B) { return A && B; }
+		static FORCEINLINE FMask MaskOr(const FMask& A, const FMask& B) { return A || B; }
+		static FORCEINLINE FMask MaskNot(const FMask& A) { return !A; }
+		static FORCEINLINE FInt MaskToInt(const FMask& A) { return A ? 1 : 0; }
+		static FORCEINLINE FFloat MaskToFloat(const FMask& A) { return A ? 1.0f : 0.0f; }
+		static FORCEINLINE bool AllOf(const FMask& A) { return A; }
+
+		static FORCEINLINE FInt Truncate(const FFloat& A) { return (int32)A; }
+		static FORCEINLINE FFloat ToFloat(const FInt& A) { return (float)A; }
+		static FORCEINLINE FInt SetInt(int32 I) { return I; }
+		static FORCEINLINE FInt AddInt(const FInt& A, const FInt& B) { return A + B; }
+		static FORCEINLINE FInt SubInt(const FInt& A, const FInt& B) { return A - B; }
+		static FORCEINLINE FInt AndInt(const FInt& A, const FInt& B) { return A & B; }
+		template <int32 Shift>
+		static FORCEINLINE FInt ShiftLeftInt(const FInt& A) { return (FInt)((uint32)A << Shift); }
+
+		static FORCEINLINE FMask EqualInt(const FInt& A, const FInt& B) { return A == B; }
+		static FORCEINLINE FMask LessThanInt(const FInt& A, const FInt& B) { return A < B; }
+
+		static FORCEINLINE FInt Gather(const int32* Table, const FInt& Index) { return Table[Index]; }
+	};
+
+	#include "SimplexNoiseBatchKernel.inl"
+
+}
+
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsScalar()
+{
+	return SimplexNoiseBatchScalar::MakeKernels<SimplexNoiseBatchScalar::FNoiseVectorScalar>();
+}
+
+//////////////////////////////////////////////////////////////////
+/// INSTRUCTION SET SELECTION
+//////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+#if SIMPLEX_NOISE_BATCH_X86
+	bool CpuSupportsAVX2()
+	{
+#if defined(_MSC_VER)
+		int32 Info[4];
+		__cpuid(Info, 0);
+		if (Info[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(Info, 1);
+		const bool bHasOSXSAVE = (Info[2] & (1 << 27)) != 0;
+		const bool bHasAVX = (Info[2] & (1 << 28)) != 0;
+		if (!bHasOSXSAVE || !bHasAVX)
+		{
+			return false;
+		}
+
+		// The OS has to save the upper half of the ymm registers on context switches
+		if ((_xgetbv(0) & 6) != 6)
+		{
+			return false;
+		}
+
+		__cpuidex(Info, 7, 0);
+		return (Info[1] & (1 << 5)) != 0;
+#else
+		uint32 Eax, Ebx, Ecx, Edx;
+		if (__get_cpuid_max(0, nullptr) < 7)
+		{
+			return false;
+		}
+
+		__cpuid(1, Eax, Ebx, Ecx, Edx);
+		const bool bHasOSXSAVE = (Ecx & (1 << 27)) != 0;
+		const bool bHasAVX = (Ecx & (1 << 28)) != 0;
+		if (!bHasOSXSAVE || !bHasAVX)
+		{
+			return false;
+		}
+
+		// The OS has to save the upper half of the ymm registers on context switches
+		uint32 XCR0Low, XCR0High;
+		__asm__ __volatile__("xgetbv" : "=a"(XCR0Low), "=d"(XCR0High) : "c"(0));
+		if ((XCR0Low & 6) != 6)
+		{
+			return false;
+		}
+
+		__cpuid_count(7, 0, Eax, Ebx, Ecx, Edx);
+		return (Ebx & (1 << 5)) != 0;
+#endif
+	}
+#endif
+
+	/* Every instruction set this build and CPU can run, indexed by ENoiseInstructionSet */
+	struct FSimplexNoiseBatchDispatch
+	{
+		bool bIsSupported[(int32)ENoiseInstructionSet::Num];
+		FSimplexNoiseBatchKernels Kernels[(int32)ENoiseInstructionSet::Num];
+
+		/* Index of the instruction set in use. Only changed for benchmarking, every instruction set gives the same result. */
+		volatile int32 ActiveInstructionSet;
+
+		/* Whether the kernels unrolled for the octave count are used, also only changed for benchmarking */
+		volatile bool bUseFixedOctaveKernels;
+
+		FSimplexNoiseBatchDispatch()
+		{
+			FMemory::Memzero(bIsSupported);
+			FMemory::Memzero(Kernels);
+
+			bIsSupported[(int32)ENoiseInstructionSet::Scalar] = true;
+			Kernels[(int32)ENoiseInstructionSet::Scalar] = GetSimplexNoiseBatchKernelsScalar();
+			ActiveInstructionSet = (int32)ENoiseInstructionSet::Scalar;
+
+#if SIMPLEX_NOISE_BATCH_X86
+			bIsSupported[(int32)ENoiseInstructionSet::SSE2] = true;
+			Kernels[(int32)ENoiseInstructionSet::SSE2] = GetSimplexNoiseBatchKernelsSSE2();
+			ActiveInstructionSet = (int32)ENoiseInstructionSet::SSE2;
+
+			if (CpuSupportsAVX2())
+			{
+				bIsSupported[(int32)ENoiseInstructionSet::AVX2] = true;
+				Kernels[(int32)ENoiseInstructionSet::AVX2] = GetSimplexNoiseBatchKernelsAVX2();
+				ActiveInstructionSet = (int32)ENoiseInstructionSet::AVX2;
+			}
+#endif
+
+#if SIMPLEX_NOISE_BATCH_NEON
+			bIsSupported[(int32)ENoiseInstructionSet::NEON] = true;
+			Kernels[(int32)ENoiseInstructionSet::NEON] = GetSimplexNoiseBatchKernelsNEON();
+			ActiveInstructionSet = (int32)ENoiseInstructionSet::NEON;
+#endif
+
+			// -NoiseISA=SSE2 forces an instruction set, to compare them in game
+			FString ForcedName;
+			if (FParse::Value(FCommandLine::Get(), TEXT("NoiseISA="), ForcedName))
+			{
+				for (int32 i = 0; i < (int32)ENoiseInstructionSet::Num; ++i)
+				{
+					if (bIsSupported[i] && ForcedName.Equals(FSimplexNoiseBatch::GetInstructionSetName((ENoiseInstructionSet)i), ESearchCase::IgnoreCase))
+					{
+						ActiveInstructionSet = i;
+					}
+				}
+			}
+
+			bUseFixedOctaveKernels = !FParse::Param(FCommandLine::Get(), TEXT("NoiseGenericOctaves"));
+
+			UE_LOG(LogStats, Log, TEXT("Simplex Noise Batch using %s%s"), FSimplexNoiseBatch::GetInstructionSetName((ENoiseInstructionSet)ActiveInstructionSet), bUseFixedOctaveKernels ? TEXT("") : TEXT(", generic octave loops"));
+		}
+
+		FORCEINLINE const FSimplexNoiseBatchKernels& GetActiveKernels() const
+		{
+			return Kernels[ActiveInstructionSet];
+		}
+
+		/* Index of the kernels to run for a number of octaves */
+		FORCEINLINE int32 GetOctaveKernelIndex(int32 NumOctaves) const
+		{
+			return bUseFixedOctaveKernels && NumOctaves > 0 && NumOctaves <= SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES ? NumOctaves : 0;
+		}
+	};
+
+	FSimplexNoiseBatchDispatch& GetDispatch()
+	{
+		// Thread safe, the first generation thread to get here initializes it
+		static FSimplexNoiseBatchDispatch Dispatch;
+		return Dispatch;
+	}
+
+}
+
+//////////////////////////////////////////////////////////////////
+/// ROWS
+//////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+	/* The octaves of a row in USimplexNoise coordinates, scaled exactly the way USimplexNoise::Fractal3D scales them */
+	struct FFloatRowOctaves
+	{
+		TArray<float, TInlineAllocator<8 * 64>> Coordinates;
+		TArray<FNoiseRowOctave, TInlineAllocator<8>> Octaves;
+
+		FFloatRowOctaves(const float* X, float Y, float Z, int32 Count, int32 NumOctaves, float Frequency, float Lacunarity, float Persistence)
+		{
+			NumOctaves = FMath::Max(NumOctaves, 0);
+			Coordinates.SetNumUninitialized(Count * NumOctaves);
+			Octaves.SetNumUninitialized(NumOctaves);
+
+			float* x = Coordinates.GetData();
+			for (int32 i = 0; i < Count; ++i)
+			{
+				x[i] = X[i] * Frequency;
+			}
+
+			float y = Y * Frequency;
+			float z = Z * Frequency;
+			float Amplitude = 1.0f;
+			for (int32 Octave = 0; Octave < NumOctaves; ++Octave)
+			{
+				if (Octave > 0)
+				{
+					float* PreviousX = x;
+					x += Count;
+					for (int32 i = 0; i < Count; ++i)
+					{
+						x[i] = PreviousX[i] * Lacunarity;
+					}
+				}
+
+				FNoiseRowOctave& Row = Octaves[Octave];
+				Row.X = x;
+				Row.Y = y;
+				Row.Z = z;
+				Row.OffsetX = 0;
+				Row.OffsetY = 0;
+				Row.OffsetZ = 0;
+				Row.Amplitude = Amplitude;
+
+				y *= Lacunarity;
+				z *= Lacunarity;
+				Amplitude *= Persistence;
+			}
+		}
+	};
+
+}
+
+void FSimplexNoiseBatch::Noise3DRow(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, float* Out)
+{
+	// One octave of fractal noise with frequency 1 is the noise itself
+	Fractal3DRow(Tables, X, Y, Z, Count, Out, 1, 1.0f, 2.0f, 0.5f);
+}
+
+void FSimplexNoiseBatch::Fractal3DRow(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, float* Out, int32 Octaves, float Frequency, float Lacunarity, float Persistence)
+{
+	const FFloatRowOctaves Row(X, Y, Z, Count, Octaves, Frequency, Lacunarity, Persistence);
+	Fractal3DOctaves(Tables, Row.Octaves.GetData(), Row.Octaves.Num(), Count, Out);
+}
+
+int32 FSimplexNoiseBatch::Fractal3DRowBands(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper, int32 Octaves, float Frequency, float Lacunarity, float Persistence)
+{
+	const FFloatRowOctaves Row(X, Y, Z, Count, Octaves, Frequency, Lacunarity, Persistence);
+	return Fractal3DOctavesBands(Tables, Row.Octaves.GetData(), Row.Octaves.Num(), Count, OutBands, Offset, Scale, Lower, Upper);
+}
+
+void FSimplexNoiseBatch::RidgedMulti3DRow(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, float* Out, int32 Octaves, float Frequency, float Lacunarity)
+{
+	const FFloatRowOctaves Row(X, Y, Z, Count, Octaves, Frequency, Lacunarity, 1.0f / Lacunarity);
+	RidgedMulti3DOctaves(Tables, Row.Octaves.GetData(), Row.Octaves.Num(), Count, Out);
+}
+
+void FSimplexNoiseBatch::Fractal3DOctaves(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, float* Out)
+{
+	const FSimplexNoiseBatchDispatch& Dispatch = GetDispatch();
+	Dispatch.GetActiveKernels().Fractal3DOctaves[Dispatch.GetOctaveKernelIndex(NumOctaves)](Tables, Octaves, NumOctaves, Count, Out);
+}
+
+int32 FSimplexNoiseBatch::Fractal3DOctavesBands(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper)
+{
+	const FSimplexNoiseBatchDispatch& Dispatch = GetDispatch();
+	return Dispatch.GetActiveKernels().Fractal3DOctavesBands[Dispatch.GetOctaveKernelIndex(NumOctaves)](Tables, Octaves, NumOctaves, Count, OutBands, Offset, Scale, Lower, Upper);
+}
+
+void FSimplexNoiseBatch::RidgedMulti3DOctaves(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, float* Out)
+{
+	const FSimplexNoiseBatchDispatch& Dispatch = GetDispatch();
+	Dispatch.GetActiveKernels().RidgedMulti3DOctaves[Dispatch.GetOctaveKernelIndex(NumOctaves)](Tables, Octaves, NumOctaves, Count, Out);
+}
+
+ENoiseInstructionSet FSimplexNoiseBatch::GetInstructionSet()
+{
+	return (ENoiseInstructionSet)GetDispatch().ActiveInstructionSet;
+}
+
+bool FSimplexNoiseBatch::SetInstructionSet(ENoiseInstructionSet InstructionSet)
+{
+	if (!IsInstructionSetSupported(InstructionSet))
+	{
+		return false;
+	}
+
+	GetDispatch().ActiveInstructionSet = (int32)InstructionSet;
+	return true;
+}
+
+bool FSimplexNoiseBatch::GetUseFixedOctaveKernels()
+{
+	return GetDispatch().bUseFixedOctaveKernels;
+}
+
+void FSimplexNoiseBatch::SetUseFixedOctaveKernels(bool bUseFixedOctaveKernels)
+{
+	GetDispatch().bUseFixedOctaveKernels = bUseFixedOctaveKernels;
+}
+
+bool FSimplexNoiseBatch::IsInstructionSetSupported(ENoiseInstructionSet InstructionSet)
+{
+	return InstructionSet < ENoiseInstructionSet::Num && GetDispatch().bIsSupported[(int32)InstructionSet];
+}
+
+const TCHAR* FSimplexNoiseBatch::GetInstructionSetName(ENoiseInstructionSet InstructionSet)
+{
+	switch (InstructionSet)
+	{
+	case ENoiseInstructionSet::Scalar:	return TEXT("Scalar");
+	case ENoiseInstructionSet::SSE2:	return TEXT("SSE2");
+	case ENoiseInstructionSet::AVX2:	return TEXT("AVX2");
+	case ENoiseInstructionSet::NEON:	return TEXT("NEON");
+	default:							return TEXT("Unknown");
+	}
+}
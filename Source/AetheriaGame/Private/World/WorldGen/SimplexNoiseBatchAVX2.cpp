@@ -0,0 +1,84 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "SimplexNoiseBatchKernel.h"
+
+#if SIMPLEX_NOISE_BATCH_X86
+
+#include <immintrin.h>
+
+// Only the code in this file is compiled for AVX2, it is never called unless the CPU supports it.
+// MSVC allows AVX2 intrinsics without /arch:AVX2, clang and gcc need the target attribute on every function.
+// FMA is left off on purpose so the kernel rounds exactly like the other instruction sets.
+#if defined(__clang__)
+	#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+	#pragma GCC push_options
+	#pragma GCC target("avx2")
+#endif
+
+namespace SimplexNoiseBatchAVX2
+{
+
+	/* 8 lanes, with hardware gathers */
+	struct FNoiseVectorAVX2
+	{
+		typedef __m256 FFloat;
+		typedef __m256i FInt;
+		typedef __m256 FMask;
+
+		enum { Width = 8 };
+
+		static FORCEINLINE FFloat Load(const float* P) { return _mm256_loadu_ps(P); }
+		static FORCEINLINE void Store(float* P, const FFloat& A) { _mm256_storeu_ps(P, A); }
+		static FORCEINLINE FFloat Set(float F) { return _mm256_set1_ps(F); }
+		static FORCEINLINE FFloat Add(const FFloat& A, const FFloat& B) { return _mm256_add_ps(A, B); }
+		static FORCEINLINE FFloat Sub(const FFloat& A, const FFloat& B) { return _mm256_sub_ps(A, B); }
+		static FORCEINLINE FFloat Mul(const FFloat& A, const FFloat& B) { return _mm256_mul_ps(A, B); }
+		static FORCEINLINE FFloat Min(const FFloat& A, const FFloat& B) { return _mm256_min_ps(A, B); }
+		static FORCEINLINE FFloat Max(const FFloat& A, const FFloat& B) { return _mm256_max_ps(A, B); }
+		static FORCEINLINE FFloat Abs(const FFloat& A) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), A); }
+		static FORCEINLINE FFloat FlipSign(const FFloat& A, const FInt& SignBits) { return _mm256_xor_ps(A, _mm256_castsi256_ps(SignBits)); }
+
+		static FORCEINLINE FMask GreaterThan(const FFloat& A, const FFloat& B) { return _mm256_cmp_ps(A, B, _CMP_GT_OQ); }
+		static FORCEINLINE FMask GreaterEqual(const FFloat& A, const FFloat& B) { return _mm256_cmp_ps(A, B, _CMP_GE_OQ); }
+		static FORCEINLINE FMask LessThan(const FFloat& A, const FFloat& B) { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+		static FORCEINLINE FFloat Select(const FMask& Mask, const FFloat& A, const FFloat& B) { return _mm256_blendv_ps(B, A, Mask); }
+
+		static FORCEINLINE FMask MaskAnd(const FMask& A, const FMask& B) { return _mm256_and_ps(A, B); }
+		static FORCEINLINE FMask MaskOr(const FMask& A, const FMask& B) { return _mm256_or_ps(A, B); }
+		static FORCEINLINE FMask MaskNot(const FMask& A) { return _mm256_xor_ps(A, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+		static FORCEINLINE bool AllOf(const FMask& A) { return _mm256_movemask_ps(A) == 0xFF; }
+		static FORCEINLINE FInt MaskToInt(const FMask& A) { return _mm256_and_si256(_mm256_castps_si256(A), _mm256_set1_epi32(1)); }
+		static FORCEINLINE FFloat MaskToFloat(const FMask& A) { return _mm256_and_ps(A, _mm256_set1_ps(1.0f)); }
+
+		static FORCEINLINE FInt Truncate(const FFloat& A) { return _mm256_cvttps_epi32(A); }
+		static FORCEINLINE FFloat ToFloat(const FInt& A) { return _mm256_cvtepi32_ps(A); }
+		static FORCEINLINE FInt SetInt(int32 I) { return _mm256_set1_epi32(I); }
+		static FORCEINLINE FInt AddInt(const FInt& A, const FInt& B) { return _mm256_add_epi32(A, B); }
+		static FORCEINLINE FInt SubInt(const FInt& A, const FInt& B) { return _mm256_sub_epi32(A, B); }
+		static FORCEINLINE FInt AndInt(const FInt& A, const FInt& B) { return _mm256_and_si256(A, B); }
+		template <int32 Shift>
+		static FORCEINLINE FInt ShiftLeftInt(const FInt& A) { return _mm256_slli_epi32(A, Shift); }
+
+		static FORCEINLINE FMask EqualInt(const FInt& A, const FInt& B) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(A, B)); }
+		static FORCEINLINE FMask LessThanInt(const FInt& A, const FInt& B) { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(B, A)); }
+
+		static FORCEINLINE FInt Gather(const int32* Table, const FInt& Index) { return _mm256_i32gather_epi32((const int*)Table, Index, 4); }
+	};
+
+	#include "SimplexNoiseBatchKernel.inl"
+
+}
+
+#if defined(__clang__)
+	#pragma clang attribute pop
+#elif defined(__GNUC__)
+	#pragma GCC pop_options
+#endif
+
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsAVX2()
+{
+	return SimplexNoiseBatchAVX2::MakeKernels<SimplexNoiseBatchAVX2::FNoiseVectorAVX2>();
+}
+
+#endif
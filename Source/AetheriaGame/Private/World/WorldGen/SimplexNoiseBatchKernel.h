@@ -0,0 +1,30 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "SimplexNoiseBatch.h"
+
+SIMPLEX_NOISE_FP_CONTRACT_OFF
+
+/* Signatures of the row kernels, see SimplexNoiseBatchKernel.inl */
+typedef void(*FFractal3DOctavesFunction)(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, float* Out);
+typedef int32(*FFractal3DOctavesBandsFunction)(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper);
+typedef void(*FRidgedMulti3DOctavesFunction)(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, float* Out);
+
+/* The kernels of one instruction set. Index 0 runs any number of octaves, index N is unrolled for exactly N octaves. */
+struct FSimplexNoiseBatchKernels
+{
+	FFractal3DOctavesFunction Fractal3DOctaves[SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES + 1];
+	FFractal3DOctavesBandsFunction Fractal3DOctavesBands[SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES + 1];
+	FRidgedMulti3DOctavesFunction RidgedMulti3DOctaves[SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES + 1];
+};
+
+/* Defined in the translation unit of each instruction set. Only call them if the CPU supports the instruction set. */
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsScalar();
+#if SIMPLEX_NOISE_BATCH_X86
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsSSE2();
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsAVX2();
+#endif
+#if SIMPLEX_NOISE_BATCH_NEON
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsNEON();
+#endif
@@ -0,0 +1,342 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+/*
+The batch noise kernels, written once against a vector type V and compiled once per instruction set.
+Each instruction set includes this file inside its own namespace, after the compiler is told to target it,
+so that every function below is compiled with the right instructions.
+
+V has to provide:
+	FFloat, FInt, FMask - vectors of Width floats, int32s and comparison results
+	Load, Store, Set, Add, Sub, Mul, Min, Max, Abs, FlipSign          - float math
+	GreaterThan, GreaterEqual, LessThan, Select                       - float comparisons
+	MaskAnd, MaskOr, MaskNot, MaskToInt, MaskToFloat                   - masks, MaskTo* turn true into 1 and false into 0
+	AllOf                                                             - whether every lane of a mask is true
+	Truncate, ToFloat, SetInt, AddInt, SubInt, AndInt, ShiftLeftInt    - int32 math
+	EqualInt, LessThanInt, Gather                                      - int32 comparisons and table lookup
+
+Every operation is done in the same order as SimplexNoiseImplementation::noise, so each lane matches the scalar code.
+*/
+
+/* FASTFLOOR from SimplexNoiseImplementation, including its quirk of flooring 0 to -1 */
+template <typename V>
+FORCEINLINE typename V::FInt FastFloor(const typename V::FFloat& x)
+{
+	return V::SubInt(V::Truncate(x), V::MaskToInt(V::MaskNot(V::GreaterThan(x, V::Set(0.0f)))));
+}
+
+/* SimplexNoiseImplementation::grad(hash, x, y, z) */
+template <typename V>
+FORCEINLINE typename V::FFloat Grad(const typename V::FInt& Hash, const typename V::FFloat& x, const typename V::FFloat& y, const typename V::FFloat& z)
+{
+	typedef typename V::FFloat FFloat;
+	typedef typename V::FInt FInt;
+
+	const FInt h = V::AndInt(Hash, V::SetInt(15));
+	const FFloat u = V::Select(V::LessThanInt(h, V::SetInt(8)), x, y);
+	const FFloat v = V::Select(V::LessThanInt(h, V::SetInt(4)), y, V::Select(V::MaskOr(V::EqualInt(h, V::SetInt(12)), V::EqualInt(h, V::SetInt(14))), x, z));
+
+	// Bit 0 and 1 of the hash flip the sign of u and v
+	const FFloat SignedU = V::FlipSign(u, V::template ShiftLeftInt<31>(V::AndInt(h, V::SetInt(1))));
+	const FFloat SignedV = V::FlipSign(v, V::template ShiftLeftInt<30>(V::AndInt(h, V::SetInt(2))));
+	return V::Add(SignedU, SignedV);
+}
+
+/* Contribution of one corner of the simplex */
+template <typename V>
+FORCEINLINE typename V::FFloat Corner(const typename V::FInt& Hash, const typename V::FFloat& x, const typename V::FFloat& y, const typename V::FFloat& z)
+{
+	typedef typename V::FFloat FFloat;
+
+	const FFloat t = V::Sub(V::Sub(V::Sub(V::Set(0.6f), V::Mul(x, x)), V::Mul(y, y)), V::Mul(z, z));
+	const FFloat t2 = V::Mul(t, t);
+	const FFloat n = V::Mul(V::Mul(t2, t2), Grad<V>(Hash, x, y, z));
+	return V::Select(V::LessThan(t, V::Set(0.0f)), V::Set(0.0f), n);
+}
+
+/*
+SimplexNoiseImplementation::noise(x, y, z) for every lane.
+The offsets are added to the simplex cell before it is hashed, see FNoiseRowOctave.
+*/
+template <typename V>
+FORCEINLINE typename V::FFloat Noise3D(const FSimplexNoiseTables& Tables, const typename V::FFloat& x, const typename V::FFloat& y, const typename V::FFloat& z, const typename V::FInt& OffsetI, const typename V::FInt& OffsetJ, const typename V::FInt& OffsetK)
+{
+	typedef typename V::FFloat FFloat;
+	typedef typename V::FInt FInt;
+	typedef typename V::FMask FMask;
+
+	const float F3 = 0.333333333f;
+	const float G3 = 0.166666667f;
+
+	// Skew the input space to determine which simplex cell we're in
+	const FFloat s = V::Mul(V::Add(V::Add(x, y), z), V::Set(F3));
+	const FInt i = FastFloor<V>(V::Add(x, s));
+	const FInt j = FastFloor<V>(V::Add(y, s));
+	const FInt k = FastFloor<V>(V::Add(z, s));
+
+	// Unskew the cell origin back to (x,y,z) space
+	const FFloat t = V::Mul(V::ToFloat(V::AddInt(V::AddInt(i, j), k)), V::Set(G3));
+	const FFloat x0 = V::Sub(x, V::Sub(V::ToFloat(i), t));
+	const FFloat y0 = V::Sub(y, V::Sub(V::ToFloat(j), t));
+	const FFloat z0 = V::Sub(z, V::Sub(V::ToFloat(k), t));
+
+	// The branches that pick the simplex in the scalar code, written as masks
+	const FMask XY = V::GreaterEqual(x0, y0);
+	const FMask YZ = V::GreaterEqual(y0, z0);
+	const FMask XZ = V::GreaterEqual(x0, z0);
+
+	const FMask i1 = V::MaskAnd(XY, XZ);
+	const FMask j1 = V::MaskAnd(V::MaskNot(XY), YZ);
+	const FMask k1 = V::MaskNot(V::MaskOr(YZ, XZ));
+	const FMask i2 = V::MaskOr(XY, XZ);
+	const FMask j2 = V::MaskOr(V::MaskNot(XY), YZ);
+	const FMask k2 = V::MaskNot(V::MaskAnd(YZ, XZ));
+
+	const FFloat x1 = V::Add(V::Sub(x0, V::MaskToFloat(i1)), V::Set(G3));
+	const FFloat y1 = V::Add(V::Sub(y0, V::MaskToFloat(j1)), V::Set(G3));
+	const FFloat z1 = V::Add(V::Sub(z0, V::MaskToFloat(k1)), V::Set(G3));
+	const FFloat x2 = V::Add(V::Sub(x0, V::MaskToFloat(i2)), V::Set(2.0f * G3));
+	const FFloat y2 = V::Add(V::Sub(y0, V::MaskToFloat(j2)), V::Set(2.0f * G3));
+	const FFloat z2 = V::Add(V::Sub(z0, V::MaskToFloat(k2)), V::Set(2.0f * G3));
+	const FFloat x3 = V::Add(V::Sub(x0, V::Set(1.0f)), V::Set(3.0f * G3));
+	const FFloat y3 = V::Add(V::Sub(y0, V::Set(1.0f)), V::Set(3.0f * G3));
+	const FFloat z3 = V::Add(V::Sub(z0, V::Set(1.0f)), V::Set(3.0f * G3));
+
+	// Wrap the integer indices at 256, to avoid indexing perm[] out of bounds
+	const FInt ii = V::AndInt(V::AddInt(i, OffsetI), V::SetInt(0xff));
+	const FInt jj = V::AndInt(V::AddInt(j, OffsetJ), V::SetInt(0xff));
+	const FInt kk = V::AndInt(V::AddInt(k, OffsetK), V::SetInt(0xff));
+	const FInt One = V::SetInt(1);
+
+	// The last lookup picks the gradient
+	const FInt Hash0 = V::Gather(Tables.Gradients, V::AddInt(ii, V::Gather(Tables.Perm, V::AddInt(jj, V::Gather(Tables.Perm, kk)))));
+	const FInt Hash1 = V::Gather(Tables.Gradients, V::AddInt(V::AddInt(ii, V::MaskToInt(i1)), V::Gather(Tables.Perm, V::AddInt(V::AddInt(jj, V::MaskToInt(j1)), V::Gather(Tables.Perm, V::AddInt(kk, V::MaskToInt(k1)))))));
+	const FInt Hash2 = V::Gather(Tables.Gradients, V::AddInt(V::AddInt(ii, V::MaskToInt(i2)), V::Gather(Tables.Perm, V::AddInt(V::AddInt(jj, V::MaskToInt(j2)), V::Gather(Tables.Perm, V::AddInt(kk, V::MaskToInt(k2)))))));
+	const FInt Hash3 = V::Gather(Tables.Gradients, V::AddInt(V::AddInt(ii, One), V::Gather(Tables.Perm, V::AddInt(V::AddInt(jj, One), V::Gather(Tables.Perm, V::AddInt(kk, One))))));
+
+	const FFloat n0 = Corner<V>(Hash0, x0, y0, z0);
+	const FFloat n1 = Corner<V>(Hash1, x1, y1, z1);
+	const FFloat n2 = Corner<V>(Hash2, x2, y2, z2);
+	const FFloat n3 = Corner<V>(Hash3, x3, y3, z3);
+
+	return V::Mul(V::Set(32.0f), V::Add(V::Add(V::Add(n0, n1), n2), n3));
+}
+
+/* Loads Width x values, padding the end of the row with zeros */
+template <typename V>
+FORCEINLINE typename V::FFloat LoadRow(const float* X, int32 Remaining)
+{
+	if (Remaining >= V::Width)
+	{
+		return V::Load(X);
+	}
+
+	float Padded[V::Width] = { 0.0f };
+	for (int32 i = 0; i < Remaining; ++i)
+	{
+		Padded[i] = X[i];
+	}
+	return V::Load(Padded);
+}
+
+/* Stores the first Remaining lanes */
+template <typename V>
+FORCEINLINE void StoreRow(float* Out, int32 Remaining, const typename V::FFloat& Value)
+{
+	if (Remaining >= V::Width)
+	{
+		V::Store(Out, Value);
+		return;
+	}
+
+	float Padded[V::Width];
+	V::Store(Padded, Value);
+	for (int32 i = 0; i < Remaining; ++i)
+	{
+		Out[i] = Padded[i];
+	}
+}
+
+/* Noise3D of one octave of a row */
+template <typename V>
+FORCEINLINE typename V::FFloat OctaveNoise(const FSimplexNoiseTables& Tables, const FNoiseRowOctave& Octave, int32 Index, int32 Remaining)
+{
+	return Noise3D<V>(Tables, LoadRow<V>(Octave.X + Index, Remaining), V::Set(Octave.Y), V::Set(Octave.Z), V::SetInt(Octave.OffsetX), V::SetInt(Octave.OffsetY), V::SetInt(Octave.OffsetZ));
+}
+
+/*
+Every row kernel is compiled once for any number of octaves (FixedOctaves = 0), and once for every octave count up to
+SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES, where the octave loops have a constant trip count and are fully unrolled.
+*/
+template <int32 FixedOctaves>
+FORCEINLINE int32 GetNumOctaves(int32 NumOctaves)
+{
+	return FixedOctaves > 0 ? FixedOctaves : NumOctaves;
+}
+
+/* USimplexNoise::Fractal3D for a row, every octave of a lane is done while it is still in registers */
+template <typename V, int32 FixedOctaves>
+void Fractal3DOctaves(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 InNumOctaves, int32 Count, float* Out)
+{
+	typedef typename V::FFloat FFloat;
+
+	const int32 NumOctaves = GetNumOctaves<FixedOctaves>(InNumOctaves);
+
+	for (int32 Index = 0; Index < Count; Index += V::Width)
+	{
+		const int32 Remaining = Count - Index;
+
+		FFloat Value = V::Set(0.0f);
+		for (int32 i = 0; i < NumOctaves; i++)
+		{
+			const FFloat Noise = OctaveNoise<V>(Tables, Octaves[i], Index, Remaining);
+			Value = V::Add(Value, V::Mul(Noise, V::Set(Octaves[i].Amplitude)));
+		}
+
+		StoreRow<V>(Out + Index, Remaining, Value);
+	}
+}
+
+/*
+Fractal3DOctaves sorted into bands, see FSimplexNoiseBatch::Fractal3DRowBands.
+After each octave the octaves left can move a lane by at most the sum of their amplitudes, because every octave stays inside [-1, 1].
+Once that interval is inside a single band for every lane, the rest of the octaves are skipped.
+The band is always read from Offset - Value * Scale, which is the value itself once every octave is added. When the octaves stop early,
+rounding is monotonic, so the partial value lands in the same band as the ends of the interval.
+*/
+template <typename V, int32 FixedOctaves>
+int32 Fractal3DOctavesBands(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 InNumOctaves, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper)
+{
+	typedef typename V::FFloat FFloat;
+	typedef typename V::FMask FMask;
+
+	const int32 NumOctaves = GetNumOctaves<FixedOctaves>(InNumOctaves);
+
+	float TotalBound = 0.0f;
+	for (int32 i = 0; i < NumOctaves; i++)
+	{
+		TotalBound += FMath::Abs(Octaves[i].Amplitude);
+	}
+
+	// Much larger than the rounding error of adding up the octaves or of subtracting their bounds
+	const float Margin = TotalBound * 0.0001f;
+
+	float LaneIndices[V::Width];
+	for (int32 Lane = 0; Lane < V::Width; ++Lane)
+	{
+		LaneIndices[Lane] = (float)Lane;
+	}
+
+	int32 OctavesEvaluated = 0;
+
+	for (int32 Index = 0; Index < Count; Index += V::Width)
+	{
+		const int32 Remaining = Count - Index;
+
+		// The padding lanes at the end of the row are never waited on
+		const FMask Padding = V::GreaterEqual(V::Load(LaneIndices), V::Set((float)Remaining));
+
+		FFloat Value = V::Set(0.0f);
+		float RemainingBound = TotalBound;
+
+		int32 i = 0;
+		while (i < NumOctaves)
+		{
+			const FFloat Noise = OctaveNoise<V>(Tables, Octaves[i], Index, Remaining);
+			Value = V::Add(Value, V::Mul(Noise, V::Set(Octaves[i].Amplitude)));
+			RemainingBound -= FMath::Abs(Octaves[i].Amplitude);
+			++i;
+
+			if (i == NumOctaves)
+			{
+				break;
+			}
+
+			const FFloat Bound = V::Set(RemainingBound + Margin);
+			const FFloat EndA = V::Sub(V::Set(Offset), V::Mul(V::Add(Value, Bound), V::Set(Scale)));
+			const FFloat EndB = V::Sub(V::Set(Offset), V::Mul(V::Sub(Value, Bound), V::Set(Scale)));
+			const FFloat Low = V::Min(EndA, EndB);
+			const FFloat High = V::Max(EndA, EndB);
+
+			const FMask BelowLower = V::LessThan(High, V::Set(Lower));
+			const FMask BetweenBoth = V::MaskAnd(V::GreaterEqual(Low, V::Set(Lower)), V::LessThan(High, V::Set(Upper)));
+			const FMask AboveUpper = V::GreaterEqual(Low, V::Set(Upper));
+			if (V::AllOf(V::MaskOr(V::MaskOr(V::MaskOr(BelowLower, BetweenBoth), AboveUpper), Padding)))
+			{
+				break;
+			}
+		}
+
+		const FFloat Result = V::Sub(V::Set(Offset), V::Mul(Value, V::Set(Scale)));
+		const FFloat Band = V::Sub(V::Set(2.0f), V::Add(V::MaskToFloat(V::LessThan(Result, V::Set(Upper))), V::MaskToFloat(V::LessThan(Result, V::Set(Lower)))));
+
+		float Bands[V::Width];
+		V::Store(Bands, Band);
+		const int32 NumLanes = Remaining < V::Width ? Remaining : V::Width;
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			OutBands[Index + Lane] = (uint8)Bands[Lane];
+		}
+
+		OctavesEvaluated += i * NumLanes;
+	}
+
+	return OctavesEvaluated;
+}
+
+/* USimplexNoise::RidgedMulti3D for a row */
+template <typename V, int32 FixedOctaves>
+void RidgedMulti3DOctaves(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 InNumOctaves, int32 Count, float* Out)
+{
+	typedef typename V::FFloat FFloat;
+
+	const int32 NumOctaves = GetNumOctaves<FixedOctaves>(InNumOctaves);
+
+	const float Offset = 1.0f;
+	const float Gain = 2.0f;
+
+	for (int32 Index = 0; Index < Count; Index += V::Width)
+	{
+		const int32 Remaining = Count - Index;
+
+		FFloat Value = V::Set(0.0f);
+		FFloat Weight = V::Set(1.0f);
+		for (int32 i = 0; i < NumOctaves; i++)
+		{
+			FFloat Noise = OctaveNoise<V>(Tables, Octaves[i], Index, Remaining);
+			Noise = V::Sub(V::Set(Offset), V::Abs(Noise));
+			Noise = V::Mul(Noise, Noise);
+			Noise = V::Mul(Noise, Weight);
+			Weight = V::Min(V::Max(V::Mul(Noise, V::Set(Gain)), V::Set(0.0f)), V::Set(1.0f));
+			Value = V::Add(Value, V::Mul(Noise, V::Set(Octaves[i].Amplitude)));
+		}
+
+		StoreRow<V>(Out + Index, Remaining, V::Sub(V::Mul(Value, V::Set(1.25f)), V::Set(1.0f)));
+	}
+}
+
+/* Fills the kernels for FixedOctaves and every count below it */
+template <typename V, int32 FixedOctaves>
+struct FOctaveKernels
+{
+	static void Fill(FSimplexNoiseBatchKernels& Kernels)
+	{
+		Kernels.Fractal3DOctaves[FixedOctaves] = &Fractal3DOctaves<V, FixedOctaves>;
+		Kernels.Fractal3DOctavesBands[FixedOctaves] = &Fractal3DOctavesBands<V, FixedOctaves>;
+		Kernels.RidgedMulti3DOctaves[FixedOctaves] = &RidgedMulti3DOctaves<V, FixedOctaves>;
+		FOctaveKernels<V, FixedOctaves - 1>::Fill(Kernels);
+	}
+};
+
+template <typename V>
+struct FOctaveKernels<V, -1>
+{
+	static void Fill(FSimplexNoiseBatchKernels& Kernels) {}
+};
+
+template <typename V>
+FSimplexNoiseBatchKernels MakeKernels()
+{
+	FSimplexNoiseBatchKernels Kernels;
+	FOctaveKernels<V, SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES>::Fill(Kernels);
+	return Kernels;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "SimplexNoiseBatchKernel.h"
+
+#if SIMPLEX_NOISE_BATCH_NEON
+
+#include <arm_neon.h>
+
+namespace SimplexNoiseBatchNEON
+{
+
+	/* 4 lanes, NEON is always available on arm64 */
+	struct FNoiseVectorNEON
+	{
+		typedef float32x4_t FFloat;
+		typedef int32x4_t FInt;
+		typedef uint32x4_t FMask;
+
+		enum { Width = 4 };
+
+		static FORCEINLINE FFloat Load(const float* P) { return vld1q_f32(P); }
+		static FORCEINLINE void Store(float* P, const FFloat& A) { vst1q_f32(P, A); }
+		static FORCEINLINE FFloat Set(float F) { return vdupq_n_f32(F); }
+		static FORCEINLINE FFloat Add(const FFloat& A, const FFloat& B) { return vaddq_f32(A, B); }
+		static FORCEINLINE FFloat Sub(const FFloat& A, const FFloat& B) { return vsubq_f32(A, B); }
+		static FORCEINLINE FFloat Mul(const FFloat& A, const FFloat& B) { return vmulq_f32(A, B); }
+		static FORCEINLINE FFloat Min(const FFloat& A, const FFloat& B) { return vminq_f32(A, B); }
+		static FORCEINLINE FFloat Max(const FFloat& A, const FFloat& B) { return vmaxq_f32(A, B); }
+		static FORCEINLINE FFloat Abs(const FFloat& A) { return vabsq_f32(A); }
+		static FORCEINLINE FFloat FlipSign(const FFloat& A, const FInt& SignBits) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(A), vreinterpretq_u32_s32(SignBits))); }
+
+		static FORCEINLINE FMask GreaterThan(const FFloat& A, const FFloat& B) { return vcgtq_f32(A, B); }
+		static FORCEINLINE FMask GreaterEqual(const FFloat& A, const FFloat& B) { return vcgeq_f32(A, B); }
+		static FORCEINLINE FMask LessThan(const FFloat& A, const FFloat& B) { return vcltq_f32(A, B); }
+		static FORCEINLINE FFloat Select(const FMask& Mask, const FFloat& A, const FFloat& B) { return vbslq_f32(Mask, A, B); }
+
+		static FORCEINLINE FMask MaskAnd(const FMask& A, const FMask& B) { return vandq_u32(A, B); }
+		static FORCEINLINE FMask MaskOr(const FMask& A, const FMask& B) { return vorrq_u32(A, B); }
+		static FORCEINLINE FMask MaskNot(const FMask& A) { return vmvnq_u32(A); }
+		static FORCEINLINE bool AllOf(const FMask& A) { return vminvq_u32(A) != 0; }
+		static FORCEINLINE FInt MaskToInt(const FMask& A) { return vreinterpretq_s32_u32(vandq_u32(A, vdupq_n_u32(1))); }
+		static FORCEINLINE FFloat MaskToFloat(const FMask& A) { return vreinterpretq_f32_u32(vandq_u32(A, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))); }
+
+		static FORCEINLINE FInt Truncate(const FFloat& A) { return vcvtq_s32_f32(A); }
+		static FORCEINLINE FFloat ToFloat(const FInt& A) { return vcvtq_f32_s32(A); }
+		static FORCEINLINE FInt SetInt(int32 I) { return vdupq_n_s32(I); }
+		static FORCEINLINE FInt AddInt(const FInt& A, const FInt& B) { return vaddq_s32(A, B); }
+		static FORCEINLINE FInt SubInt(const FInt& A, const FInt& B) { return vsubq_s32(A, B); }
+		static FORCEINLINE FInt AndInt(const FInt& A, const FInt& B) { return vandq_s32(A, B); }
+		template <int32 Shift>
+		static FORCEINLINE FInt ShiftLeftInt(const FInt& A) { return vshlq_n_s32(A, Shift); }
+
+		static FORCEINLINE FMask EqualInt(const FInt& A, const FInt& B) { return vceqq_s32(A, B); }
+		static FORCEINLINE FMask LessThanInt(const FInt& A, const FInt& B) { return vcltq_s32(A, B); }
+
+		/* NEON has no gather, so the lookups are done one lane at a time */
+		static FORCEINLINE FInt Gather(const int32* Table, const FInt& Index)
+		{
+			int32 Indices[Width];
+			vst1q_s32(Indices, Index);
+			const int32 Values[Width] = { Table[Indices[0]], Table[Indices[1]], Table[Indices[2]], Table[Indices[3]] };
+			return vld1q_s32(Values);
+		}
+	};
+
+	#include "SimplexNoiseBatchKernel.inl"
+
+}
+
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsNEON()
+{
+	return SimplexNoiseBatchNEON::MakeKernels<SimplexNoiseBatchNEON::FNoiseVectorNEON>();
+}
+
+#endif
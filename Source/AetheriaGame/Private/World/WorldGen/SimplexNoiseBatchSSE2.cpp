@@ -0,0 +1,74 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "SimplexNoiseBatchKernel.h"
+
+#if SIMPLEX_NOISE_BATCH_X86
+
+#include <emmintrin.h>
+
+namespace SimplexNoiseBatchSSE2
+{
+
+	/* 4 lanes, SSE2 is always available on x86-64 */
+	struct FNoiseVectorSSE2
+	{
+		typedef __m128 FFloat;
+		typedef __m128i FInt;
+		typedef __m128 FMask;
+
+		enum { Width = 4 };
+
+		static FORCEINLINE FFloat Load(const float* P) { return _mm_loadu_ps(P); }
+		static FORCEINLINE void Store(float* P, const FFloat& A) { _mm_storeu_ps(P, A); }
+		static FORCEINLINE FFloat Set(float F) { return _mm_set1_ps(F); }
+		static FORCEINLINE FFloat Add(const FFloat& A, const FFloat& B) { return _mm_add_ps(A, B); }
+		static FORCEINLINE FFloat Sub(const FFloat& A, const FFloat& B) { return _mm_sub_ps(A, B); }
+		static FORCEINLINE FFloat Mul(const FFloat& A, const FFloat& B) { return _mm_mul_ps(A, B); }
+		static FORCEINLINE FFloat Min(const FFloat& A, const FFloat& B) { return _mm_min_ps(A, B); }
+		static FORCEINLINE FFloat Max(const FFloat& A, const FFloat& B) { return _mm_max_ps(A, B); }
+		static FORCEINLINE FFloat Abs(const FFloat& A) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), A); }
+		static FORCEINLINE FFloat FlipSign(const FFloat& A, const FInt& SignBits) { return _mm_xor_ps(A, _mm_castsi128_ps(SignBits)); }
+
+		static FORCEINLINE FMask GreaterThan(const FFloat& A, const FFloat& B) { return _mm_cmpgt_ps(A, B); }
+		static FORCEINLINE FMask GreaterEqual(const FFloat& A, const FFloat& B) { return _mm_cmpge_ps(A, B); }
+		static FORCEINLINE FMask LessThan(const FFloat& A, const FFloat& B) { return _mm_cmplt_ps(A, B); }
+		static FORCEINLINE FFloat Select(const FMask& Mask, const FFloat& A, const FFloat& B) { return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B)); }
+
+		static FORCEINLINE FMask MaskAnd(const FMask& A, const FMask& B) { return _mm_and_ps(A, B); }
+		static FORCEINLINE FMask MaskOr(const FMask& A, const FMask& B) { return _mm_or_ps(A, B); }
+		static FORCEINLINE FMask MaskNot(const FMask& A) { return _mm_xor_ps(A, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+		static FORCEINLINE bool AllOf(const FMask& A) { return _mm_movemask_ps(A) == 0xF; }
+		static FORCEINLINE FInt MaskToInt(const FMask& A) { return _mm_and_si128(_mm_castps_si128(A), _mm_set1_epi32(1)); }
+		static FORCEINLINE FFloat MaskToFloat(const FMask& A) { return _mm_and_ps(A, _mm_set1_ps(1.0f)); }
+
+		static FORCEINLINE FInt Truncate(const FFloat& A) { return _mm_cvttps_epi32(A); }
+		static FORCEINLINE FFloat ToFloat(const FInt& A) { return _mm_cvtepi32_ps(A); }
+		static FORCEINLINE FInt SetInt(int32 I) { return _mm_set1_epi32(I); }
+		static FORCEINLINE FInt AddInt(const FInt& A, const FInt& B) { return _mm_add_epi32(A, B); }
+		static FORCEINLINE FInt SubInt(const FInt& A, const FInt& B) { return _mm_sub_epi32(A, B); }
+		static FORCEINLINE FInt AndInt(const FInt& A, const FInt& B) { return _mm_and_si128(A, B); }
+		template <int32 Shift>
+		static FORCEINLINE FInt ShiftLeftInt(const FInt& A) { return _mm_slli_epi32(A, Shift); }
+
+		static FORCEINLINE FMask EqualInt(const FInt& A, const FInt& B) { return _mm_castsi128_ps(_mm_cmpeq_epi32(A, B)); }
+		static FORCEINLINE FMask LessThanInt(const FInt& A, const FInt& B) { return _mm_castsi128_ps(_mm_cmplt_epi32(A, B)); }
+
+		/* SSE2 has no gather, so the lookups are done one lane at a time */
+		static FORCEINLINE FInt Gather(const int32* Table, const FInt& Index)
+		{
+			MS_ALIGN(16) int32 Indices[Width] GCC_ALIGN(16);
+			_mm_store_si128((__m128i*)Indices, Index);
+			return _mm_setr_epi32(Table[Indices[0]], Table[Indices[1]], Table[Indices[2]], Table[Indices[3]]);
+		}
+	};
+
+	#include "SimplexNoiseBatchKernel.inl"
+
+}
+
+FSimplexNoiseBatchKernels GetSimplexNoiseBatchKernelsSSE2()
+{
+	return SimplexNoiseBatchSSE2::MakeKernels<SimplexNoiseBatchSSE2::FNoiseVectorSSE2>();
+}
+
+#endif
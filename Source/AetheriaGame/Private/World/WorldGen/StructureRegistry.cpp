@@ -0,0 +1,217 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "StructureRegistry.h"
+
+#include "ChunkUtils.h"
+
+#include "ScopeLock.h"
+
+void FStructureRegistry::AddColumn(const FIntVector2D& ColumnCoord, const TArray<FStructurePlacement>& Structures, TArray<FStructurePlacement>& OutColumnStructures)
+{
+
+	FScopeLock RegistryLock(&RegistryMutex);
+
+	GeneratedColumns.Add(ColumnCoord);
+
+	// A column generated again places the same structures, they are still registered if one of the columns they reach into stayed loaded
+	bool bAlreadyRegistered = false;
+	RegisteredColumns.Add(ColumnCoord, &bAlreadyRegistered);
+	if (!bAlreadyRegistered)
+	{
+		for (const FStructurePlacement& Structure : Structures)
+		{
+			RegisterStructure(ColumnCoord, Structure);
+		}
+	}
+
+	const TArray<FStructurePlacement>* const Found = ColumnStructures.Find(ColumnCoord);
+	if (Found != nullptr)
+	{
+		OutColumnStructures = *Found;
+	}
+	else
+	{
+		OutColumnStructures.Reset();
+	}
+
+}
+
+void FStructureRegistry::RegisterStructure(const FIntVector2D& SourceColumnCoord, const FStructurePlacement& Structure)
+{
+
+	FIntVector2D MinColumn;
+	FIntVector2D MaxColumn;
+	GetColumnBounds(Structure, MinColumn, MaxColumn);
+
+	for (int32 ColumnY = MinColumn.Y; ColumnY <= MaxColumn.Y; ++ColumnY)
+	{
+		for (int32 ColumnX = MinColumn.X; ColumnX <= MaxColumn.X; ++ColumnX)
+		{
+			const FIntVector2D Column(ColumnX, ColumnY);
+			ColumnStructures.FindOrAdd(Column).Add(Structure);
+
+			// Neighbors generated before the source column didn't see the structure
+			if (Column != SourceColumnCoord && GeneratedColumns.Contains(Column))
+			{
+				FSpill& Spill = Spills[Spills.AddUninitialized()];
+				Spill.ColumnCoord = Column;
+				Spill.Structure = Structure;
+			}
+		}
+	}
+
+}
+
+void FStructureRegistry::RemoveColumn(const FIntVector2D& ColumnCoord)
+{
+
+	FScopeLock RegistryLock(&RegistryMutex);
+
+	if (GeneratedColumns.Remove(ColumnCoord) == 0)
+	{
+		return;
+	}
+
+	// The column itself, and the neighbors whose structures reach into it, may have been kept only for it
+	TArray<FIntVector2D, TInlineAllocator<9>> SourceColumns;
+	SourceColumns.Add(ColumnCoord);
+	const TArray<FStructurePlacement>* const Found = ColumnStructures.Find(ColumnCoord);
+	if (Found != nullptr)
+	{
+		for (const FStructurePlacement& Structure : *Found)
+		{
+			SourceColumns.AddUnique(GetSourceColumn(Structure));
+		}
+	}
+
+	for (const FIntVector2D& SourceColumn : SourceColumns)
+	{
+		if (RegisteredColumns.Contains(SourceColumn) && !IsColumnNeeded(SourceColumn))
+		{
+			UnregisterColumn(SourceColumn);
+		}
+	}
+
+}
+
+bool FStructureRegistry::IsColumnNeeded(const FIntVector2D& SourceColumnCoord) const
+{
+
+	if (GeneratedColumns.Contains(SourceColumnCoord))
+	{
+		return true;
+	}
+
+	TArray<FStructurePlacement> Structures;
+	GetOwnStructures(SourceColumnCoord, Structures);
+	for (const FStructurePlacement& Structure : Structures)
+	{
+		FIntVector2D MinColumn;
+		FIntVector2D MaxColumn;
+		GetColumnBounds(Structure, MinColumn, MaxColumn);
+
+		for (int32 ColumnY = MinColumn.Y; ColumnY <= MaxColumn.Y; ++ColumnY)
+		{
+			for (int32 ColumnX = MinColumn.X; ColumnX <= MaxColumn.X; ++ColumnX)
+			{
+				if (GeneratedColumns.Contains(FIntVector2D(ColumnX, ColumnY)))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+
+}
+
+void FStructureRegistry::UnregisterColumn(const FIntVector2D& SourceColumnCoord)
+{
+
+	TArray<FStructurePlacement> Structures;
+	GetOwnStructures(SourceColumnCoord, Structures);
+	for (const FStructurePlacement& Structure : Structures)
+	{
+		FIntVector2D MinColumn;
+		FIntVector2D MaxColumn;
+		GetColumnBounds(Structure, MinColumn, MaxColumn);
+
+		for (int32 ColumnY = MinColumn.Y; ColumnY <= MaxColumn.Y; ++ColumnY)
+		{
+			for (int32 ColumnX = MinColumn.X; ColumnX <= MaxColumn.X; ++ColumnX)
+			{
+				const FIntVector2D Column(ColumnX, ColumnY);
+				TArray<FStructurePlacement>* const Found = ColumnStructures.Find(Column);
+				if (Found == nullptr)
+				{
+					continue;
+				}
+
+				// Keeps the order, overlapping structures are stamped in it
+				Found->RemoveSingle(Structure);
+				if (Found->Num() == 0)
+				{
+					ColumnStructures.Remove(Column);
+				}
+			}
+		}
+	}
+
+	RegisteredColumns.Remove(SourceColumnCoord);
+
+}
+
+void FStructureRegistry::GetOwnStructures(const FIntVector2D& SourceColumnCoord, TArray<FStructurePlacement>& OutStructures) const
+{
+
+	// Every structure reaches into the column it grows from
+	OutStructures.Reset();
+	const TArray<FStructurePlacement>* const Found = ColumnStructures.Find(SourceColumnCoord);
+	if (Found != nullptr)
+	{
+		for (const FStructurePlacement& Structure : *Found)
+		{
+			if (GetSourceColumn(Structure) == SourceColumnCoord)
+			{
+				OutStructures.Add(Structure);
+			}
+		}
+	}
+
+}
+
+void FStructureRegistry::TakeSpills(TArray<FSpill>& OutSpills)
+{
+	FScopeLock RegistryLock(&RegistryMutex);
+	OutSpills = MoveTemp(Spills);
+	Spills.Reset();
+}
+
+void FStructureRegistry::ReturnSpills(const TArray<FSpill>& InSpills)
+{
+	FScopeLock RegistryLock(&RegistryMutex);
+	Spills.Append(InSpills);
+}
+
+void FStructureRegistry::Empty()
+{
+	FScopeLock RegistryLock(&RegistryMutex);
+	ColumnStructures.Empty();
+	GeneratedColumns.Empty();
+	RegisteredColumns.Empty();
+	Spills.Empty();
+}
+
+void FStructureRegistry::GetColumnBounds(const FStructurePlacement& Structure, FIntVector2D& OutMinColumn, FIntVector2D& OutMaxColumn)
+{
+	const FStructureTemplate& Template = FStructureLibrary::Get().GetTemplate(Structure.Template);
+	const FIntVector3 Min = Structure.Position + Template.GetMin();
+	const FIntVector3 Max = Structure.Position + Template.GetMax() - 1;
+	OutMinColumn = FIntVector2D(Min.X >> CHUNK_SHIFT, Min.Y >> CHUNK_SHIFT);
+	OutMaxColumn = FIntVector2D(Max.X >> CHUNK_SHIFT, Max.Y >> CHUNK_SHIFT);
+}
+
+FIntVector2D FStructureRegistry::GetSourceColumn(const FStructurePlacement& Structure)
+{
+	return FIntVector2D(Structure.Position.X >> CHUNK_SHIFT, Structure.Position.Y >> CHUNK_SHIFT);
+}
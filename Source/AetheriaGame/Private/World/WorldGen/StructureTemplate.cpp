@@ -0,0 +1,223 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "StructureTemplate.h"
+
+namespace
+{
+
+	/* Structure voxels from the lowest rank to the highest: snow on trees, the leaves, then the trunk */
+	const uint8 RankedVoxels[] = { 3, 11, 13, 14, 12 };
+
+	/* The leaf types of the trees, in the order of their templates */
+	const uint8 LeafTypes[] = { 11, 13, 14 };
+
+	/** The voxels of a tree growing on the voxel at <0, 0, 0> */
+	TArray<TPair<FIntVector3, uint8>> MakeTreeVoxels(uint8 LeafType, bool bSnowOnTrees)
+	{
+		const FIntVector3 TreeTrunk[] =
+		{
+			{ 0, 0, 1 }, { 0, 0, 2 }, { 0, 0, 3 }, { 0, 0, 4 }
+		};
+
+		const FIntVector3 TreeLeaves[] =
+		{
+			{ -1, -1, 5 },{ 0, -1, 5 },{ 1, -1, 5 }, // Square
+			{ -1, 0, 5 },{ 0, 0, 5 },{ 1, 0, 5 },
+			{ -1, 1, 5 },{ 0, 1, 5 },{ 1, 1, 5 },
+
+			{ -1, -1, 6 },{  0, -1, 6 },{ 1, -1, 6 }, // Square
+			{ -1,  0, 6 },{  0,  0, 6 },{ 1,  0, 6 },
+			{ -1,  1, 6 },{  0,  1, 6 },{ 1,  1, 6 },
+			{ -1, -2, 6 },{  0, -2, 6 },{  1, -2, 6 }, // Side
+			{ -1,  2, 6 },{  0,  2, 6 },{  1,  2, 6 },
+			{ -2,  1, 6 },{ -2,  0, 6 },{ -2, -1, 6 },
+			{ 2 ,  1, 6 },{  2,  0, 6 },{  2, -1, 6 },
+
+			{ -1, -1, 7 },{  0, -1, 7 },{ 1, -1, 7 }, // Square
+			{ -1,  0, 7 },{  0,  0, 7 },{ 1,  0, 7 },
+			{ -1,  1, 7 },{  0,  1, 7 },{ 1,  1, 7 },
+			{ -1, -2, 7 },{  0, -2, 7 },{  1, -2, 7 }, // Side
+			{ -1,  2, 7 },{  0,  2, 7 },{  1,  2, 7 },
+			{ -2,  1, 7 },{ -2,  0, 7 },{ -2, -1, 7 },
+			{ 2 ,  1, 7 },{  2,  0, 7 },{  2, -1, 7 },
+
+			{ -1, -1, 8 },{  0, -1, 8 },{ 1, -1, 8 }, // Square
+			{ -1,  0, 8 },{  0,  0, 8 },{ 1,  0, 8 },
+			{ -1,  1, 8 },{  0,  1, 8 },{ 1,  1, 8 },
+			{ -1, -2, 8 },{  0, -2, 8 },{  1, -2, 8 }, // Side
+			{ -1,  2, 8 },{  0,  2, 8 },{  1,  2, 8 },
+			{ -2,  1, 8 },{ -2,  0, 8 },{ -2, -1, 8 },
+			{ 2 ,  1, 8 },{  2,  0, 8 },{  2, -1, 8 },
+
+			{ -1, -1, 9 },{ 0, -1, 9 },{ 1, -1, 9 }, // Square
+			{ -1,  0, 9 },{ 0,  0, 9 },{ 1,  0, 9 },
+			{ -1,  1, 9 },{ 0,  1, 9 },{ 1,  1, 9 }
+		};
+
+		const FIntVector3 Snow[] =
+		{
+			{ -1, -2, 9 },{ 0, -2, 9 },{ 1, -2,  9 },
+			{ -1,  2, 9 },{ 0,  2, 9 },{ 1,  2,  9 },
+			{ -2,  1, 9 },{ -2, 0, 9 },{ -2, -1, 9 },
+			{ 2 ,  1, 9 },{ 2,  0, 9 },{ 2, -1,  9 },
+
+			{ -1, -1, 10 },{ 0, -1, 10 },{ 1, -1, 10 },
+			{ -1,  0, 10 },{ 0,  0, 10 },{ 1,  0, 10 },
+			{ -1,  1, 10 },{ 0,  1, 10 },{ 1,  1, 10 }
+		};
+
+		TArray<TPair<FIntVector3, uint8>> Voxels;
+		for (const FIntVector3& Offset : TreeLeaves)
+		{
+			Voxels.Emplace(Offset, LeafType);
+		}
+		for (const FIntVector3& Offset : TreeTrunk)
+		{
+			Voxels.Emplace(Offset, 12);
+		}
+		if (bSnowOnTrees)
+		{
+			for (const FIntVector3& Offset : Snow)
+			{
+				Voxels.Emplace(Offset, 3);
+			}
+		}
+		return Voxels;
+	}
+
+}
+
+FStructureTemplate::FStructureTemplate(const TArray<TPair<FIntVector3, uint8>>& Voxels)
+{
+
+	check(Voxels.Num() > 0);
+
+	FIntVector3 Max = Voxels[0].Key;
+	Min = Voxels[0].Key;
+	for (const TPair<FIntVector3, uint8>& Voxel : Voxels)
+	{
+		Min = FIntVector3::Min(Min, Voxel.Key);
+		Max = FIntVector3::Max(Max, Voxel.Key);
+	}
+	Size = Max - Min + 1;
+	check(Size.X <= 32);
+
+	// Resolve the voxels that share an offset first, so every offset is in one layer only
+	TArray<uint8> Dense;
+	Dense.SetNumZeroed(Size.X * Size.Y * Size.Z);
+	for (const TPair<FIntVector3, uint8>& Voxel : Voxels)
+	{
+		const FIntVector3 Local = Voxel.Key - Min;
+		Dense[Local.X + Local.Y * Size.X + Local.Z * Size.X * Size.Y] = Voxel.Value;
+	}
+
+	for (int32 i = 0; i < Dense.Num(); ++i)
+	{
+		if (Dense[i] == 0)
+		{
+			continue;
+		}
+
+		FLayer* Layer = Layers.FindByPredicate([&](const FLayer& Existing) { return Existing.Voxel == Dense[i]; });
+		if (Layer == nullptr)
+		{
+			Layer = &Layers[Layers.AddDefaulted()];
+			Layer->Voxel = Dense[i];
+			Layer->Rows.SetNumZeroed(Size.Y * Size.Z);
+		}
+
+		Layer->Rows[i / Size.X] |= 1u << (i % Size.X);
+	}
+
+	Layers.Sort([](const FLayer& A, const FLayer& B) { return GetVoxelRank(A.Voxel) < GetVoxelRank(B.Voxel); });
+
+}
+
+void FStructureTemplate::Stamp(const FIntVector3& Position, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, uint8* Voxels) const
+{
+
+	// The part of the template inside the block, in template space
+	const FIntVector3 Origin = Position + Min;
+	const FIntVector3 ClipMin = FIntVector3::Max(VoxelsOrigin - Origin, FIntVector3(0));
+	const FIntVector3 ClipMax = FIntVector3::Min(VoxelsOrigin + VoxelsSize - Origin, Size);
+	if (ClipMin.X >= ClipMax.X || ClipMin.Y >= ClipMax.Y || ClipMin.Z >= ClipMax.Z)
+	{
+		return;
+	}
+
+	const uint32 ClipMask = (ClipMax.X - ClipMin.X == 32 ? MAX_uint32 : (1u << (ClipMax.X - ClipMin.X)) - 1) << ClipMin.X;
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+	const FIntVector3 Offset = Origin - VoxelsOrigin;
+
+	for (const FLayer& Layer : Layers)
+	{
+		const uint8 Rank = GetVoxelRank(Layer.Voxel);
+
+		for (int32 z = ClipMin.Z; z < ClipMax.Z; ++z)
+		{
+			for (int32 y = ClipMin.Y; y < ClipMax.Y; ++y)
+			{
+				uint32 Bits = Layer.Rows[y + z * Size.Y] & ClipMask;
+				const int32 RowIndex = Offset.X + (Offset.Y + y) * VoxelsSize.X + (Offset.Z + z) * SliceSize;
+
+				while (Bits != 0)
+				{
+					const int32 x = FMath::CountTrailingZeros(Bits);
+					Bits &= Bits - 1;
+
+					uint8& Voxel = Voxels[RowIndex + x];
+					if (GetVoxelRank(Voxel) < Rank)
+					{
+						Voxel = Layer.Voxel;
+					}
+				}
+			}
+		}
+	}
+
+}
+
+uint8 FStructureTemplate::GetVoxelRank(uint8 Voxel)
+{
+	static const struct FRanks
+	{
+		uint8 Ranks[256];
+
+		FRanks()
+		{
+			FMemory::Memzero(Ranks, sizeof(Ranks));
+			for (int32 i = 0; i < (int32)ARRAY_COUNT(RankedVoxels); ++i)
+			{
+				Ranks[RankedVoxels[i]] = (uint8)(i + 1);
+			}
+		}
+	} VoxelRanks;
+
+	return VoxelRanks.Ranks[Voxel];
+}
+
+FStructureLibrary::FStructureLibrary()
+{
+	// Every leaf type, without and with snow
+	for (const uint8 LeafType : LeafTypes)
+	{
+		Templates.Emplace(MakeTreeVoxels(LeafType, false));
+		Templates.Emplace(MakeTreeVoxels(LeafType, true));
+	}
+}
+
+const FStructureLibrary& FStructureLibrary::Get()
+{
+	static FStructureLibrary Library;
+	return Library;
+}
+
+int32 FStructureLibrary::GetTreeTemplate(uint8 LeafType, bool bSnowOnTrees) const
+{
+	int32 LeafIndex = 0;
+	while (LeafIndex < (int32)ARRAY_COUNT(LeafTypes) - 1 && LeafTypes[LeafIndex] != LeafType)
+	{
+		++LeafIndex;
+	}
+	return LeafIndex * 2 + (bSnowOnTrees ? 1 : 0);
+}
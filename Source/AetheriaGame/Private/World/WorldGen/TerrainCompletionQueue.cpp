@@ -0,0 +1,29 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainCompletionQueue.h"
+
+FTerrainCompletionQueue::FTerrainCompletionQueue()
+	: NumColumns(0)
+{
+}
+
+void FTerrainCompletionQueue::Push(TUniquePtr<FChunkColumn>&& Column)
+{
+	FCompletedColumn Completed;
+	Completed.Column = MoveTemp(Column);
+	Completed.GeneratedCycles = FPlatformTime::Cycles();
+
+	FPlatformAtomics::InterlockedIncrement(&NumColumns);
+	Columns.Enqueue(MoveTemp(Completed));
+}
+
+bool FTerrainCompletionQueue::Pop(FCompletedColumn& OutCompleted)
+{
+	if (!Columns.Dequeue(OutCompleted))
+	{
+		return false;
+	}
+
+	FPlatformAtomics::InterlockedDecrement(&NumColumns);
+	return true;
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainGenerationQueue.h"
+
+#include "PlatformProcess.h"
+#include "ScopeLock.h"
+
+FTerrainGenerationQueue::FTerrainGenerationQueue()
+	: bViewersChanged(false), bIsShutdown(false)
+{
+	// Auto reset, so every trigger only wakes up one thread
+	WorkAvailableEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FTerrainGenerationQueue::~FTerrainGenerationQueue()
+{
+	FPlatformProcess::ReturnSynchEventToPool(WorkAvailableEvent);
+	WorkAvailableEvent = nullptr;
+}
+
+void FTerrainGenerationQueue::Enqueue(const FIntVector2D& ColumnCoord)
+{
+	{
+		FScopeLock QueueLock(&QueueMutex);
+
+		bool bIsAlreadyQueued = false;
+		QueuedColumns.Add(ColumnCoord, &bIsAlreadyQueued);
+		if (bIsAlreadyQueued)
+		{
+			return;
+		}
+
+		FEntry Entry;
+		Entry.ColumnCoord = ColumnCoord;
+		Entry.Priority = GetPriority(ColumnCoord);
+		Heap.HeapPush(Entry, FEntryPriority());
+	}
+
+	WorkAvailableEvent->Trigger();
+}
+
+bool FTerrainGenerationQueue::Cancel(const FIntVector2D& ColumnCoord)
+{
+	FScopeLock QueueLock(&QueueMutex);
+
+	// The entry stays in the heap and is skipped when it reaches the top
+	return QueuedColumns.Remove(ColumnCoord) > 0;
+}
+
+void FTerrainGenerationQueue::SetViewers(const TArray<FIntVector2D>& InViewerColumnPositions)
+{
+	FScopeLock QueueLock(&QueueMutex);
+
+	if (ViewerColumnPositions != InViewerColumnPositions)
+	{
+		ViewerColumnPositions = InViewerColumnPositions;
+		bViewersChanged = true;
+	}
+}
+
+bool FTerrainGenerationQueue::WaitAndDequeue(FIntVector2D& OutColumnCoord)
+{
+	while (true)
+	{
+		{
+			FScopeLock QueueLock(&QueueMutex);
+
+			if (bIsShutdown)
+			{
+				// Pass the wake up along so every thread gets to exit
+				WorkAvailableEvent->Trigger();
+				return false;
+			}
+
+			if (PopNext(OutColumnCoord))
+			{
+				// Wake up another thread if there is more work, one trigger may have covered several columns
+				if (QueuedColumns.Num() > 0)
+				{
+					WorkAvailableEvent->Trigger();
+				}
+				return true;
+			}
+		}
+
+		// Pauses this thread until a column is queued
+		WorkAvailableEvent->Wait();
+	}
+}
+
+void FTerrainGenerationQueue::Shutdown()
+{
+	{
+		FScopeLock QueueLock(&QueueMutex);
+		bIsShutdown = true;
+		Heap.Empty();
+		QueuedColumns.Empty();
+	}
+
+	WorkAvailableEvent->Trigger();
+}
+
+int32 FTerrainGenerationQueue::Num() const
+{
+	FScopeLock QueueLock(&QueueMutex);
+	return QueuedColumns.Num();
+}
+
+int32 FTerrainGenerationQueue::GetPriority(const FIntVector2D& ColumnCoord) const
+{
+	if (ViewerColumnPositions.Num() == 0)
+	{
+		return 0;
+	}
+
+	int32 ClosestDistanceSquared = MAX_int32;
+	for (const FIntVector2D& ViewerColumnPosition : ViewerColumnPositions)
+	{
+		const int32 DistanceSquared = FMath::Square<int32>(ColumnCoord.X - ViewerColumnPosition.X) + FMath::Square<int32>(ColumnCoord.Y - ViewerColumnPosition.Y);
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, DistanceSquared);
+	}
+	return ClosestDistanceSquared;
+}
+
+bool FTerrainGenerationQueue::PopNext(FIntVector2D& OutColumnCoord)
+{
+	// Viewers moved, so the order of the whole heap has to be rebuilt
+	if (bViewersChanged)
+	{
+		// Drop cancelled entries while we are at it
+		Heap.RemoveAllSwap([this](const FEntry& Entry) { return !QueuedColumns.Contains(Entry.ColumnCoord); });
+		for (FEntry& Entry : Heap)
+		{
+			Entry.Priority = GetPriority(Entry.ColumnCoord);
+		}
+		Heap.Heapify(FEntryPriority());
+		bViewersChanged = false;
+	}
+
+	while (Heap.Num() > 0)
+	{
+		FEntry Entry;
+		Heap.HeapPop(Entry, FEntryPriority());
+
+		// Skip the column if it was cancelled
+		if (QueuedColumns.Remove(Entry.ColumnCoord) > 0)
+		{
+			OutColumnCoord = Entry.ColumnCoord;
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -1,107 +1,70 @@
-// Copyright (c) 2016, Charles JL Sun, All rights reserved.
-
-#include "TerrainGenerationThread.h"
-
-#include "VoxelTerrain.h"
-
-#include "DebugLibrary.h"
-
-#include "RunnableThread.h"
-#include "PlatformProcess.h"
-#include "ScopedEvent.h"
-#include "Async.h"
-
-FTerrainGenerationThread::FTerrainGenerationThread(AVoxelTerrain* InVoxelTerrain)
-	: VoxelTerrain(InVoxelTerrain)
-{
-	Thread = FRunnableThread::Create(this, TEXT("Terrain Generation Thread"), 0, TPri_Normal);
-	bIsThreadRunning = true;
-	ChunkAddedEvent = nullptr;
-}
-
-FTerrainGenerationThread::~FTerrainGenerationThread()
-{
-	VoxelTerrain = nullptr;
-	ChunkAddedEvent = nullptr;
-
-	delete Thread;
-	Thread = nullptr;
-}
-
-bool FTerrainGenerationThread::Init()
-{
-	return true;
-}
-
-void FTerrainGenerationThread::Stop()
-{
-	bIsThreadRunning = false;
-	if (ChunkAddedEvent != nullptr)
-	{
-		ChunkAddedEvent->Trigger();
-		ChunkAddedEvent = nullptr;
-	}
-}
-
-void FTerrainGenerationThread::EnsureCompletion()
-{
-	Stop();
-	Thread->WaitForCompletion();
-}
-
-uint32 FTerrainGenerationThread::Run()
-{
-
-	FPlatformProcess::Sleep(0.5f);
-
-	while (bIsThreadRunning)
-	{
-		// Runs until out of chunks to generate
-		while (!ChunksToGenerate.IsEmpty())
-		{
-			NextChunk();
-		}
-
-		UDebugLibrary::Println(VoxelTerrain, 10, FString("World Gen Thread"));
-
-		// Pauses this thread until another thread triggers the event
-		FScopedEvent Event;
-		ChunkAddedEvent = Event.Get();
-
-		FPlatformProcess::Sleep(0.5f);
-	}
-
-	return 0;
-
-}
-
-void FTerrainGenerationThread::QueueChunk(const FIntVector3& ChunkCoord)
-{
-
-	ChunksToGenerate.Enqueue(ChunkCoord);
-
-	// Triggers the event so the main loop/thread can update
-	if (ChunkAddedEvent != nullptr)
-	{
-		ChunkAddedEvent->Trigger();
-		ChunkAddedEvent = nullptr;
-	}
-}
-
-void FTerrainGenerationThread::NextChunk()
-{
-	FIntVector3 ChunkCoord;
-	ChunksToGenerate.Dequeue(ChunkCoord);
-
-	// Generates the chunk
-	FChunk Chunk(ChunkCoord);
-	Chunk.Voxels.SetNumUninitialized(1 << (3 * CHUNK_SHIFT));
-	Chunk.HighestSolidVoxels.SetNumUninitialized(1 << (2 * CHUNK_SHIFT));
-	UTerrainGenerator::GenerateChunk(VoxelTerrain, Chunk, VoxelTerrain->TerrainGenParameters);
-
-	// Tells the main game thread to add the chunk to the terrain and send it to the client
-	AsyncTask(ENamedThreads::GameThread, [=]() mutable
-	{
-		VoxelTerrain->AddChunk(Chunk);
-	});
-}
+// Copyright (c) 2016, Charles JL Sun, All rights reserved.
+
+#include "TerrainGenerationThread.h"
+
+#include "TerrainCompletionQueue.h"
+#include "TerrainGenerationQueue.h"
+
+#include "VoxelTerrain.h"
+
+#include "DebugLibrary.h"
+
+#include "RunnableThread.h"
+
+FTerrainGenerationThread::FTerrainGenerationThread(AVoxelTerrain* InVoxelTerrain, FTerrainGenerationQueue* InGenerationQueue, FTerrainCompletionQueue* InCompletionQueue, const int32 ThreadIndex)
+	: VoxelTerrain(InVoxelTerrain), GenerationQueue(InGenerationQueue), CompletionQueue(InCompletionQueue)
+{
+	bIsThreadRunning = true;
+	Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("Terrain Generation Thread %d"), ThreadIndex), 0, TPri_Normal);
+}
+
+FTerrainGenerationThread::~FTerrainGenerationThread()
+{
+	VoxelTerrain = nullptr;
+	GenerationQueue = nullptr;
+	CompletionQueue = nullptr;
+
+	delete Thread;
+	Thread = nullptr;
+}
+
+bool FTerrainGenerationThread::Init()
+{
+	return true;
+}
+
+void FTerrainGenerationThread::Stop()
+{
+	bIsThreadRunning = false;
+}
+
+void FTerrainGenerationThread::EnsureCompletion()
+{
+	Stop();
+	Thread->WaitForCompletion();
+}
+
+uint32 FTerrainGenerationThread::Run()
+{
+
+	FIntVector2D ColumnCoord;
+
+	// Blocks until there is a column to generate, returns false once the queue is shut down
+	while (bIsThreadRunning && GenerationQueue->WaitAndDequeue(ColumnCoord))
+	{
+		GenerateColumn(ColumnCoord);
+	}
+
+	return 0;
+
+}
+
+void FTerrainGenerationThread::GenerateColumn(const FIntVector2D& ColumnCoord)
+{
+	// Generates every chunk in the column in one go
+	TUniquePtr<FChunkColumn> Column(new FChunkColumn(ColumnCoord));
+	UTerrainGenerator::GenerateColumn(VoxelTerrain, ColumnCoord, *Column, VoxelTerrain->TerrainGenParameters);
+
+	// The game thread adds the chunks to the terrain on its next tick, the column is handed over without copying it
+	CompletionQueue->Push(MoveTemp(Column));
+}
\ No newline at end of file
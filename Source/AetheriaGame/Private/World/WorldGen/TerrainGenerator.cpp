@@ -1,306 +1,826 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#include "TerrainGenerator.h"
-
-#include "SimplexNoise.h"
-
-#include "VoxelTerrain.h"
-
-
-void UTerrainGenerator::GenerateChunk(const AVoxelTerrain* const VoxelTerrain, FChunk& Chunk, const FTerrainGeneratorParameters& Parameter)
-{
-
-	const int X_EXTRA = 3;
-	const int Y_EXTRA = 3;
-	const int Z_EXTRA = 11;
-
-	const FIntVector3& LowerBound = Chunk.ChunkPositionInVoxels;
-	const FIntVector3& UpperBound = Chunk.ChunkPositionInVoxels + FIntVector3(CHUNK_SIZE - 1);
-
-	// For trees
-	const FIntVector3& LowerBoundExtra = LowerBound - FIntVector3(X_EXTRA, Y_EXTRA, Z_EXTRA);
-	const FIntVector3& UpperBoundExtra = UpperBound + FIntVector3(X_EXTRA, Y_EXTRA, 0);
-	const FIntVector3& ExtraDiff = UpperBoundExtra - LowerBoundExtra + FIntVector3(1);
-
-	TArray<uint8> ExtraVoxels;
-	ExtraVoxels.SetNumUninitialized(ExtraDiff.X * ExtraDiff.Y * ExtraDiff.Z);
-
-
-	//GET_ROLE(VoxelTerrain->Role, RoleString);
-	//PRINT(*FString::Printf(TEXT("%s - RAN"), *RoleString), 10);
-
-	TArray<FIntVector3> TreePositions;
-	TArray<uint8> LeaveTypes;
-
-	for (int x = LowerBoundExtra.X; x <= UpperBoundExtra.X; ++x)
-	{
-		for (int y = LowerBoundExtra.Y; y <= UpperBoundExtra.Y; ++y)
-		{
-
-			//float Height = 16 * (FMath::Sin((float)x / 16.f) + FMath::Sin((float)y / 16.0f) + 2);
-
-			for (int z = LowerBoundExtra.Z; z <= UpperBoundExtra.Z; ++z)
-			{
-
-				if (z < 0)
-				{
-					continue;
-				}
-
-				const int32 LocalX = x - LowerBoundExtra.X;
-				const int32 LocalY = y - LowerBoundExtra.Y;
-				const int32 LocalZ = z - LowerBoundExtra.Z;
-
-				//uint8 Voxel = z < Height ? 1 : 0;
-
-				// -1 -> 1
-				float Noise;
-				if (!Parameter.bUseRidgedMulti)
-				{
-					Noise = USimplexNoise::Fractal3D((x + Parameter.Seed * 59) * Parameter.NoiseScale, y * Parameter.NoiseScale, z * Parameter.NoiseScale, Parameter.NoiseOctaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity, Parameter.NoisePersistance);
-				}
-				else
-				{
-					Noise = USimplexNoise::RidgedMulti3D((x + Parameter.Seed * 59) * Parameter.NoiseScale, y * Parameter.NoiseScale, 0, Parameter.NoiseOctaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity);
-				}
-
-				// -0.25 - 0.25
-				float ScaledNoise = Noise * 0.25f;
-				// change z from 0 - 64 to 0 - 1
-				float ScaledZ = (float)z / (float)WORLD_HEIGHT;
-
-				float OffsetZ = ScaledZ - ScaledNoise;
-
-				// Determines the voxel
-				uint8 Voxel = 0;
-				if (OffsetZ < 0.5f && OffsetZ >= 0.4f)	Voxel = Parameter.GrassVoxel; // 1 
-				else if (OffsetZ < 0.4f)				Voxel = 2; // 2
-				else									Voxel = 0;
-
-				if (Voxel == 0)
-				{
-					const uint8 VoxelBeneath = (z == LowerBoundExtra.Z || z == 0) ? 0 : ExtraVoxels[LocalX + LocalY * ExtraDiff.X + (LocalZ - 1) * ExtraDiff.X * ExtraDiff.Y];
-					if (VoxelBeneath != 0 && VoxelBeneath != Parameter.SnowVoxel)
-					{
-
-						// This means it is the top voxel
-
-						Voxel = Parameter.SnowVoxel;
-
-						// Check Tree Generation
-						// -1 - 1
-						const float TreeNoise = USimplexNoise::Fractal3D((x + Parameter.Seed * 31) * Parameter.TreeScale, (y + Parameter.Seed * 37) * Parameter.TreeScale, 0, Parameter.TreeOctaves, 1.0f, 2.0f, 0.5f);
-						// 0 - 1
-						const float TreeProb = (TreeNoise + 1.0f) * 0.5f;
-
-						const float ColorNoise = USimplexNoise::Fractal3D((x + Parameter.Seed * 19) * Parameter.TreeScale, (y + Parameter.Seed * 17) * Parameter.TreeScale, 0, Parameter.TreeOctaves, 1.0f, 2.0f, 0.5f);
-
-						if (TreeProb < Parameter.TreeDensity)
-						{
-							TreePositions.Add(FIntVector3(x, y, z));
-
-							if (ColorNoise < -0.5f)
-							{
-								LeaveTypes.Add(11);
-							}
-							else if (ColorNoise < 0.3f)
-							{
-								LeaveTypes.Add(13);
-							}
-							else
-							{
-								LeaveTypes.Add(14);
-							}
-						}
-					}
-				}
-
-				//if (Voxel != 0 && (LocalX == 0 || LocalX == CHUNK_SIZE - 1 || LocalY == 0 || LocalY == CHUNK_SIZE - 1 || LocalZ == 0 || LocalZ == CHUNK_SIZE - 1))
-				//{
-				//	Voxel = 6;
-				//}
-
-				ExtraVoxels[LocalX + LocalY * ExtraDiff.X + LocalZ * ExtraDiff.X * ExtraDiff.Y] = Voxel;
-
-			}
-		}
-	}
-
-	if (Parameter.bCreateTrees)
-	{
-		// Make Trees
-		for (int i = 0; i < TreePositions.Num(); ++i)
-		{
-			if (LeaveTypes[i] == 11)
-			{
-				MakeTree(Parameter, LeaveTypes[i], TreePositions[i], Chunk.ChunkPositionInVoxels, ExtraVoxels);
-			}
-		}
-		for (int i = 0; i < TreePositions.Num(); ++i)
-		{
-			if (LeaveTypes[i] == 13)
-			{
-				MakeTree(Parameter, LeaveTypes[i], TreePositions[i], Chunk.ChunkPositionInVoxels, ExtraVoxels);
-			}
-		}
-		for (int i = 0; i < TreePositions.Num(); ++i)
-		{
-			if (LeaveTypes[i] == 14)
-			{
-				MakeTree(Parameter, LeaveTypes[i], TreePositions[i], Chunk.ChunkPositionInVoxels, ExtraVoxels);
-			}
-		}
-	}
-
-	// Copy the right values in
-	for (int x = 0; x < CHUNK_SIZE; ++x)
-	{
-		for (int y = 0; y < CHUNK_SIZE; ++y)
-		{
-			for (int z = 0; z < CHUNK_SIZE; ++z)
-			{
-				Chunk.Voxels[x + (y << Y_SHIFT) + (z << Z_SHIFT)] = ExtraVoxels[(x + X_EXTRA) + (y + Y_EXTRA) * ExtraDiff.X + (z + Z_EXTRA) * ExtraDiff.X * ExtraDiff.Y];
-			}
-		}
-	}
-
-}
-
-void UTerrainGenerator::MakeTree(const FTerrainGeneratorParameters& Parameter, const uint8 LeafType, const FIntVector3& Position, const FIntVector3& ChunkPosInVoxels, TArray<uint8>& ExtraVoxels)
-{
-
-	const int X_EXTRA = 3;
-	const int Y_EXTRA = 3;
-	const int Z_EXTRA = 11;
-
-	const FIntVector3& LowerBound = ChunkPosInVoxels;
-	const FIntVector3& UpperBound = ChunkPosInVoxels + FIntVector3(CHUNK_SIZE - 1);
-
-	// For trees
-	const FIntVector3& LowerBoundExtra = LowerBound - FIntVector3(X_EXTRA, Y_EXTRA, Z_EXTRA);
-	const FIntVector3& UpperBoundExtra = UpperBound + FIntVector3(X_EXTRA, Y_EXTRA, 0);
-	const FIntVector3& ExtraDiff = UpperBoundExtra - LowerBoundExtra + FIntVector3(1);
-
-	int x = Position.X;
-	int y = Position.Y;
-	int z = Position.Z;
-
-	const TArray<FIntVector3> TreeTrunk =
-	{
-		{ 0, 0, 1 }, { 0, 0, 2 }, { 0, 0, 3 }, { 0, 0, 4 }
-	};
-
-	const TArray<FIntVector3> TreeLeaves =
-	{
-		{ -1, -1, 5 },{ 0, -1, 5 },{ 1, -1, 5 }, // Square
-		{ -1, 0, 5 },{ 0, 0, 5 },{ 1, 0, 5 },
-		{ -1, 1, 5 },{ 0, 1, 5 },{ 1, 1, 5 },
-
-		{ -1, -1, 6 },{  0, -1, 6 },{ 1, -1, 6 }, // Square
-		{ -1,  0, 6 },{  0,  0, 6 },{ 1,  0, 6 },
-		{ -1,  1, 6 },{  0,  1, 6 },{ 1,  1, 6 },
-		{ -1, -2, 6 },{  0, -2, 6 },{  1, -2, 6 }, // Side
-		{ -1,  2, 6 },{  0,  2, 6 },{  1,  2, 6 },
-		{ -2,  1, 6 },{ -2,  0, 6 },{ -2, -1, 6 },
-		{ 2 ,  1, 6 },{  2,  0, 6 },{  2, -1, 6 },
-
-		{ -1, -1, 7 },{  0, -1, 7 },{ 1, -1, 7 }, // Square
-		{ -1,  0, 7 },{  0,  0, 7 },{ 1,  0, 7 },
-		{ -1,  1, 7 },{  0,  1, 7 },{ 1,  1, 7 },
-		{ -1, -2, 7 },{  0, -2, 7 },{  1, -2, 7 }, // Side
-		{ -1,  2, 7 },{  0,  2, 7 },{  1,  2, 7 },
-		{ -2,  1, 7 },{ -2,  0, 7 },{ -2, -1, 7 },
-		{ 2 ,  1, 7 },{  2,  0, 7 },{  2, -1, 7 },
-
-		{ -1, -1, 8 },{  0, -1, 8 },{ 1, -1, 8 }, // Square
-		{ -1,  0, 8 },{  0,  0, 8 },{ 1,  0, 8 },
-		{ -1,  1, 8 },{  0,  1, 8 },{ 1,  1, 8 },
-		{ -1, -2, 8 },{  0, -2, 8 },{  1, -2, 8 }, // Side
-		{ -1,  2, 8 },{  0,  2, 8 },{  1,  2, 8 },
-		{ -2,  1, 8 },{ -2,  0, 8 },{ -2, -1, 8 },
-		{ 2 ,  1, 8 },{  2,  0, 8 },{  2, -1, 8 },
-
-		{ -1, -1, 9 },{ 0, -1, 9 },{ 1, -1, 9 }, // Square
-		{ -1,  0, 9 },{ 0,  0, 9 },{ 1,  0, 9 },
-		{ -1,  1, 9 },{ 0,  1, 9 },{ 1,  1, 9 }
-
-	};
-
-	const TArray<FIntVector3> Snow =
-	{
-		{ -1, -2, 9 },{ 0, -2, 9 },{ 1, -2,  9 },
-		{ -1,  2, 9 },{ 0,  2, 9 },{ 1,  2,  9 },
-		{ -2,  1, 9 },{ -2, 0, 9 },{ -2, -1, 9 },
-		{ 2 ,  1, 9 },{ 2,  0, 9 },{ 2, -1,  9 },
-
-		{ -1, -1, 10 },{ 0, -1, 10 },{ 1, -1, 10 },
-		{ -1,  0, 10 },{ 0,  0, 10 },{ 1,  0, 10 },
-		{ -1,  1, 10 },{ 0,  1, 10 },{ 1,  1, 10 }
-
-	};
-
-	uint8 ExistingType = LeafType;
-
-	for (int i = 0; i < TreeLeaves.Num(); ++i)
-	{
-
-		const int32 LocalX = x - LowerBoundExtra.X + TreeLeaves[i].X;
-		const int32 LocalY = y - LowerBoundExtra.Y + TreeLeaves[i].Y;
-		const int32 LocalZ = z - LowerBoundExtra.Z + TreeLeaves[i].Z;
-
-		if (LocalX >= 0 && LocalX < ExtraDiff.X && LocalY >= 0 && LocalY < ExtraDiff.Y && LocalZ >= 0 && LocalZ < ExtraDiff.Z)
-		{
-			const uint8 CurrType = ExtraVoxels[LocalX + LocalY * ExtraDiff.X + LocalZ * ExtraDiff.X * ExtraDiff.Y];
-			if (CurrType != LeafType && (CurrType == 11 || CurrType == 13 || CurrType == 14))
-			{
-				ExistingType = CurrType;
-				break;
-			}
-		}
-	}
-
-	for (int i = 0; i < TreeLeaves.Num(); ++i)
-	{
-
-		const int32 LocalX = x - LowerBoundExtra.X + TreeLeaves[i].X;
-		const int32 LocalY = y - LowerBoundExtra.Y + TreeLeaves[i].Y;
-		const int32 LocalZ = z - LowerBoundExtra.Z + TreeLeaves[i].Z;
-
-		if (LocalX >= 0 && LocalX < ExtraDiff.X && LocalY >= 0 && LocalY < ExtraDiff.Y && LocalZ >= 0 && LocalZ < ExtraDiff.Z)
-		{
-			ExtraVoxels[LocalX + LocalY * ExtraDiff.X + LocalZ * ExtraDiff.X * ExtraDiff.Y] = ExistingType;
-		}
-	}
-
-	for (int i = 0; i < TreeTrunk.Num(); ++i)
-	{
-
-		const int32 LocalX = x - LowerBoundExtra.X + TreeTrunk[i].X;
-		const int32 LocalY = y - LowerBoundExtra.Y + TreeTrunk[i].Y;
-		const int32 LocalZ = z - LowerBoundExtra.Z + TreeTrunk[i].Z;
-
-		if (LocalX >= 0 && LocalX < ExtraDiff.X && LocalY >= 0 && LocalY < ExtraDiff.Y && LocalZ >= 0 && LocalZ < ExtraDiff.Z)
-		{
-			ExtraVoxels[LocalX + LocalY * ExtraDiff.X + LocalZ * ExtraDiff.X * ExtraDiff.Y] = 12;
-		}
-	}
-
-	if (Parameter.bSnowOnTrees)
-	{
-		for (int i = 0; i < Snow.Num(); ++i)
-		{
-
-			const int32 LocalX = x - LowerBoundExtra.X + Snow[i].X;
-			const int32 LocalY = y - LowerBoundExtra.Y + Snow[i].Y;
-			const int32 LocalZ = z - LowerBoundExtra.Z + Snow[i].Z;
-
-			if (LocalX >= 0 && LocalX < ExtraDiff.X && LocalY >= 0 && LocalY < ExtraDiff.Y && LocalZ >= 0 && LocalZ < ExtraDiff.Z)
-			{
-				ExtraVoxels[LocalX + LocalY * ExtraDiff.X + LocalZ * ExtraDiff.X * ExtraDiff.Y] = 3;
-			}
-		}
-	}
-
-
-}
-
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainGenerator.h"
+
+#include "NoiseGenerator.h"
+#include "NoiseTileCache.h"
+#include "StructureRegistry.h"
+#include "TerrainGeneratorStats.h"
+
+#include "VoxelTerrain.h"
+
+
+namespace
+{
+
+	/** Integer division that rounds towards negative infinity, so negative coordinates land in the right cell */
+	FORCEINLINE int32 FloorDivide(const int32 A, const int32 B)
+	{
+		return A >= 0 ? A / B : -((-A + B - 1) / B);
+	}
+
+	/** Every octave of simplex noise stays inside [-1, 1], scaled by its amplitude, so fractal noise stays inside +- the sum of the amplitudes */
+	float GetFractalNoiseBound(const int32 Octaves, const float Persistence)
+	{
+		float NoiseBound = 0.0f;
+		float Amplitude = 1.0f;
+		for (int32 i = 0; i < Octaves; i++)
+		{
+			NoiseBound += FMath::Abs(Amplitude);
+			Amplitude *= Persistence;
+		}
+		return NoiseBound;
+	}
+
+}
+
+void UTerrainGenerator::GenerateColumn(const AVoxelTerrain* const VoxelTerrain, const FIntVector2D& ColumnCoord, FChunkColumn& OutColumn, const FTerrainGeneratorParameters& Parameter)
+{
+
+	const FIntVector3 LowerBound(ColumnCoord.X << CHUNK_SHIFT, ColumnCoord.Y << CHUNK_SHIFT, 0);
+	const FIntVector3 BlockSize(CHUNK_SIZE, CHUNK_SIZE, WORLD_HEIGHT);
+
+	// The whole height of the column is generated at once. Structures of the neighbors come from the registry,
+	// so no voxels around the column are needed.
+	FNoiseTile Block;
+	GatherNoise(Parameter, ColumnCoord, LowerBound, BlockSize, Block);
+
+	TArray<uint8>& BlockVoxels = Block.Voxels;
+	const int32 AirHeight = Block.AirHeight;
+
+	TArray<FStructurePlacement> Structures;
+	{
+		FTerrainGeneratorStageTimer Timer(ETerrainGeneratorStage::Surface);
+
+		if (Parameter.bCreateTrees)
+		{
+			PlaceSurface<true>(Parameter, LowerBound, BlockSize, AirHeight, Block.Biomes, Block.TreeProbs, Block.ColorNoises, BlockVoxels, Structures);
+		}
+		else
+		{
+			PlaceSurface<false>(Parameter, LowerBound, BlockSize, AirHeight, Block.Biomes, Block.TreeProbs, Block.ColorNoises, BlockVoxels, Structures);
+		}
+	}
+
+	// Snow can only go on the layer at AirHeight. Everything from EmptyHeight up is air, so the chunks up there don't need to be looked at.
+	int32 EmptyHeight = AirHeight + 1;
+
+	{
+		FTerrainGeneratorStageTimer Timer(ETerrainGeneratorStage::Structures);
+
+		// Register the column's structures with the columns they reach into, and get the ones of the neighbors that reach into this one.
+		// Without a registry, like for the default terrain, only the column's own structures are stamped.
+		FStructureRegistry* const Registry = VoxelTerrain != nullptr ? VoxelTerrain->GetStructureRegistry() : nullptr;
+		TArray<FStructurePlacement> ColumnStructures;
+		if (Registry != nullptr)
+		{
+			Registry->AddColumn(ColumnCoord, Structures, ColumnStructures);
+		}
+		else
+		{
+			ColumnStructures = MoveTemp(Structures);
+		}
+
+		const FStructureLibrary& Library = FStructureLibrary::Get();
+		for (const FStructurePlacement& Structure : ColumnStructures)
+		{
+			const FStructureTemplate& Template = Library.GetTemplate(Structure.Template);
+			Template.Stamp(Structure.Position, LowerBound, BlockSize, BlockVoxels.GetData());
+			EmptyHeight = FMath::Max(EmptyHeight, Structure.Position.Z + Template.GetMax().Z);
+		}
+	}
+
+	{
+		FTerrainGeneratorStageTimer Timer(ETerrainGeneratorStage::Chunks);
+
+		// Copy the right values into the chunks and build the heightmaps at the same time
+		OutColumn.ColumnPosition = ColumnCoord;
+		OutColumn.Chunks.Reset(WORLD_HEIGHT_CHUNKS);
+		OutColumn.Heightmap.Init(-1, 1 << (2 * CHUNK_SHIFT));
+
+		for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+		{
+			FChunk& Chunk = *new(OutColumn.Chunks) FChunk(FIntVector3(ColumnCoord.X, ColumnCoord.Y, ChunkZ));
+			Chunk.Voxels.SetNumUninitialized(1 << (3 * CHUNK_SHIFT));
+			Chunk.HighestSolidVoxels.SetNumUninitialized(1 << (2 * CHUNK_SHIFT));
+
+			const int32 ChunkVoxelZ = ChunkZ << CHUNK_SHIFT;
+
+			if (ChunkVoxelZ >= EmptyHeight)
+			{
+				FMemory::Memzero(Chunk.Voxels.GetData(), Chunk.Voxels.Num() * sizeof(uint8));
+				FMemory::Memset(Chunk.HighestSolidVoxels.GetData(), 0xFF, Chunk.HighestSolidVoxels.Num() * sizeof(int8));
+				continue;
+			}
+
+			// The block is as wide as the chunk, so the chunk is one contiguous part of it
+			FMemory::Memcpy(Chunk.Voxels.GetData(), &BlockVoxels[ChunkVoxelZ * CHUNK_SIZE * CHUNK_SIZE], Chunk.Voxels.Num() * sizeof(uint8));
+
+			// Loop through each column until a solid voxel, then set the height to that height
+			for (int32 y = 0; y < CHUNK_SIZE; ++y)
+			{
+				for (int32 x = 0; x < CHUNK_SIZE; ++x)
+				{
+					int8 z = CHUNK_SIZE - 1;
+					for (; z >= 0; --z)
+					{
+						if (Chunk.Voxels[x | (y << Y_SHIFT) | (z << Z_SHIFT)] != 0)
+						{
+							break;
+						}
+					}
+					Chunk.HighestSolidVoxels[x | (y << Y_SHIFT)] = z;
+
+					// Chunks go from bottom to top, so higher chunks overwrite the height
+					if (z >= 0)
+					{
+						OutColumn.Heightmap[x | (y << Y_SHIFT)] = ChunkVoxelZ + z;
+					}
+				}
+			}
+		}
+
+	}
+
+}
+
+void UTerrainGenerator::GatherNoise(const FTerrainGeneratorParameters& Parameter, const FIntVector2D& ColumnCoord, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, FNoiseTile& OutBlock)
+{
+
+	if (!FNoiseTileCache::IsEnabled())
+	{
+		GenerateNoiseTile(Parameter, VoxelsOrigin, VoxelsSize, OutBlock);
+		return;
+	}
+
+	FNoiseTileCache& Cache = Parameter.NoiseTileCache.IsValid() ? *Parameter.NoiseTileCache : FNoiseTileCache::Get();
+	const FNoiseTileKey Key = GetNoiseTileKey(Parameter, ColumnCoord);
+
+	const FNoiseTilePtr Tile = Cache.Find(Key);
+	if (Tile.IsValid())
+	{
+		OutBlock = *Tile;
+		return;
+	}
+
+	// The block gets the surface and the structures written into it, so the cache keeps its own copy
+	GenerateNoiseTile(Parameter, VoxelsOrigin, VoxelsSize, OutBlock);
+	Cache.Add(Key, MakeShareable(new FNoiseTile(OutBlock)));
+
+}
+
+void UTerrainGenerator::GenerateNoiseTile(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, FNoiseTile& OutTile)
+{
+
+	OutTile.Origin = VoxelsOrigin;
+	OutTile.Size = VoxelsSize;
+	OutTile.Voxels.SetNumUninitialized(VoxelsSize.X * VoxelsSize.Y * VoxelsSize.Z);
+
+	// 2D pass, the noise that only depends on <x, y>
+	if (Parameter.bCreateTrees)
+	{
+		FTerrainGeneratorStageTimer Timer(ETerrainGeneratorStage::TreeNoise);
+		GenerateTreeNoise(Parameter, VoxelsOrigin, VoxelsSize, OutTile.TreeProbs, OutTile.ColorNoises);
+	}
+
+	// The heightmap file and the ridged multi terrain don't change with z, so they are heightfields and only need 2D samples.
+	// Otherwise the terrain is volumetric and every voxel needs 3D noise.
+	{
+		FTerrainGeneratorStageTimer Timer(ETerrainGeneratorStage::BaseTerrain);
+
+		if (Parameter.HeightmapSource.IsValid())
+		{
+			FillFromHeightmap(Parameter, VoxelsOrigin, VoxelsSize, OutTile.Voxels, OutTile.AirHeight);
+		}
+		else if (Parameter.BiomeProgram.IsValid())
+		{
+			Parameter.BiomeProgram->Run(VoxelsOrigin, VoxelsSize, OutTile.Voxels, OutTile.Biomes, OutTile.AirHeight);
+		}
+		else if (Parameter.bUseRidgedMulti)
+		{
+			FillHeightfield(Parameter, VoxelsOrigin, VoxelsSize, OutTile.Voxels, OutTile.AirHeight);
+		}
+		else
+		{
+			FillDensity(Parameter, VoxelsOrigin, VoxelsSize, OutTile.Voxels, OutTile.AirHeight);
+		}
+	}
+
+	// Carving only removes voxels, so AirHeight stays an upper bound
+	if (Parameter.bCreateCaves)
+	{
+		FTerrainGeneratorStageTimer Timer(ETerrainGeneratorStage::Caves);
+		CarveCaves(Parameter, VoxelsOrigin, VoxelsSize, OutTile.AirHeight, OutTile.Voxels);
+	}
+
+}
+
+FNoiseTileKey UTerrainGenerator::GetNoiseTileKey(const FTerrainGeneratorParameters& Parameter, const FIntVector2D& ColumnCoord)
+{
+	return FNoiseTileKey(Parameter.Seed, GetNoiseParameterHash(Parameter), ColumnCoord);
+}
+
+uint32 UTerrainGenerator::GetNoiseParameterHash(const FTerrainGeneratorParameters& Parameter)
+{
+
+	// Everything GenerateNoiseTile reads, except the seed which is already part of the key
+	uint32 Hash = (uint32)Parameter.bUseRidgedMulti;
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.NoiseOctaves));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.NoiseFrequency));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.NoiseLacunarity));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.NoisePersistance));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.NoiseScale));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.DensitySampleSpacing));
+	Hash = HashCombine(Hash, (uint32)Parameter.bCreateTrees);
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.TreeScale));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.TreeOctaves));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.GrassVoxel));
+	Hash = HashCombine(Hash, (uint32)Parameter.bCreateCaves);
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CaveScale));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CaveOctaves));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CavePersistence));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CaveThreshold));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CaveMinHeight));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CaveFadeHeight));
+	Hash = HashCombine(Hash, GetTypeHash(Parameter.CaveMaxHeight));
+	Hash = HashCombine(Hash, Parameter.BiomeProgram.IsValid() ? Parameter.BiomeProgram->GetHash() : 0);
+	if (Parameter.HeightmapSource.IsValid())
+	{
+		Hash = HashCombine(Hash, Parameter.HeightmapSource->GetHash());
+		Hash = HashCombine(Hash, GetTypeHash(Parameter.HeightmapOrigin));
+		Hash = HashCombine(Hash, GetTypeHash(Parameter.HeightmapMinHeight));
+		Hash = HashCombine(Hash, GetTypeHash(Parameter.HeightmapMaxHeight));
+		Hash = HashCombine(Hash, GetTypeHash(Parameter.HeightmapGrassDepth));
+	}
+	return Hash;
+
+}
+
+void UTerrainGenerator::GenerateTreeNoise(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<float>& OutTreeProbs, TArray<float>& OutColorNoises)
+{
+
+	const FNoiseGenerator TreeNoise(Parameter.Seed, (uint32)ETerrainNoiseChannel::Tree);
+	const FNoiseGenerator ColorNoise(Parameter.Seed, (uint32)ETerrainNoiseChannel::LeafColor);
+
+	const double StartX = (double)VoxelsOrigin.X * Parameter.TreeScale;
+
+	OutTreeProbs.SetNumUninitialized(VoxelsSize.X * VoxelsSize.Y);
+	OutColorNoises.SetNumUninitialized(VoxelsSize.X * VoxelsSize.Y);
+
+	for (int32 LocalY = 0; LocalY < VoxelsSize.Y; ++LocalY)
+	{
+		const int32 y = VoxelsOrigin.Y + LocalY;
+		const int32 RowIndex = LocalY * VoxelsSize.X;
+
+		// -1 - 1
+		TreeNoise.Fractal3DRow(StartX, Parameter.TreeScale, (double)y * Parameter.TreeScale, 0.0, VoxelsSize.X, &OutTreeProbs[RowIndex], Parameter.TreeOctaves, 1.0f, 2.0f, 0.5f);
+		ColorNoise.Fractal3DRow(StartX, Parameter.TreeScale, (double)y * Parameter.TreeScale, 0.0, VoxelsSize.X, &OutColorNoises[RowIndex], Parameter.TreeOctaves, 1.0f, 2.0f, 0.5f);
+
+		// 0 - 1
+		for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+		{
+			OutTreeProbs[RowIndex + LocalX] = (OutTreeProbs[RowIndex + LocalX] + 1.0f) * 0.5f;
+		}
+	}
+
+}
+
+void UTerrainGenerator::FillHeightfield(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, int32& OutAirHeight)
+{
+
+	const FNoiseGenerator Noise(Parameter.Seed, (uint32)ETerrainNoiseChannel::Density);
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+	const double StartX = (double)VoxelsOrigin.X * Parameter.NoiseScale;
+
+	// The first z of each <x, y> that isn't stone, and the first z that is air
+	TArray<int32> StoneHeights;
+	TArray<int32> GrassHeights;
+	StoneHeights.SetNumUninitialized(SliceSize);
+	GrassHeights.SetNumUninitialized(SliceSize);
+
+	TArray<float> NoiseRow;
+	NoiseRow.SetNumUninitialized(VoxelsSize.X);
+
+	OutAirHeight = 0;
+
+	for (int32 LocalY = 0; LocalY < VoxelsSize.Y; ++LocalY)
+	{
+		const int32 y = VoxelsOrigin.Y + LocalY;
+
+		// -1 -> 1
+		Noise.RidgedMulti3DRow(StartX, Parameter.NoiseScale, (double)y * Parameter.NoiseScale, 0.0, VoxelsSize.X, NoiseRow.GetData(), Parameter.NoiseOctaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity);
+
+		for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+		{
+			// -0.25 - 0.25
+			const float ScaledNoise = NoiseRow[LocalX] * 0.25f;
+
+			// ScaledZ - ScaledNoise only goes up with z, so the voxels are stone, then grass, then air.
+			// The same comparisons as FillDensity are used to find where they change so the result is identical.
+			int32 z = 0;
+			for (; z < VoxelsSize.Z && ((float)z / (float)WORLD_HEIGHT) - ScaledNoise < 0.4f; ++z);
+			StoneHeights[LocalX + LocalY * VoxelsSize.X] = z;
+			for (; z < VoxelsSize.Z && ((float)z / (float)WORLD_HEIGHT) - ScaledNoise < 0.5f; ++z);
+			GrassHeights[LocalX + LocalY * VoxelsSize.X] = z;
+
+			OutAirHeight = FMath::Max(OutAirHeight, z);
+		}
+	}
+
+	// Nothing reaches above the highest grass, so those layers are filled all at once
+	const uint8 GrassVoxel = Parameter.GrassVoxel;
+	for (int32 z = 0; z < OutAirHeight; ++z)
+	{
+		uint8* const Slice = &Voxels[z * SliceSize];
+		for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+		{
+			Slice[ColumnIndex] = z < StoneHeights[ColumnIndex] ? 2 : z < GrassHeights[ColumnIndex] ? GrassVoxel : 0;
+		}
+	}
+
+	if (OutAirHeight < VoxelsSize.Z)
+	{
+		FMemory::Memzero(&Voxels[OutAirHeight * SliceSize], (VoxelsSize.Z - OutAirHeight) * SliceSize);
+	}
+
+}
+
+void UTerrainGenerator::FillFromHeightmap(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, int32& OutAirHeight)
+{
+
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+
+	TArray<uint16> Samples;
+	Samples.SetNumUninitialized(SliceSize);
+	Parameter.HeightmapSource->ReadRect(VoxelsOrigin.X - Parameter.HeightmapOrigin.X, VoxelsOrigin.Y - Parameter.HeightmapOrigin.Y, VoxelsSize.X, VoxelsSize.Y, Samples.GetData());
+
+	// The first z of each <x, y> that isn't stone, and the first z that is air
+	TArray<int32> StoneHeights;
+	TArray<int32> GrassHeights;
+	StoneHeights.SetNumUninitialized(SliceSize);
+	GrassHeights.SetNumUninitialized(SliceSize);
+
+	const float HeightRange = (float)(Parameter.HeightmapMaxHeight - Parameter.HeightmapMinHeight);
+
+	OutAirHeight = 0;
+
+	for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+	{
+		const int32 SurfaceHeight = Parameter.HeightmapMinHeight + FMath::RoundToInt(Samples[ColumnIndex] * HeightRange / 65535.0f);
+		const int32 GrassHeight = FMath::Clamp(SurfaceHeight - VoxelsOrigin.Z, 0, VoxelsSize.Z);
+
+		StoneHeights[ColumnIndex] = FMath::Clamp(SurfaceHeight - Parameter.HeightmapGrassDepth - VoxelsOrigin.Z, 0, GrassHeight);
+		GrassHeights[ColumnIndex] = GrassHeight;
+
+		OutAirHeight = FMath::Max(OutAirHeight, GrassHeight);
+	}
+
+	// Nothing reaches above the highest grass, so those layers are filled all at once
+	const uint8 GrassVoxel = Parameter.GrassVoxel;
+	for (int32 z = 0; z < OutAirHeight; ++z)
+	{
+		uint8* const Slice = &Voxels[z * SliceSize];
+		for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+		{
+			Slice[ColumnIndex] = z < StoneHeights[ColumnIndex] ? 2 : z < GrassHeights[ColumnIndex] ? GrassVoxel : 0;
+		}
+	}
+
+	if (OutAirHeight < VoxelsSize.Z)
+	{
+		FMemory::Memzero(&Voxels[OutAirHeight * SliceSize], (VoxelsSize.Z - OutAirHeight) * SliceSize);
+	}
+
+}
+
+void UTerrainGenerator::FillDensity(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, int32& OutAirHeight)
+{
+
+	const FNoiseGenerator Noise(Parameter.Seed, (uint32)ETerrainNoiseChannel::Density);
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+
+	// The noise is evaluated a row of x at a time, so every row starts at the same x
+	const double StartX = (double)VoxelsOrigin.X * Parameter.NoiseScale;
+
+	// Layers outside of what the noise can reach are all stone or all air, and don't need any noise
+	int32 StoneHeight;
+	int32 AirHeight;
+	GetDensityBounds(Parameter, VoxelsSize.Z, StoneHeight, AirHeight);
+
+	if (StoneHeight > 0)
+	{
+		FMemory::Memset(&Voxels[0], 2, StoneHeight * SliceSize);
+	}
+	if (AirHeight < VoxelsSize.Z)
+	{
+		FMemory::Memzero(&Voxels[AirHeight * SliceSize], (VoxelsSize.Z - AirHeight) * SliceSize);
+	}
+
+	OutAirHeight = AirHeight;
+
+	if (Parameter.DensitySampleSpacing != FIntVector3(1, 1, 1))
+	{
+		InterpolateDensity(Parameter, VoxelsOrigin, VoxelsSize, StoneHeight, AirHeight, Voxels);
+		return;
+	}
+
+	// Band 0 is below 0.4, 1 is from 0.4 to 0.5 and 2 is from 0.5 up
+	const uint8 BandVoxels[] = { 2, Parameter.GrassVoxel, 0 };
+
+	TArray<uint8> BandRow;
+	BandRow.SetNumUninitialized(VoxelsSize.X);
+
+	for (int32 z = StoneHeight; z < AirHeight; ++z)
+	{
+		// change z from 0 - 64 to 0 - 1
+		const float ScaledZ = (float)z / (float)WORLD_HEIGHT;
+
+		for (int32 LocalY = 0; LocalY < VoxelsSize.Y; ++LocalY)
+		{
+
+			const int32 y = VoxelsOrigin.Y + LocalY;
+
+			// OffsetZ = ScaledZ - Noise * 0.25, the octaves stop as soon as OffsetZ can't cross 0.4 or 0.5 anymore
+			Noise.Fractal3DRowBands(StartX, Parameter.NoiseScale, (double)y * Parameter.NoiseScale, (double)z * Parameter.NoiseScale, VoxelsSize.X, BandRow.GetData(), ScaledZ, 0.25f, 0.4f, 0.5f, Parameter.NoiseOctaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity, Parameter.NoisePersistance);
+
+			uint8* const Row = &Voxels[LocalY * VoxelsSize.X + z * SliceSize];
+			for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+			{
+				Row[LocalX] = BandVoxels[BandRow[LocalX]];
+			}
+		}
+	}
+
+}
+
+void UTerrainGenerator::InterpolateDensity(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, const int32 StoneHeight, const int32 AirHeight, TArray<uint8>& Voxels)
+{
+
+	if (StoneHeight >= AirHeight)
+	{
+		return;
+	}
+
+	const FNoiseGenerator Noise(Parameter.Seed, (uint32)ETerrainNoiseChannel::Density);
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+	const FIntVector3 Spacing = FIntVector3::Max(Parameter.DensitySampleSpacing, FIntVector3(1));
+
+	// The lattice is aligned to world coordinates, so neighbor columns sample the same points and match at their borders.
+	// It covers one more sample than the last voxel so every voxel has a sample on both sides.
+	const FIntVector3 First = VoxelsOrigin + FIntVector3(0, 0, StoneHeight);
+	const FIntVector3 Last = VoxelsOrigin + FIntVector3(VoxelsSize.X - 1, VoxelsSize.Y - 1, AirHeight - 1);
+	const FIntVector3 LatticeMin(FloorDivide(First.X, Spacing.X), FloorDivide(First.Y, Spacing.Y), FloorDivide(First.Z, Spacing.Z));
+	const FIntVector3 LatticeMax(FloorDivide(Last.X, Spacing.X) + 1, FloorDivide(Last.Y, Spacing.Y) + 1, FloorDivide(Last.Z, Spacing.Z) + 1);
+	const FIntVector3 LatticeSize = LatticeMax - LatticeMin + 1;
+	const int32 LatticeSliceSize = LatticeSize.X * LatticeSize.Y;
+
+	// Samples of the exact noise, a row at a time
+	const double LatticeStartX = (double)LatticeMin.X * Spacing.X * Parameter.NoiseScale;
+	const double LatticeStepX = (double)Spacing.X * Parameter.NoiseScale;
+
+	TArray<float> Lattice;
+	Lattice.SetNumUninitialized(LatticeSliceSize * LatticeSize.Z);
+	for (int32 k = 0; k < LatticeSize.Z; ++k)
+	{
+		for (int32 j = 0; j < LatticeSize.Y; ++j)
+		{
+			Noise.Fractal3DRow(LatticeStartX, LatticeStepX, (double)((LatticeMin.Y + j) * Spacing.Y) * Parameter.NoiseScale, (double)((LatticeMin.Z + k) * Spacing.Z) * Parameter.NoiseScale,
+				LatticeSize.X, &Lattice[j * LatticeSize.X + k * LatticeSliceSize], Parameter.NoiseOctaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity, Parameter.NoisePersistance);
+		}
+	}
+
+	// The lattice sample before each x and how far the voxel is towards the next one
+	TArray<int32> XIndices;
+	TArray<float> XWeights;
+	XIndices.SetNumUninitialized(VoxelsSize.X);
+	XWeights.SetNumUninitialized(VoxelsSize.X);
+	for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+	{
+		const int32 x = VoxelsOrigin.X + LocalX;
+		const int32 Index = FloorDivide(x, Spacing.X);
+		XIndices[LocalX] = Index - LatticeMin.X;
+		XWeights[LocalX] = (float)(x - Index * Spacing.X) / (float)Spacing.X;
+	}
+
+	// Interpolated one axis at a time, z then y then x, and each step runs over contiguous memory
+	TArray<float> Plane;
+	TArray<float> Row;
+	Plane.SetNumUninitialized(LatticeSliceSize);
+	Row.SetNumUninitialized(LatticeSize.X);
+
+	for (int32 z = StoneHeight; z < AirHeight; ++z)
+	{
+		const int32 WorldZ = VoxelsOrigin.Z + z;
+		const int32 k = FloorDivide(WorldZ, Spacing.Z);
+		const float WeightZ = (float)(WorldZ - k * Spacing.Z) / (float)Spacing.Z;
+
+		const float* const Below = &Lattice[(k - LatticeMin.Z) * LatticeSliceSize];
+		const float* const Above = Below + LatticeSliceSize;
+		for (int32 i = 0; i < LatticeSliceSize; ++i)
+		{
+			Plane[i] = Below[i] + (Above[i] - Below[i]) * WeightZ;
+		}
+
+		const float ScaledZ = (float)z / (float)WORLD_HEIGHT;
+
+		for (int32 LocalY = 0; LocalY < VoxelsSize.Y; ++LocalY)
+		{
+			const int32 y = VoxelsOrigin.Y + LocalY;
+			const int32 j = FloorDivide(y, Spacing.Y);
+			const float WeightY = (float)(y - j * Spacing.Y) / (float)Spacing.Y;
+
+			const float* const Front = &Plane[(j - LatticeMin.Y) * LatticeSize.X];
+			const float* const Back = Front + LatticeSize.X;
+			for (int32 i = 0; i < LatticeSize.X; ++i)
+			{
+				Row[i] = Front[i] + (Back[i] - Front[i]) * WeightY;
+			}
+
+			uint8* const VoxelRow = &Voxels[LocalY * VoxelsSize.X + z * SliceSize];
+			for (int32 LocalX = 0; LocalX < VoxelsSize.X; ++LocalX)
+			{
+				const int32 i = XIndices[LocalX];
+				const float Noise = Row[i] + (Row[i + 1] - Row[i]) * XWeights[LocalX];
+
+				const float OffsetZ = ScaledZ - Noise * 0.25f;
+				VoxelRow[LocalX] = OffsetZ < 0.4f ? 2 : OffsetZ < 0.5f ? Parameter.GrassVoxel : 0;
+			}
+		}
+	}
+
+}
+
+void UTerrainGenerator::GetDensityBounds(const FTerrainGeneratorParameters& Parameter, const int32 Height, int32& OutStoneHeight, int32& OutAirHeight)
+{
+
+	const float NoiseBound = GetFractalNoiseBound(Parameter.NoiseOctaves, Parameter.NoisePersistance);
+
+	// OffsetZ = ScaledZ - Noise * 0.25 is within ScaledZ +- ScaledBound. The margin covers the float rounding of OffsetZ.
+	const float ScaledBound = NoiseBound * 0.25f + 0.0001f;
+
+	// Stone while even the highest OffsetZ is below 0.4
+	OutStoneHeight = 0;
+	while (OutStoneHeight < Height && ((float)OutStoneHeight / (float)WORLD_HEIGHT) + ScaledBound < 0.4f)
+	{
+		++OutStoneHeight;
+	}
+
+	// Air once even the lowest OffsetZ is at least 0.5
+	OutAirHeight = OutStoneHeight;
+	while (OutAirHeight < Height && ((float)OutAirHeight / (float)WORLD_HEIGHT) - ScaledBound < 0.5f)
+	{
+		++OutAirHeight;
+	}
+
+}
+
+FBiomeGraph UTerrainGenerator::MakeBiomeGraph(const FTerrainGeneratorParameters& Parameter)
+{
+
+	FBiomeGraph Graph;
+
+	// OffsetZ = ScaledZ - Noise * 0.25
+	FBiomeNode& Height = Graph.Nodes[Graph.Nodes.AddDefaulted()];
+	Height.Name = TEXT("Height");
+	Height.Type = EBiomeNodeType::Height;
+
+	FBiomeNode& Noise = Graph.Nodes[Graph.Nodes.AddDefaulted()];
+	Noise.Name = TEXT("Density Noise");
+	Noise.Type = Parameter.bUseRidgedMulti ? EBiomeNodeType::RidgedMulti : EBiomeNodeType::Fractal;
+	Noise.Channel = (int32)ETerrainNoiseChannel::Density;
+	Noise.Scale = Parameter.NoiseScale;
+	Noise.Octaves = Parameter.NoiseOctaves;
+	Noise.Frequency = Parameter.NoiseFrequency;
+	Noise.Lacunarity = Parameter.NoiseLacunarity;
+	Noise.Persistence = Parameter.NoisePersistance;
+	Noise.bIgnoreZ = Parameter.bUseRidgedMulti;
+
+	FBiomeNode& Amplitude = Graph.Nodes[Graph.Nodes.AddDefaulted()];
+	Amplitude.Type = EBiomeNodeType::Constant;
+	Amplitude.Value = -0.25f;
+
+	FBiomeNode& ScaledNoise = Graph.Nodes[Graph.Nodes.AddDefaulted()];
+	ScaledNoise.Type = EBiomeNodeType::Multiply;
+	ScaledNoise.InputA = 1;
+	ScaledNoise.InputB = 2;
+
+	FBiomeNode& Density = Graph.Nodes[Graph.Nodes.AddDefaulted()];
+	Density.Name = TEXT("Density");
+	Density.Type = EBiomeNodeType::Add;
+	Density.InputA = 0;
+	Density.InputB = 3;
+
+	FBiome& Biome = Graph.Biomes[Graph.Biomes.AddDefaulted()];
+	Biome.Name = TEXT("Default");
+	Biome.DensityNode = 4;
+	Biome.Layers.Add(FBiomeLayer(0.4f, 2));
+	Biome.Layers.Add(FBiomeLayer(0.5f, Parameter.GrassVoxel));
+	Biome.SurfaceVoxel = Parameter.SnowVoxel;
+	Biome.TreeDensity = Parameter.TreeDensity;
+
+	return Graph;
+
+}
+
+void UTerrainGenerator::CarveCaves(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, const int32 AirHeight, TArray<uint8>& Voxels)
+{
+
+	const int32 BRICK_SIZE = 8;
+
+	const FNoiseGenerator Noise(Parameter.Seed, (uint32)ETerrainNoiseChannel::Cave);
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+
+	// The thresholds are fractions of the largest value the cave noise can reach
+	const float NoiseBound = GetFractalNoiseBound(Parameter.CaveOctaves, Parameter.CavePersistence);
+
+	// The layers that can have caves. A threshold of 1 or more is out of the noise's reach, which is where the fade ends at CaveMaxHeight.
+	// Nothing from AirHeight up is solid, so there is nothing to carve there either.
+	const int32 MinZ = FMath::Max(0, Parameter.CaveMinHeight - VoxelsOrigin.Z);
+	int32 MaxZ = FMath::Min3(VoxelsSize.Z, AirHeight, Parameter.CaveMaxHeight - VoxelsOrigin.Z);
+	if (Parameter.CaveThreshold >= 1.0f)
+	{
+		MaxZ = MinZ;
+	}
+
+	// The threshold of every layer, scaled to the noise
+	TArray<float> Thresholds;
+	Thresholds.SetNumUninitialized(VoxelsSize.Z);
+	const float FadeLength = (float)FMath::Max(1, Parameter.CaveMaxHeight - Parameter.CaveFadeHeight);
+	for (int32 z = MinZ; z < MaxZ; ++z)
+	{
+		const float Fade = FMath::Clamp((float)(VoxelsOrigin.Z + z - Parameter.CaveFadeHeight) / FadeLength, 0.0f, 1.0f);
+		Thresholds[z] = FMath::Lerp(Parameter.CaveThreshold, 1.0f, Fade) * NoiseBound;
+	}
+
+	FTerrainGeneratorStats::FCaveStats CaveStats;
+	FMemory::Memzero(&CaveStats, sizeof(CaveStats));
+
+	TArray<uint8> BandRow;
+	BandRow.SetNumUninitialized(BRICK_SIZE);
+
+	for (int32 ChunkZ = 0; ChunkZ < VoxelsSize.Z; ChunkZ += CHUNK_SIZE)
+	{
+		// Whole chunks above the air or outside of the cave layers
+		++CaveStats.Chunks;
+		const int32 ChunkMinZ = FMath::Max(ChunkZ, MinZ);
+		const int32 ChunkMaxZ = FMath::Min(ChunkZ + CHUNK_SIZE, MaxZ);
+		if (ChunkMinZ >= ChunkMaxZ)
+		{
+			++CaveStats.RejectedChunks;
+			continue;
+		}
+
+		for (int32 BrickZ = ChunkZ; BrickZ < ChunkZ + CHUNK_SIZE; BrickZ += BRICK_SIZE)
+		{
+			const int32 BrickMinZ = FMath::Max(BrickZ, ChunkMinZ);
+			const int32 BrickMaxZ = FMath::Min(BrickZ + BRICK_SIZE, ChunkMaxZ);
+			if (BrickMinZ >= BrickMaxZ)
+			{
+				continue;
+			}
+
+			for (int32 BrickY = 0; BrickY < VoxelsSize.Y; BrickY += BRICK_SIZE)
+			{
+				for (int32 BrickX = 0; BrickX < VoxelsSize.X; BrickX += BRICK_SIZE)
+				{
+					const int32 BrickMaxY = FMath::Min(BrickY + BRICK_SIZE, VoxelsSize.Y);
+					const int32 Width = FMath::Min(BRICK_SIZE, VoxelsSize.X - BrickX);
+
+					// Bricks above the surface have nothing to carve
+					++CaveStats.Bricks;
+					bool bHasSolid = false;
+					for (int32 z = BrickMinZ; z < BrickMaxZ && !bHasSolid; ++z)
+					{
+						for (int32 y = BrickY; y < BrickMaxY && !bHasSolid; ++y)
+						{
+							const uint8* const Row = &Voxels[BrickX + y * VoxelsSize.X + z * SliceSize];
+							for (int32 x = 0; x < Width; ++x)
+							{
+								bHasSolid |= Row[x] != 0;
+							}
+						}
+					}
+					if (!bHasSolid)
+					{
+						++CaveStats.RejectedBricks;
+						continue;
+					}
+
+					const double StartX = (double)(VoxelsOrigin.X + BrickX) * Parameter.CaveScale;
+					for (int32 z = BrickMinZ; z < BrickMaxZ; ++z)
+					{
+						const double ScaledZ = (double)(VoxelsOrigin.Z + z) * Parameter.CaveScale;
+						for (int32 y = BrickY; y < BrickMaxY; ++y)
+						{
+							// Band 2 is the noise at or above the threshold
+							Noise.Fractal3DRowBands(StartX, Parameter.CaveScale, (double)(VoxelsOrigin.Y + y) * Parameter.CaveScale, ScaledZ, Width, BandRow.GetData(), 0.0f, -1.0f, Thresholds[z], Thresholds[z], Parameter.CaveOctaves, 1.0f, 2.0f, Parameter.CavePersistence);
+
+							uint8* const Row = &Voxels[BrickX + y * VoxelsSize.X + z * SliceSize];
+							for (int32 x = 0; x < Width; ++x)
+							{
+								if (BandRow[x] == 2 && Row[x] != 0)
+								{
+									Row[x] = 0;
+									++CaveStats.CarvedVoxels;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	FTerrainGeneratorStats::Get().AddCaves(CaveStats);
+
+}
+
+template <bool bCreateTrees>
+void UTerrainGenerator::PlaceSurface(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, const int32 AirHeight, const TArray<uint8>& Biomes, const TArray<float>& TreeProbs, const TArray<float>& ColorNoises, TArray<uint8>& Voxels, TArray<FStructurePlacement>& OutStructures)
+{
+
+	const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+
+	// The surface rules of every biome. Without a biome graph every column uses the built-in snow and tree density.
+	TArray<FBiomeSurface, TInlineAllocator<8>> Surfaces;
+	TArray<uint8> DefaultBiomes;
+	const FBiomeProgramPtr& Program = Parameter.BiomeProgram;
+	if (Program.IsValid())
+	{
+		for (int32 Biome = 0; Biome < Program->GetNumBiomes(); ++Biome)
+		{
+			Surfaces.Add(Program->GetSurface(Biome));
+		}
+	}
+	else
+	{
+		FBiomeSurface Surface;
+		Surface.SurfaceVoxel = (uint8)Parameter.SnowVoxel;
+		Surface.TreeDensity = Parameter.TreeDensity;
+		Surfaces.Add(Surface);
+		DefaultBiomes.SetNumZeroed(SliceSize);
+	}
+	const uint8* const ColumnBiomes = Program.IsValid() ? Biomes.GetData() : DefaultBiomes.GetData();
+	const FStructureLibrary& Library = FStructureLibrary::Get();
+
+	// The layer of the tree on each <x, y>, -1 without one
+	TArray<int32> TreeHeights;
+	if (bCreateTrees)
+	{
+		TreeHeights.Init(-1, SliceSize);
+	}
+
+	// Nothing is beneath z = 0, so the bottom layer never gets snow.
+	// Above AirHeight there is nothing to put snow on.
+	const int32 SurfaceHeight = FMath::Min(AirHeight + 1, VoxelsSize.Z);
+	for (int32 z = 1; z < SurfaceHeight; ++z)
+	{
+		for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+		{
+			const int32 Index = ColumnIndex + z * SliceSize;
+			if (Voxels[Index] != 0)
+			{
+				continue;
+			}
+
+			// Snow written on the layer below is seen here, so snow never stacks
+			const FBiomeSurface& Surface = Surfaces[ColumnBiomes[ColumnIndex]];
+			const uint8 VoxelBeneath = Voxels[Index - SliceSize];
+			if (VoxelBeneath == 0 || VoxelBeneath == Surface.SurfaceVoxel)
+			{
+				continue;
+			}
+
+			// This means it is the top voxel
+			Voxels[Index] = Surface.SurfaceVoxel;
+
+			// Check Tree Generation. Higher surfaces replace lower ones, so trees don't grow on cave floors.
+			if (bCreateTrees && TreeProbs[ColumnIndex] < Surface.TreeDensity)
+			{
+				// Without a surface voxel the tree grows from the ground itself
+				TreeHeights[ColumnIndex] = Surface.SurfaceVoxel != 0 ? z : z - 1;
+			}
+		}
+	}
+
+	if (bCreateTrees)
+	{
+		for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+		{
+			if (TreeHeights[ColumnIndex] < 0)
+			{
+				continue;
+			}
+
+			const int32 LocalX = ColumnIndex % VoxelsSize.X;
+			const int32 LocalY = ColumnIndex / VoxelsSize.X;
+			const FIntVector3 Position(VoxelsOrigin.X + LocalX, VoxelsOrigin.Y + LocalY, VoxelsOrigin.Z + TreeHeights[ColumnIndex]);
+
+			const float ColorNoise = ColorNoises[ColumnIndex];
+			const uint8 LeafType = ColorNoise < -0.5f ? 11 : (ColorNoise < 0.3f ? 13 : 14);
+			OutStructures.Emplace(Position, Library.GetTreeTemplate(LeafType, Parameter.bSnowOnTrees));
+		}
+	}
+
+}
+
@@ -0,0 +1,657 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+// Development console commands that measure the terrain generator. Results go to the log.
+
+#include "CoreMinimal.h"
+
+#include "BiomeGraph.h"
+#include "NoiseGenerator.h"
+#include "NoiseTileCache.h"
+#include "SimplexNoise.h"
+#include "SimplexNoiseBatch.h"
+#include "TerrainGenerator.h"
+#include "TerrainGeneratorStats.h"
+#include "VoxelTerrain.h"
+
+#include "HAL/IConsoleManager.h"
+
+#if !UE_BUILD_SHIPPING
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// NOISE
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace TerrainGeneratorBenchmarks
+{
+
+	/** Rows as wide as a column, like the generator uses */
+	const int32 NoiseRowWidth = 32;
+
+	void BenchmarkNoise(const TArray<FString>& Args)
+	{
+		const int32 NumRows = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 20000;
+		const int32 Octaves = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 2;
+		const int32 NumPoints = NumRows * NoiseRowWidth;
+
+		const FSimplexNoiseTables& Tables = FSimplexNoiseBatch::GetDefaultTables();
+
+		TArray<float> X;
+		X.SetNumUninitialized(NoiseRowWidth);
+		for (int32 i = 0; i < NoiseRowWidth; ++i)
+		{
+			X[i] = (i + 123 * 59) * 0.01f;
+		}
+
+		// The one point at a time path, which every instruction set is compared against
+		TArray<float> Reference;
+		Reference.SetNumUninitialized(NumPoints);
+
+		const double ReferenceStartTime = FPlatformTime::Seconds();
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			for (int32 i = 0; i < NoiseRowWidth; ++i)
+			{
+				Reference[Row * NoiseRowWidth + i] = USimplexNoise::Fractal3D(X[i], (Row & 255) * 0.01f, (Row >> 8) * 0.01f, Octaves, 1.0f, 2.0f, 0.5f);
+			}
+		}
+		const double ReferenceTime = FPlatformTime::Seconds() - ReferenceStartTime;
+
+		UE_LOG(LogStats, Log, TEXT("Noise Benchmark: %d rows of %d points, %d octaves"), NumRows, NoiseRowWidth, Octaves);
+		UE_LOG(LogStats, Log, TEXT("    Per point: %.2f M points/s"), NumPoints / ReferenceTime / 1000000.0);
+
+		TArray<float> Batch;
+		Batch.SetNumUninitialized(NumPoints);
+
+		const ENoiseInstructionSet DefaultInstructionSet = FSimplexNoiseBatch::GetInstructionSet();
+		for (int32 i = 0; i < (int32)ENoiseInstructionSet::Num; ++i)
+		{
+			const ENoiseInstructionSet InstructionSet = (ENoiseInstructionSet)i;
+			if (!FSimplexNoiseBatch::SetInstructionSet(InstructionSet))
+			{
+				continue;
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Row = 0; Row < NumRows; ++Row)
+			{
+				FSimplexNoiseBatch::Fractal3DRow(Tables, X.GetData(), (Row & 255) * 0.01f, (Row >> 8) * 0.01f, NoiseRowWidth, &Batch[Row * NoiseRowWidth], Octaves, 1.0f, 2.0f, 0.5f);
+			}
+			const double Time = FPlatformTime::Seconds() - StartTime;
+
+			float MaxError = 0.0f;
+			for (int32 Point = 0; Point < NumPoints; ++Point)
+			{
+				MaxError = FMath::Max(MaxError, FMath::Abs(Batch[Point] - Reference[Point]));
+			}
+
+			UE_LOG(LogStats, Log, TEXT("    %s: %.2f M points/s, %.2fx, max error %g%s"), FSimplexNoiseBatch::GetInstructionSetName(InstructionSet),
+				NumPoints / Time / 1000000.0, ReferenceTime / Time, MaxError, InstructionSet == DefaultInstructionSet ? TEXT(" (active)") : TEXT(""));
+		}
+		FSimplexNoiseBatch::SetInstructionSet(DefaultInstructionSet);
+	}
+
+	FAutoConsoleCommand BenchmarkNoiseCommand(
+		TEXT("Aetheria.Benchmark.Noise"),
+		TEXT("Measures points/s of the batch simplex noise for every supported instruction set. Usage: Aetheria.Benchmark.Noise [Rows] [Octaves]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkNoise));
+
+	/** Times one kind of row with the generic and the unrolled kernels, and counts the points where they differ */
+	template <typename FunctionType>
+	void BenchmarkOctaveKernel(const TCHAR* Name, int32 NumRows, int32 Octaves, TArray<float>& Generic, TArray<float>& Fixed, FunctionType Function)
+	{
+		const int32 NumPoints = NumRows * NoiseRowWidth;
+		double Times[2];
+		for (int32 bUseFixed = 0; bUseFixed < 2; ++bUseFixed)
+		{
+			FSimplexNoiseBatch::SetUseFixedOctaveKernels(bUseFixed != 0);
+			float* const Out = (bUseFixed ? Fixed : Generic).GetData();
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Row = 0; Row < NumRows; ++Row)
+			{
+				Function(Row, Out + Row * NoiseRowWidth);
+			}
+			Times[bUseFixed] = FPlatformTime::Seconds() - StartTime;
+		}
+
+		int32 NumMismatches = 0;
+		for (int32 Point = 0; Point < NumPoints; ++Point)
+		{
+			NumMismatches += Generic[Point] != Fixed[Point] ? 1 : 0;
+		}
+
+		UE_LOG(LogStats, Log, TEXT("    %d octaves %s: generic %.2f M points/s, unrolled %.2f M points/s, %.2fx, %d mismatches"), Octaves, Name,
+			NumPoints / Times[0] / 1000000.0, NumPoints / Times[1] / 1000000.0, Times[0] / Times[1], NumMismatches);
+	}
+
+	void BenchmarkOctaveKernels(const TArray<FString>& Args)
+	{
+		const int32 NumRows = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 20000;
+		const int32 NumPoints = NumRows * NoiseRowWidth;
+		const FNoiseGenerator Noise;
+
+		TArray<float> Generic;
+		TArray<float> Fixed;
+		Generic.SetNumUninitialized(NumPoints);
+		Fixed.SetNumUninitialized(NumPoints);
+
+		UE_LOG(LogStats, Log, TEXT("Octave Kernels Benchmark: %d rows of %d points, %s"), NumRows, NoiseRowWidth, FSimplexNoiseBatch::GetInstructionSetName(FSimplexNoiseBatch::GetInstructionSet()));
+
+		const bool bDefaultUseFixed = FSimplexNoiseBatch::GetUseFixedOctaveKernels();
+		for (int32 Octaves = 1; Octaves <= SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES; ++Octaves)
+		{
+			BenchmarkOctaveKernel(TEXT("fractal"), NumRows, Octaves, Generic, Fixed, [&](int32 Row, float* Out)
+			{
+				Noise.Fractal3DRow(1.23, 0.01, (Row & 255) * 0.01, (Row >> 8) * 0.01, NoiseRowWidth, Out, Octaves, 1.0f, 2.0f, 0.5f);
+			});
+
+			// The bands of the density pass, halfway up the range the noise can reach
+			BenchmarkOctaveKernel(TEXT("bands"), NumRows, Octaves, Generic, Fixed, [&](int32 Row, float* Out)
+			{
+				uint8 Bands[NoiseRowWidth];
+				Noise.Fractal3DRowBands(1.23, 0.01, (Row & 255) * 0.01, (Row >> 8) * 0.01, NoiseRowWidth, Bands, 0.45f, 0.25f, 0.4f, 0.5f, Octaves, 1.0f, 2.0f, 0.5f);
+				for (int32 i = 0; i < NoiseRowWidth; ++i)
+				{
+					Out[i] = Bands[i];
+				}
+			});
+
+			BenchmarkOctaveKernel(TEXT("ridged multi"), NumRows, Octaves, Generic, Fixed, [&](int32 Row, float* Out)
+			{
+				Noise.RidgedMulti3DRow(1.23, 0.01, (Row & 255) * 0.01, (Row >> 8) * 0.01, NoiseRowWidth, Out, Octaves, 1.0f, 2.0f);
+			});
+		}
+		FSimplexNoiseBatch::SetUseFixedOctaveKernels(bDefaultUseFixed);
+	}
+
+	FAutoConsoleCommand BenchmarkOctaveKernelsCommand(
+		TEXT("Aetheria.Benchmark.OctaveKernels"),
+		TEXT("Compares the kernels unrolled for every octave count against the generic octave loop, with the active instruction set. Usage: Aetheria.Benchmark.OctaveKernels [Rows]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkOctaveKernels));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// GENERATOR
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void BenchmarkGenerator(const TArray<FString>& Args)
+	{
+		const int32 NumColumnsPerSide = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4;
+		const AVoxelTerrain* const DefaultTerrain = GetDefault<AVoxelTerrain>();
+
+		// Benchmarks the default terrain, with either kind of noise
+		FTerrainGeneratorParameters Parameter = DefaultTerrain->TerrainGenParameters;
+		if (Args.Num() > 1)
+		{
+			Parameter.bUseRidgedMulti = FCString::Atoi(*Args[1]) != 0;
+		}
+
+		FChunkColumn Column;
+
+		// Starts from a cache of its own, so the tiles of the columns generated in game don't make it look faster, and it doesn't throw them away
+		Parameter.NoiseTileCache = MakeShareable(new FNoiseTileCache());
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 ColumnX = 0; ColumnX < NumColumnsPerSide; ++ColumnX)
+		{
+			for (int32 ColumnY = 0; ColumnY < NumColumnsPerSide; ++ColumnY)
+			{
+				UTerrainGenerator::GenerateColumn(DefaultTerrain, FIntVector2D(ColumnX, ColumnY), Column, Parameter);
+			}
+		}
+		const double Time = FPlatformTime::Seconds() - StartTime;
+
+		const int32 NumColumns = NumColumnsPerSide * NumColumnsPerSide;
+		UE_LOG(LogStats, Log, TEXT("Generator Benchmark: %d columns, %s, %s noise"), NumColumns, Parameter.bUseRidgedMulti ? TEXT("ridged multi") : TEXT("fractal"), FSimplexNoiseBatch::GetInstructionSetName(FSimplexNoiseBatch::GetInstructionSet()));
+		UE_LOG(LogStats, Log, TEXT("    %.3f ms per column, %.2f M voxels/s"), Time * 1000.0 / NumColumns, (double)NumColumns * CHUNK_SIZE * CHUNK_SIZE * WORLD_HEIGHT / Time / 1000000.0);
+
+		const FNoiseTileCache::FStats Stats = Parameter.NoiseTileCache->GetStats();
+		const int64 Hits = Stats.Hits;
+		const int64 Misses = Stats.Misses;
+		UE_LOG(LogStats, Log, TEXT("    Noise tile cache: %lld hits, %lld misses, %.1f%% hit rate"), Hits, Misses, Hits + Misses > 0 ? 100.0 * Hits / (Hits + Misses) : 0.0);
+	}
+
+	FAutoConsoleCommand BenchmarkGeneratorCommand(
+		TEXT("Aetheria.Benchmark.Generator"),
+		TEXT("Measures how long it takes to generate a square of columns with the default terrain. Usage: Aetheria.Benchmark.Generator [ColumnsPerSide] [Ridged 0/1]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGenerator));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// OCTAVES
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void BenchmarkOctaves(const TArray<FString>& Args)
+	{
+		const int32 NumSeeds = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 8;
+		const int32 NumColumnsPerSide = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 2;
+		const int32 Octaves = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : GetDefault<AVoxelTerrain>()->TerrainGenParameters.NoiseOctaves;
+
+		FTerrainGeneratorParameters Parameter = GetDefault<AVoxelTerrain>()->TerrainGenParameters;
+		Parameter.NoiseOctaves = Octaves;
+
+		// Only the layers the density pass actually evaluates noise for
+		int32 StoneHeight;
+		int32 AirHeight;
+		UTerrainGenerator::GetDensityBounds(Parameter, WORLD_HEIGHT, StoneHeight, AirHeight);
+
+		TArray<float> NoiseRow;
+		TArray<uint8> BandRow;
+		NoiseRow.SetNumUninitialized(CHUNK_SIZE);
+		BandRow.SetNumUninitialized(CHUNK_SIZE);
+
+		UE_LOG(LogStats, Log, TEXT("Octaves Benchmark: %d seeds, %d columns each, %d octaves, layers %d - %d"), NumSeeds, NumColumnsPerSide * NumColumnsPerSide, Octaves, StoneHeight, AirHeight);
+
+		double TotalFullTime = 0.0;
+		double TotalBandsTime = 0.0;
+
+		for (int32 Seed = 0; Seed < NumSeeds; ++Seed)
+		{
+			Parameter.Seed = Seed;
+			const FNoiseGenerator Noise(Seed, (uint32)ETerrainNoiseChannel::Density);
+
+			int64 NumPoints = 0;
+			int64 OctavesEvaluated = 0;
+			int64 NumMismatches = 0;
+			double FullTime = 0.0;
+			double BandsTime = 0.0;
+
+			for (int32 ColumnX = 0; ColumnX < NumColumnsPerSide; ++ColumnX)
+			{
+				const double StartX = (double)(ColumnX << CHUNK_SHIFT) * Parameter.NoiseScale;
+
+				for (int32 y = 0; y < NumColumnsPerSide << CHUNK_SHIFT; ++y)
+				{
+					for (int32 z = StoneHeight; z < AirHeight; ++z)
+					{
+						const float ScaledZ = (float)z / (float)WORLD_HEIGHT;
+
+						// Every octave, then classified like the generator used to
+						const double FullStartTime = FPlatformTime::Seconds();
+						Noise.Fractal3DRow(StartX, Parameter.NoiseScale, (double)y * Parameter.NoiseScale, (double)z * Parameter.NoiseScale, CHUNK_SIZE, NoiseRow.GetData(), Octaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity, Parameter.NoisePersistance);
+						uint8 FullBands[CHUNK_SIZE];
+						for (int32 i = 0; i < CHUNK_SIZE; ++i)
+						{
+							const float OffsetZ = ScaledZ - NoiseRow[i] * 0.25f;
+							FullBands[i] = OffsetZ < 0.4f ? 0 : OffsetZ < 0.5f ? 1 : 2;
+						}
+						const double BandsStartTime = FPlatformTime::Seconds();
+						OctavesEvaluated += Noise.Fractal3DRowBands(StartX, Parameter.NoiseScale, (double)y * Parameter.NoiseScale, (double)z * Parameter.NoiseScale, CHUNK_SIZE, BandRow.GetData(), ScaledZ, 0.25f, 0.4f, 0.5f, Octaves, Parameter.NoiseFrequency, Parameter.NoiseLacunarity, Parameter.NoisePersistance);
+						const double EndTime = FPlatformTime::Seconds();
+
+						FullTime += BandsStartTime - FullStartTime;
+						BandsTime += EndTime - BandsStartTime;
+
+						for (int32 i = 0; i < CHUNK_SIZE; ++i)
+						{
+							NumMismatches += FullBands[i] != BandRow[i] ? 1 : 0;
+						}
+						NumPoints += CHUNK_SIZE;
+					}
+				}
+			}
+
+			const double AverageOctaves = (double)OctavesEvaluated / FMath::Max<int64>(NumPoints, 1);
+			UE_LOG(LogStats, Log, TEXT("    Seed %d: %.3f octaves on average, %.3f skipped, %.2fx, %lld mismatches"), Seed, AverageOctaves, Octaves - AverageOctaves, FullTime / BandsTime, NumMismatches);
+
+			TotalFullTime += FullTime;
+			TotalBandsTime += BandsTime;
+		}
+
+		UE_LOG(LogStats, Log, TEXT("    Every octave: %.2f ms, with early termination: %.2f ms"), TotalFullTime * 1000.0, TotalBandsTime * 1000.0);
+	}
+
+	FAutoConsoleCommand BenchmarkOctavesCommand(
+		TEXT("Aetheria.Benchmark.Octaves"),
+		TEXT("Measures how many octaves of the density noise are skipped once the voxel is known, for a few seeds. Usage: Aetheria.Benchmark.Octaves [Seeds] [ColumnsPerSide] [Octaves]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkOctaves));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// COARSE DENSITY
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void BenchmarkCoarseDensity(const TArray<FString>& Args)
+	{
+		const int32 SpacingXY = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4;
+		const int32 SpacingZ = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : SpacingXY;
+		const int32 NumColumnsPerSide = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 4;
+		const AVoxelTerrain* const DefaultTerrain = GetDefault<AVoxelTerrain>();
+
+		FTerrainGeneratorParameters ExactParameter = DefaultTerrain->TerrainGenParameters;
+		ExactParameter.bUseRidgedMulti = false;
+		ExactParameter.DensitySampleSpacing = FIntVector3(1, 1, 1);
+
+		FTerrainGeneratorParameters CoarseParameter = ExactParameter;
+		CoarseParameter.DensitySampleSpacing = FIntVector3(SpacingXY, SpacingXY, SpacingZ);
+
+		FChunkColumn ExactColumn;
+		FChunkColumn CoarseColumn;
+
+		double ExactTime = 0.0;
+		double CoarseTime = 0.0;
+		int64 NumVoxels = 0;
+		int64 NumWrongVoxels = 0;
+		int64 NumWrongSolidity = 0;
+		int64 NumHeights = 0;
+		int64 TotalHeightError = 0;
+		int32 MaxHeightError = 0;
+
+		for (int32 ColumnX = 0; ColumnX < NumColumnsPerSide; ++ColumnX)
+		{
+			for (int32 ColumnY = 0; ColumnY < NumColumnsPerSide; ++ColumnY)
+			{
+				const double ExactStartTime = FPlatformTime::Seconds();
+				UTerrainGenerator::GenerateColumn(DefaultTerrain, FIntVector2D(ColumnX, ColumnY), ExactColumn, ExactParameter);
+				const double CoarseStartTime = FPlatformTime::Seconds();
+				UTerrainGenerator::GenerateColumn(DefaultTerrain, FIntVector2D(ColumnX, ColumnY), CoarseColumn, CoarseParameter);
+				const double EndTime = FPlatformTime::Seconds();
+
+				ExactTime += CoarseStartTime - ExactStartTime;
+				CoarseTime += EndTime - CoarseStartTime;
+
+				for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+				{
+					const TArray<uint8>& ExactVoxels = ExactColumn.Chunks[ChunkZ].Voxels;
+					const TArray<uint8>& CoarseVoxels = CoarseColumn.Chunks[ChunkZ].Voxels;
+					for (int32 i = 0; i < ExactVoxels.Num(); ++i)
+					{
+						NumWrongVoxels += ExactVoxels[i] != CoarseVoxels[i] ? 1 : 0;
+						NumWrongSolidity += (ExactVoxels[i] != 0) != (CoarseVoxels[i] != 0) ? 1 : 0;
+					}
+					NumVoxels += ExactVoxels.Num();
+				}
+
+				for (int32 i = 0; i < ExactColumn.Heightmap.Num(); ++i)
+				{
+					const int32 HeightError = FMath::Abs(ExactColumn.Heightmap[i] - CoarseColumn.Heightmap[i]);
+					TotalHeightError += HeightError;
+					MaxHeightError = FMath::Max(MaxHeightError, HeightError);
+				}
+				NumHeights += ExactColumn.Heightmap.Num();
+			}
+		}
+
+		const int32 NumColumns = NumColumnsPerSide * NumColumnsPerSide;
+		UE_LOG(LogStats, Log, TEXT("Coarse Density Benchmark: %d columns, samples every %d x %d x %d voxels"), NumColumns, SpacingXY, SpacingXY, SpacingZ);
+		UE_LOG(LogStats, Log, TEXT("    Exact: %.3f ms per column, coarse: %.3f ms per column, %.2fx"), ExactTime * 1000.0 / NumColumns, CoarseTime * 1000.0 / NumColumns, ExactTime / CoarseTime);
+		UE_LOG(LogStats, Log, TEXT("    %.4f%% of voxels are different, %.4f%% changed between solid and air"), 100.0 * NumWrongVoxels / NumVoxels, 100.0 * NumWrongSolidity / NumVoxels);
+		UE_LOG(LogStats, Log, TEXT("    Surface height is off by %.3f voxels on average, %d at most"), (double)TotalHeightError / NumHeights, MaxHeightError);
+	}
+
+	FAutoConsoleCommand BenchmarkCoarseDensityCommand(
+		TEXT("Aetheria.Benchmark.CoarseDensity"),
+		TEXT("Compares the density terrain sampled on a coarse lattice against sampling every voxel, for speed and error. Usage: Aetheria.Benchmark.CoarseDensity [SpacingXY] [SpacingZ] [ColumnsPerSide]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkCoarseDensity));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// FAR NOISE
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void BenchmarkFarNoise(const TArray<FString>& Args)
+	{
+		const int32 NumRows = 4096;
+		const int32 Octaves = 4;
+
+		// The default tables repeat every 256 cells of the hash, and the simplex grid every 3 along x, so the noise
+		// is exactly the same 768 units further along x, at every octave when the lacunarity is 2.
+		// Far points can be compared against the same points next to the origin, where float is still precise.
+		const double Period = 768.0;
+		const double Distance = Period * (Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000);
+		const int32 NumPoints = NumRows * NoiseRowWidth;
+
+		const FSimplexNoiseTables& Tables = FSimplexNoiseBatch::GetDefaultTables();
+		const FNoiseGenerator Noise;
+
+		TArray<float> NearX;
+		TArray<float> FarX;
+		NearX.SetNumUninitialized(NoiseRowWidth);
+		FarX.SetNumUninitialized(NoiseRowWidth);
+		for (int32 i = 0; i < NoiseRowWidth; ++i)
+		{
+			NearX[i] = (i + 123) * 0.01f;
+			FarX[i] = (float)(Distance + (i + 123) * 0.01);
+		}
+
+		TArray<float> Reference;
+		TArray<float> Floats;
+		TArray<float> Generated;
+		Reference.SetNumUninitialized(NumPoints);
+		Floats.SetNumUninitialized(NumPoints);
+		Generated.SetNumUninitialized(NumPoints);
+
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			FSimplexNoiseBatch::Fractal3DRow(Tables, NearX.GetData(), (Row & 63) * 0.1f, (Row >> 6) * 0.1f, NoiseRowWidth, &Reference[Row * NoiseRowWidth], Octaves, 1.0f, 2.0f, 0.5f);
+		}
+
+		// Coordinates far from the origin as floats, the way the terrain generator used to pass them
+		const double FloatStartTime = FPlatformTime::Seconds();
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			FSimplexNoiseBatch::Fractal3DRow(Tables, FarX.GetData(), (Row & 63) * 0.1f, (Row >> 6) * 0.1f, NoiseRowWidth, &Floats[Row * NoiseRowWidth], Octaves, 1.0f, 2.0f, 0.5f);
+		}
+		const double FloatTime = FPlatformTime::Seconds() - FloatStartTime;
+
+		const double GeneratorStartTime = FPlatformTime::Seconds();
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			Noise.Fractal3DRow(Distance + 123 * 0.01, 0.01, (Row & 63) * 0.1, (Row >> 6) * 0.1, NoiseRowWidth, &Generated[Row * NoiseRowWidth], Octaves, 1.0f, 2.0f, 0.5f);
+		}
+		const double GeneratorTime = FPlatformTime::Seconds() - GeneratorStartTime;
+
+		float FloatMaxError = 0.0f;
+		float GeneratorMaxError = 0.0f;
+		for (int32 Point = 0; Point < NumPoints; ++Point)
+		{
+			FloatMaxError = FMath::Max(FloatMaxError, FMath::Abs(Floats[Point] - Reference[Point]));
+			GeneratorMaxError = FMath::Max(GeneratorMaxError, FMath::Abs(Generated[Point] - Reference[Point]));
+		}
+
+		UE_LOG(LogStats, Log, TEXT("Far Noise Benchmark: %d points, %.0f units from the origin, %d octaves"), NumPoints, Distance, Octaves);
+		UE_LOG(LogStats, Log, TEXT("    Float coordinates: %.2f M points/s, max error %g"), NumPoints / FloatTime / 1000000.0, FloatMaxError);
+		UE_LOG(LogStats, Log, TEXT("    Noise generator: %.2f M points/s, max error %g"), NumPoints / GeneratorTime / 1000000.0, GeneratorMaxError);
+	}
+
+	FAutoConsoleCommand BenchmarkFarNoiseCommand(
+		TEXT("Aetheria.Benchmark.FarNoise"),
+		TEXT("Compares the precision and speed of noise far from the origin with float coordinates and with FNoiseGenerator. Usage: Aetheria.Benchmark.FarNoise [Periods of 768 units]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkFarNoise));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// BIOME GRAPH
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** Generates a square of columns from a cold noise tile cache of their own, the one the game uses is left alone */
+	double GenerateColumns(const AVoxelTerrain* const Terrain, const FTerrainGeneratorParameters& Parameter, int32 NumColumnsPerSide, TArray<FChunkColumn>& OutColumns)
+	{
+		FTerrainGeneratorParameters ColdParameter = Parameter;
+		ColdParameter.NoiseTileCache = MakeShareable(new FNoiseTileCache());
+		OutColumns.SetNum(NumColumnsPerSide * NumColumnsPerSide);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 ColumnX = 0; ColumnX < NumColumnsPerSide; ++ColumnX)
+		{
+			for (int32 ColumnY = 0; ColumnY < NumColumnsPerSide; ++ColumnY)
+			{
+				UTerrainGenerator::GenerateColumn(Terrain, FIntVector2D(ColumnX, ColumnY), OutColumns[ColumnX * NumColumnsPerSide + ColumnY], ColdParameter);
+			}
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	/** Plains, ridged mountains and dunes, picked by a slow 2D noise */
+	FBiomeGraph MakeExampleBiomeGraph(const FTerrainGeneratorParameters& Parameter)
+	{
+		FBiomeGraph Graph;
+		TArray<FBiomeNode>& Nodes = Graph.Nodes;
+		Nodes.SetNum(13);
+
+		Nodes[0].Type = EBiomeNodeType::Height;
+
+		Nodes[1].Name = TEXT("Selector");
+		Nodes[1].Type = EBiomeNodeType::Fractal;
+		Nodes[1].Channel = 3;
+		Nodes[1].Scale = 0.002f;
+		Nodes[1].Octaves = 2;
+		Nodes[1].bIgnoreZ = true;
+
+		// Plains, the built-in terrain with flatter hills
+		Nodes[2].Name = TEXT("Plains Noise");
+		Nodes[2].Type = EBiomeNodeType::Fractal;
+		Nodes[2].Channel = (int32)ETerrainNoiseChannel::Density;
+		Nodes[2].Scale = Parameter.NoiseScale;
+		Nodes[2].Octaves = Parameter.NoiseOctaves;
+		Nodes[3].Value = -0.15f;
+		Nodes[4].Type = EBiomeNodeType::Multiply;
+		Nodes[4].InputA = 2;
+		Nodes[4].InputB = 3;
+		Nodes[5].Type = EBiomeNodeType::Add;
+		Nodes[5].InputA = 0;
+		Nodes[5].InputB = 4;
+
+		// Mountains, a tall heightfield
+		Nodes[6].Name = TEXT("Mountain Noise");
+		Nodes[6].Type = EBiomeNodeType::RidgedMulti;
+		Nodes[6].Channel = 4;
+		Nodes[6].Scale = 0.005f;
+		Nodes[6].Octaves = 4;
+		Nodes[6].bIgnoreZ = true;
+		Nodes[7].Value = -0.5f;
+		Nodes[8].Type = EBiomeNodeType::Multiply;
+		Nodes[8].InputA = 6;
+		Nodes[8].InputB = 7;
+		Nodes[9].Type = EBiomeNodeType::Add;
+		Nodes[9].InputA = 0;
+		Nodes[9].InputB = 8;
+
+		// Dunes, a low heightfield shaped by a curve
+		Nodes[10].Name = TEXT("Dune Noise");
+		Nodes[10].Type = EBiomeNodeType::Fractal;
+		Nodes[10].Channel = 5;
+		Nodes[10].Scale = 0.004f;
+		Nodes[10].Octaves = 2;
+		Nodes[10].bIgnoreZ = true;
+		Nodes[11].Type = EBiomeNodeType::Curve;
+		Nodes[11].InputA = 10;
+		Nodes[11].CurvePoints = { FVector2D(-1.0f, 0.02f), FVector2D(0.0f, 0.0f), FVector2D(1.0f, -0.08f) };
+		Nodes[12].Type = EBiomeNodeType::Add;
+		Nodes[12].InputA = 0;
+		Nodes[12].InputB = 11;
+
+		Graph.SelectorNode = 1;
+		Graph.Biomes.SetNum(3);
+
+		Graph.Biomes[0].Name = TEXT("Plains");
+		Graph.Biomes[0].MaxSelector = -0.2f;
+		Graph.Biomes[0].DensityNode = 5;
+		Graph.Biomes[0].Layers = { FBiomeLayer(0.4f, 2), FBiomeLayer(0.5f, Parameter.GrassVoxel) };
+		Graph.Biomes[0].TreeDensity = Parameter.TreeDensity;
+
+		Graph.Biomes[1].Name = TEXT("Mountains");
+		Graph.Biomes[1].MaxSelector = 0.3f;
+		Graph.Biomes[1].DensityNode = 9;
+		Graph.Biomes[1].Layers = { FBiomeLayer(0.55f, 2) };
+		Graph.Biomes[1].SurfaceVoxel = Parameter.SnowVoxel;
+
+		Graph.Biomes[2].Name = TEXT("Dunes");
+		Graph.Biomes[2].DensityNode = 12;
+		Graph.Biomes[2].Layers = { FBiomeLayer(0.38f, 2), FBiomeLayer(0.45f, Parameter.GrassVoxel) };
+
+		return Graph;
+	}
+
+	void BenchmarkBiomeGraph(const TArray<FString>& Args)
+	{
+		const int32 NumColumnsPerSide = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4;
+		const AVoxelTerrain* const DefaultTerrain = GetDefault<AVoxelTerrain>();
+
+		FTerrainGeneratorParameters BuiltInParameter = DefaultTerrain->TerrainGenParameters;
+		BuiltInParameter.DensitySampleSpacing = FIntVector3(1, 1, 1);
+		BuiltInParameter.BiomeProgram.Reset();
+
+		// The built-in terrain written as a graph has to generate exactly the same voxels
+		FString Error;
+		FTerrainGeneratorParameters GraphParameter = BuiltInParameter;
+		GraphParameter.BiomeProgram = FBiomeProgram::Compile(UTerrainGenerator::MakeBiomeGraph(BuiltInParameter), BuiltInParameter.Seed, Error);
+		if (!GraphParameter.BiomeProgram.IsValid())
+		{
+			UE_LOG(LogStats, Warning, TEXT("Biome Graph Benchmark: the built-in graph doesn't compile: %s"), *Error);
+			return;
+		}
+
+		TArray<FChunkColumn> BuiltInColumns;
+		TArray<FChunkColumn> GraphColumns;
+		const double BuiltInTime = GenerateColumns(DefaultTerrain, BuiltInParameter, NumColumnsPerSide, BuiltInColumns);
+		const double GraphTime = GenerateColumns(DefaultTerrain, GraphParameter, NumColumnsPerSide, GraphColumns);
+
+		int64 NumMismatches = 0;
+		for (int32 Column = 0; Column < BuiltInColumns.Num(); ++Column)
+		{
+			for (int32 ChunkZ = 0; ChunkZ < WORLD_HEIGHT_CHUNKS; ++ChunkZ)
+			{
+				const TArray<uint8>& BuiltInVoxels = BuiltInColumns[Column].Chunks[ChunkZ].Voxels;
+				const TArray<uint8>& GraphVoxels = GraphColumns[Column].Chunks[ChunkZ].Voxels;
+				for (int32 i = 0; i < BuiltInVoxels.Num(); ++i)
+				{
+					NumMismatches += BuiltInVoxels[i] != GraphVoxels[i] ? 1 : 0;
+				}
+			}
+		}
+
+		const int32 NumColumns = NumColumnsPerSide * NumColumnsPerSide;
+		UE_LOG(LogStats, Log, TEXT("Biome Graph Benchmark: %d columns, %s noise"), NumColumns, BuiltInParameter.bUseRidgedMulti ? TEXT("ridged multi") : TEXT("fractal"));
+		UE_LOG(LogStats, Log, TEXT("    Built-in: %.3f ms per column, same terrain as a graph: %.3f ms per column, %lld voxels differ"), BuiltInTime * 1000.0 / NumColumns, GraphTime * 1000.0 / NumColumns, NumMismatches);
+
+		FTerrainGeneratorParameters ExampleParameter = BuiltInParameter;
+		ExampleParameter.BiomeProgram = FBiomeProgram::Compile(MakeExampleBiomeGraph(BuiltInParameter), BuiltInParameter.Seed, Error);
+		if (!ExampleParameter.BiomeProgram.IsValid())
+		{
+			UE_LOG(LogStats, Warning, TEXT("    The example graph doesn't compile: %s"), *Error);
+			return;
+		}
+
+		TArray<FChunkColumn> ExampleColumns;
+		const double ExampleTime = GenerateColumns(DefaultTerrain, ExampleParameter, NumColumnsPerSide, ExampleColumns);
+		UE_LOG(LogStats, Log, TEXT("    Plains, mountains and dunes: %.3f ms per column"), ExampleTime * 1000.0 / NumColumns);
+
+		ExampleParameter.BiomeProgram->LogProfile();
+	}
+
+	FAutoConsoleCommand BenchmarkBiomeGraphCommand(
+		TEXT("Aetheria.Benchmark.BiomeGraph"),
+		TEXT("Checks the compiled biome graph of the built-in terrain against the built-in generator, then times and profiles a graph with three biomes. Usage: Aetheria.Benchmark.BiomeGraph [ColumnsPerSide]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBiomeGraph));
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// CAVES
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void BenchmarkCaves(const TArray<FString>& Args)
+	{
+		const int32 NumColumnsPerSide = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4;
+		const int32 NumColumns = NumColumnsPerSide * NumColumnsPerSide;
+		const AVoxelTerrain* const DefaultTerrain = GetDefault<AVoxelTerrain>();
+
+		FTerrainGeneratorParameters Parameter = DefaultTerrain->TerrainGenParameters;
+		TArray<FChunkColumn> Columns;
+
+		Parameter.bCreateCaves = false;
+		const double WithoutTime = GenerateColumns(DefaultTerrain, Parameter, NumColumnsPerSide, Columns);
+
+		// Only the columns with caves go into the stage breakdown
+		FTerrainGeneratorStats& Stats = FTerrainGeneratorStats::Get();
+		Stats.Reset();
+		Parameter.bCreateCaves = true;
+		const double WithTime = GenerateColumns(DefaultTerrain, Parameter, NumColumnsPerSide, Columns);
+
+		UE_LOG(LogStats, Log, TEXT("Caves Benchmark: %d columns, %.3f ms per column without caves, %.3f ms per column with caves"), NumColumns, WithoutTime * 1000.0 / NumColumns, WithTime * 1000.0 / NumColumns);
+
+		Stats.Log();
+	}
+
+	FAutoConsoleCommand BenchmarkCavesCommand(
+		TEXT("Aetheria.Benchmark.Caves"),
+		TEXT("Times a square of columns of the default terrain without and with caves, and logs the cost of every stage with caves. Usage: Aetheria.Benchmark.Caves [ColumnsPerSide]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkCaves));
+
+}
+
+#endif
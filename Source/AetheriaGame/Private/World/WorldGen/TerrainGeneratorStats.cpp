@@ -0,0 +1,150 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainGeneratorStats.h"
+
+#include "HAL/IConsoleManager.h"
+
+FTerrainGeneratorStats::FTerrainGeneratorStats()
+{
+	Reset();
+}
+
+FTerrainGeneratorStats& FTerrainGeneratorStats::Get()
+{
+	static FTerrainGeneratorStats Stats;
+	return Stats;
+}
+
+void FTerrainGeneratorStats::AddStage(ETerrainGeneratorStage Stage, uint32 Cycles)
+{
+	FStageStats& StageStats = Stages[(int32)Stage];
+	FPlatformAtomics::InterlockedAdd(&StageStats.Cycles, (int64)Cycles);
+	FPlatformAtomics::InterlockedIncrement(&StageStats.Count);
+}
+
+void FTerrainGeneratorStats::AddCaves(const FCaveStats& InCaves)
+{
+	FPlatformAtomics::InterlockedAdd(&Caves.Chunks, InCaves.Chunks);
+	FPlatformAtomics::InterlockedAdd(&Caves.RejectedChunks, InCaves.RejectedChunks);
+	FPlatformAtomics::InterlockedAdd(&Caves.Bricks, InCaves.Bricks);
+	FPlatformAtomics::InterlockedAdd(&Caves.RejectedBricks, InCaves.RejectedBricks);
+	FPlatformAtomics::InterlockedAdd(&Caves.CarvedVoxels, InCaves.CarvedVoxels);
+}
+
+void FTerrainGeneratorStats::AddResidentLatency(uint32 Cycles)
+{
+	FPlatformAtomics::InterlockedIncrement(&ResidentLatency.Columns);
+	FPlatformAtomics::InterlockedAdd(&ResidentLatency.Cycles, (int64)Cycles);
+
+	int64 MaxCycles = ResidentLatency.MaxCycles;
+	while ((int64)Cycles > MaxCycles)
+	{
+		const int64 PreviousMaxCycles = FPlatformAtomics::InterlockedCompareExchange(&ResidentLatency.MaxCycles, (int64)Cycles, MaxCycles);
+		if (PreviousMaxCycles == MaxCycles)
+		{
+			break;
+		}
+		MaxCycles = PreviousMaxCycles;
+	}
+}
+
+FTerrainGeneratorStats::FStageStats FTerrainGeneratorStats::GetStage(ETerrainGeneratorStage Stage) const
+{
+	return Stages[(int32)Stage];
+}
+
+FTerrainGeneratorStats::FCaveStats FTerrainGeneratorStats::GetCaves() const
+{
+	return Caves;
+}
+
+FTerrainGeneratorStats::FLatencyStats FTerrainGeneratorStats::GetResidentLatency() const
+{
+	return ResidentLatency;
+}
+
+void FTerrainGeneratorStats::Reset()
+{
+	for (FStageStats& StageStats : Stages)
+	{
+		FPlatformAtomics::InterlockedExchange(&StageStats.Cycles, 0);
+		FPlatformAtomics::InterlockedExchange(&StageStats.Count, 0);
+	}
+	FPlatformAtomics::InterlockedExchange(&Caves.Chunks, 0);
+	FPlatformAtomics::InterlockedExchange(&Caves.RejectedChunks, 0);
+	FPlatformAtomics::InterlockedExchange(&Caves.Bricks, 0);
+	FPlatformAtomics::InterlockedExchange(&Caves.RejectedBricks, 0);
+	FPlatformAtomics::InterlockedExchange(&Caves.CarvedVoxels, 0);
+	FPlatformAtomics::InterlockedExchange(&ResidentLatency.Columns, 0);
+	FPlatformAtomics::InterlockedExchange(&ResidentLatency.Cycles, 0);
+	FPlatformAtomics::InterlockedExchange(&ResidentLatency.MaxCycles, 0);
+}
+
+const TCHAR* FTerrainGeneratorStats::GetStageName(ETerrainGeneratorStage Stage)
+{
+	switch (Stage)
+	{
+	case ETerrainGeneratorStage::BaseTerrain: return TEXT("Base Terrain");
+	case ETerrainGeneratorStage::TreeNoise: return TEXT("Tree Noise");
+	case ETerrainGeneratorStage::Caves: return TEXT("Caves");
+	case ETerrainGeneratorStage::Surface: return TEXT("Surface");
+	case ETerrainGeneratorStage::Structures: return TEXT("Structures");
+	case ETerrainGeneratorStage::Chunks: return TEXT("Chunks");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FTerrainGeneratorStats::Log() const
+{
+	double TotalMs = 0.0;
+	for (int32 Stage = 0; Stage < (int32)ETerrainGeneratorStage::Num; ++Stage)
+	{
+		TotalMs += GetStage((ETerrainGeneratorStage)Stage).Cycles * FPlatformTime::GetSecondsPerCycle() * 1000.0;
+	}
+	const double BaseMs = GetStage(ETerrainGeneratorStage::BaseTerrain).Cycles * FPlatformTime::GetSecondsPerCycle() * 1000.0;
+
+	UE_LOG(LogStats, Log, TEXT("Terrain Generator: %.2f ms over every thread"), TotalMs);
+	for (int32 Stage = 0; Stage < (int32)ETerrainGeneratorStage::Num; ++Stage)
+	{
+		const FStageStats StageStats = GetStage((ETerrainGeneratorStage)Stage);
+		const double StageMs = StageStats.Cycles * FPlatformTime::GetSecondsPerCycle() * 1000.0;
+		UE_LOG(LogStats, Log, TEXT("    %-12s %9.2f ms %5.1f%% %6.2fx base, %lld runs, %.3f ms each"),
+			GetStageName((ETerrainGeneratorStage)Stage), StageMs,
+			TotalMs > 0.0 ? StageMs / TotalMs * 100.0 : 0.0, BaseMs > 0.0 ? StageMs / BaseMs : 0.0,
+			StageStats.Count, StageStats.Count > 0 ? StageMs / StageStats.Count : 0.0);
+	}
+
+	const FCaveStats CaveStats = GetCaves();
+	UE_LOG(LogStats, Log, TEXT("    Caves: %lld of %lld chunks rejected, %lld of %lld bricks rejected, %lld voxels carved"),
+		CaveStats.RejectedChunks, CaveStats.Chunks, CaveStats.RejectedBricks, CaveStats.Bricks, CaveStats.CarvedVoxels);
+
+	const FLatencyStats LatencyStats = GetResidentLatency();
+	const double MsPerCycle = FPlatformTime::GetSecondsPerCycle() * 1000.0;
+	UE_LOG(LogStats, Log, TEXT("    Generated to loaded: %lld columns, %.2f ms average, %.2f ms max"), LatencyStats.Columns,
+		LatencyStats.Columns > 0 ? LatencyStats.Cycles * MsPerCycle / LatencyStats.Columns : 0.0, LatencyStats.MaxCycles * MsPerCycle);
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+
+	void LogTerrainGeneratorStats(const TArray<FString>& Args)
+	{
+		FTerrainGeneratorStats& Stats = FTerrainGeneratorStats::Get();
+		Stats.Log();
+
+		if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+		{
+			Stats.Reset();
+		}
+	}
+
+	FAutoConsoleCommand LogTerrainGeneratorStatsCommand(
+		TEXT("Aetheria.TerrainGenerator.Stats"),
+		TEXT("Logs how long every stage of the terrain generator took. Usage: Aetheria.TerrainGenerator.Stats [Reset]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&LogTerrainGeneratorStats));
+
+}
+
+#endif
@@ -0,0 +1,211 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#include "TerrainPreviewCommandlet.h"
+
+#include "BiomeGraph.h"
+#include "HeightmapSource.h"
+#include "TerrainGenerator.h"
+#include "VoxelTerrain.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+namespace
+{
+
+	/** What is seen from above every <x, y> of a column */
+	struct FPreviewColumn
+	{
+		TArray<int32> Heights;
+		TArray<uint8> Voxels;
+	};
+
+	/**
+	*  Finds the height and the voxel seen from above of every <x, y> of a column, the same ones the surface pass of the generator makes.
+	*  The heightmap terrain is read straight from the file, the others only evaluate their biome program from the top down to the ground.
+	*/
+	void PreviewColumn(const FTerrainGeneratorParameters& Parameter, const FBiomeProgram& Program, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, FPreviewColumn& OutColumn)
+	{
+		const int32 SliceSize = VoxelsSize.X * VoxelsSize.Y;
+
+		TArray<uint8> Biomes;
+		if (Parameter.HeightmapSource.IsValid())
+		{
+			TArray<uint16> Samples;
+			Samples.SetNumUninitialized(SliceSize);
+			Parameter.HeightmapSource->ReadRect(VoxelsOrigin.X - Parameter.HeightmapOrigin.X, VoxelsOrigin.Y - Parameter.HeightmapOrigin.Y, VoxelsSize.X, VoxelsSize.Y, Samples.GetData());
+
+			const float HeightRange = (float)(Parameter.HeightmapMaxHeight - Parameter.HeightmapMinHeight);
+
+			OutColumn.Heights.SetNumUninitialized(SliceSize);
+			OutColumn.Voxels.SetNumUninitialized(SliceSize);
+			Biomes.SetNumZeroed(SliceSize);
+			for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+			{
+				const int32 SurfaceHeight = Parameter.HeightmapMinHeight + FMath::RoundToInt(Samples[ColumnIndex] * HeightRange / 65535.0f);
+				OutColumn.Heights[ColumnIndex] = FMath::Clamp(SurfaceHeight, 0, VoxelsSize.Z);
+				OutColumn.Voxels[ColumnIndex] = Parameter.HeightmapGrassDepth > 0 ? (uint8)Parameter.GrassVoxel : 2;
+			}
+		}
+		else
+		{
+			Program.RunSurface(VoxelsOrigin, VoxelsSize, OutColumn.Heights, OutColumn.Voxels, Biomes);
+		}
+
+		// The surface voxel goes on top of the ground, like UTerrainGenerator::PlaceSurface does.
+		// The heightmap terrain has no biomes, so it gets the built-in snow.
+		for (int32 ColumnIndex = 0; ColumnIndex < SliceSize; ++ColumnIndex)
+		{
+			const int32 Height = OutColumn.Heights[ColumnIndex];
+			const uint8 SurfaceVoxel = Parameter.HeightmapSource.IsValid() ? (uint8)Parameter.SnowVoxel : Program.GetSurface(Biomes[ColumnIndex]).SurfaceVoxel;
+			if (Height > 0 && Height < VoxelsSize.Z && SurfaceVoxel != 0 && OutColumn.Voxels[ColumnIndex] != SurfaceVoxel)
+			{
+				OutColumn.Heights[ColumnIndex] = Height + 1;
+				OutColumn.Voxels[ColumnIndex] = SurfaceVoxel;
+			}
+		}
+	}
+
+	/** The color of a voxel type, shaded darker the lower it is */
+	FColor GetPreviewColor(const TArray<FVoxelType>& VoxelTypes, uint8 Voxel, int32 Height)
+	{
+		if (Height == 0)
+		{
+			return FColor::Black;
+		}
+
+		// Voxel types are usually set up in a blueprint, the ones that aren't get a color of their own
+		const FLinearColor Color = VoxelTypes.IsValidIndex(Voxel)
+			? FLinearColor(VoxelTypes[Voxel].VoxelColor)
+			: FLinearColor::MakeFromHSV8((uint8)(Voxel * 47), 160, 200);
+
+		const float Shade = 0.4f + 0.6f * (float)Height / (float)WORLD_HEIGHT;
+		return (Color * Shade).CopyWithNewOpacity(1.0f).ToFColor(true);
+	}
+
+	bool SavePNG(const FString& Filename, const void* RawData, int32 RawSize, int32 Width, int32 Height, ERGBFormat::Type Format, int32 BitDepth)
+	{
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		const IImageWrapperPtr ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(RawData, RawSize, Width, Height, Format, BitDepth))
+		{
+			return false;
+		}
+		return FFileHelper::SaveArrayToFile(ImageWrapper->GetCompressed(), *Filename);
+	}
+
+}
+
+UTerrainPreviewCommandlet::UTerrainPreviewCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UTerrainPreviewCommandlet::Main(const FString& Params)
+{
+
+	// The parameters of a terrain blueprint, or of the C++ defaults
+	const AVoxelTerrain* Terrain = GetDefault<AVoxelTerrain>();
+	FString TerrainClassPath;
+	if (FParse::Value(*Params, TEXT("Terrain="), TerrainClassPath))
+	{
+		UClass* const TerrainClass = LoadClass<AVoxelTerrain>(nullptr, *TerrainClassPath);
+		if (TerrainClass == nullptr)
+		{
+			UE_LOG(LogStats, Error, TEXT("%s isn't a voxel terrain class"), *TerrainClassPath);
+			return 1;
+		}
+		Terrain = TerrainClass->GetDefaultObject<AVoxelTerrain>();
+	}
+
+	FTerrainGeneratorParameters Parameter = Terrain->TerrainGenParameters;
+	FParse::Value(*Params, TEXT("Seed="), Parameter.Seed);
+
+	int32 NumChunksPerSide = 64;
+	FParse::Value(*Params, TEXT("Chunks="), NumChunksPerSide);
+	NumChunksPerSide = FMath::Clamp(NumChunksPerSide, 1, 1024);
+
+	// The chunk in the middle of the image
+	FIntVector2D Center(0, 0);
+	FParse::Value(*Params, TEXT("X="), Center.X);
+	FParse::Value(*Params, TEXT("Y="), Center.Y);
+
+	FString Filename = FPaths::Combine(FPaths::GameSavedDir(), TEXT("TerrainPreview"), FString::Printf(TEXT("Seed%d.png"), Parameter.Seed));
+	FParse::Value(*Params, TEXT("Output="), Filename);
+	const FString HeightFilename = FPaths::Combine(FPaths::GetPath(Filename), FPaths::GetBaseFilename(Filename) + TEXT("_Height.png"));
+
+	// The built-in terrain is previewed through its biome graph, which makes the same voxels
+	FString Error;
+	if (!Parameter.HeightmapFile.IsEmpty())
+	{
+		Parameter.HeightmapSource = FHeightmapSource::Open(Parameter.HeightmapFile, Parameter.HeightmapRawWidth, Parameter.HeightmapRawHeight, Error);
+		if (!Parameter.HeightmapSource.IsValid())
+		{
+			UE_LOG(LogStats, Warning, TEXT("Invalid heightmap, using the noise terrain: %s"), *Error);
+		}
+	}
+
+	const FBiomeGraph Graph = Parameter.BiomeGraph.Biomes.Num() > 0 ? Parameter.BiomeGraph : UTerrainGenerator::MakeBiomeGraph(Parameter);
+	const FBiomeProgramPtr Program = FBiomeProgram::Compile(Graph, Parameter.Seed, Error);
+	if (!Program.IsValid())
+	{
+		UE_LOG(LogStats, Error, TEXT("Invalid biome graph: %s"), *Error);
+		return 1;
+	}
+
+	const int32 ImageSize = NumChunksPerSide * CHUNK_SIZE;
+	const FIntVector2D MinChunk(Center.X - NumChunksPerSide / 2, Center.Y - NumChunksPerSide / 2);
+
+	// x goes right and y goes down the image
+	TArray<FColor> Colors;
+	TArray<uint16> Heights;
+	Colors.SetNumUninitialized(ImageSize * ImageSize);
+	Heights.SetNumUninitialized(ImageSize * ImageSize);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	ParallelFor(NumChunksPerSide * NumChunksPerSide, [&](int32 ColumnIndex)
+	{
+		const int32 ChunkX = ColumnIndex % NumChunksPerSide;
+		const int32 ChunkY = ColumnIndex / NumChunksPerSide;
+		const FIntVector3 VoxelsOrigin((MinChunk.X + ChunkX) << CHUNK_SHIFT, (MinChunk.Y + ChunkY) << CHUNK_SHIFT, 0);
+		const FIntVector3 VoxelsSize(CHUNK_SIZE, CHUNK_SIZE, WORLD_HEIGHT);
+
+		FPreviewColumn Column;
+		PreviewColumn(Parameter, *Program, VoxelsOrigin, VoxelsSize, Column);
+
+		for (int32 LocalY = 0; LocalY < CHUNK_SIZE; ++LocalY)
+		{
+			for (int32 LocalX = 0; LocalX < CHUNK_SIZE; ++LocalX)
+			{
+				const int32 Index = LocalX + LocalY * CHUNK_SIZE;
+				const int32 Pixel = (ChunkX * CHUNK_SIZE + LocalX) + (ChunkY * CHUNK_SIZE + LocalY) * ImageSize;
+				Colors[Pixel] = GetPreviewColor(Terrain->TerrainParameters.VoxelTypes, Column.Voxels[Index], Column.Heights[Index]);
+				Heights[Pixel] = (uint16)(Column.Heights[Index] * 65535 / WORLD_HEIGHT);
+			}
+		}
+	});
+
+	const double Time = FPlatformTime::Seconds() - StartTime;
+	const int32 NumColumns = NumChunksPerSide * NumChunksPerSide;
+	UE_LOG(LogStats, Display, TEXT("Previewed %d chunk columns of seed %d in %.3f s, %.0f columns per second"), NumColumns, Parameter.Seed, Time, NumColumns / Time);
+
+	if (!SavePNG(Filename, Colors.GetData(), Colors.Num() * sizeof(FColor), ImageSize, ImageSize, ERGBFormat::BGRA, 8) ||
+		!SavePNG(HeightFilename, Heights.GetData(), Heights.Num() * sizeof(uint16), ImageSize, ImageSize, ERGBFormat::Gray, 16))
+	{
+		UE_LOG(LogStats, Error, TEXT("Failed to write %s"), *Filename);
+		return 1;
+	}
+
+	UE_LOG(LogStats, Display, TEXT("Wrote %s and %s"), *FPaths::ConvertRelativePathToFull(Filename), *FPaths::ConvertRelativePathToFull(HeightFilename));
+	return 0;
+
+}
@@ -1,22 +1,22 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
-
-#include "Camera/PlayerCameraManager.h"
-#include "VoxelPlayerCameraManager.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class AETHERIAGAME_API AVoxelPlayerCameraManager : public APlayerCameraManager
-{
-	GENERATED_BODY()
-	
-	
-	
-	
-};
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+#include "Camera/PlayerCameraManager.h"
+#include "VoxelPlayerCameraManager.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class AETHERIAGAME_API AVoxelPlayerCameraManager : public APlayerCameraManager
+{
+	GENERATED_BODY()
+	
+	
+	
+	
+};
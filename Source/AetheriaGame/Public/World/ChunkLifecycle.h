@@ -0,0 +1,119 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+#include "ChunkUtils.h"
+
+/** Where a chunk is in its lifecycle */
+enum class EChunkState : uint8
+{
+	/* Queued or being generated, it has no voxels yet */
+	Requested,
+	/* Its voxels are loaded, but not the ones of every Moore neighbor, so it can't be meshed yet */
+	Generated,
+	/* Every Moore neighbor is loaded, so its mesh and collision can be built. Goes back to Generated if a neighbor unloads */
+	NeighborsReady,
+	/* Has a mesh component */
+	Meshed,
+	/* Has a collision component but no mesh yet */
+	Collided,
+	/* Has a mesh and a collision component */
+	MeshedAndCollided,
+	/* Its components are released, its voxels are released on a later tick */
+	Unloading
+};
+
+/**
+The state of every chunk the terrain requested. Only used on the game thread.
+The chunks of a column are generated together, and the Moore neighbors of a chunk are in the 8 columns around it, so neighbors
+are counted once per column. A column is reported as ready when its last neighbor arrives, so the terrain only looks at the chunks
+whose state changed instead of polling every chunk in range.
+*/
+class FChunkLifecycle
+{
+
+public:
+
+	struct FColumn
+	{
+		EChunkState States[WORLD_HEIGHT_CHUNKS];
+
+		/* How many of the 8 columns around it are loaded */
+		int32 NumLoadedNeighbors;
+	};
+
+private:
+
+	TMap<FIntVector2D, FColumn> Columns;
+
+	/* Columns whose last neighbor arrived since TakeReadyColumns was called */
+	TArray<FIntVector2D> ReadyColumns;
+
+	/* Columns with chunks that need a mesh, they get meshed once a viewer is close enough */
+	TSet<FIntVector2D> UnmeshedColumns;
+
+public:
+
+	/** Adds a column as Requested. @returns false if the column is already in the lifecycle */
+	bool Request(const FIntVector2D& ColumnCoord);
+
+	/** Removes a column that is still Requested. @returns false if it isn't */
+	bool Cancel(const FIntVector2D& ColumnCoord);
+
+	/** Marks a requested column Generated, and NeighborsReady along with every neighbor it was the last neighbor of */
+	void SetGenerated(const FIntVector2D& ColumnCoord);
+
+	/** Marks a NeighborsReady chunk Meshed, or a Collided one MeshedAndCollided */
+	void SetMeshed(const FIntVector3& ChunkCoord);
+
+	/** Marks a NeighborsReady chunk Collided, or a Meshed one MeshedAndCollided */
+	void SetCollided(const FIntVector3& ChunkCoord);
+
+	/** Marks every chunk of a column Unloading, and its neighbors as missing a neighbor. The column is no longer loaded */
+	void BeginUnload(const FIntVector2D& ColumnCoord);
+
+	/** Removes an Unloading column once its voxels are released */
+	void FinishUnload(const FIntVector2D& ColumnCoord);
+
+	/** @returns false if the column isn't in the lifecycle */
+	bool GetState(const FIntVector3& ChunkCoord, EChunkState& OutState) const;
+
+	bool IsRequested(const FIntVector2D& ColumnCoord) const;
+
+	/** Whether the chunk's voxels are loaded and not being unloaded */
+	bool IsLoaded(const FIntVector2D& ColumnCoord) const;
+
+	/** Whether BeginUnload was called on the column and FinishUnload wasn't yet */
+	bool IsUnloading(const FIntVector2D& ColumnCoord) const;
+
+	bool HasMesh(const FIntVector3& ChunkCoord) const;
+
+	bool HasCollision(const FIntVector3& ChunkCoord) const;
+
+	/** Whether the chunk has no mesh yet and all its Moore neighbors are loaded, so its mesh can be built */
+	bool NeedsMesh(const FIntVector3& ChunkCoord) const;
+
+	/** Whether the chunk has no collision yet and all its Moore neighbors are loaded, so its collision can be built */
+	bool NeedsCollision(const FIntVector3& ChunkCoord) const;
+
+	/** Moves the columns that became ready since the last call into OutColumns */
+	void TakeReadyColumns(TArray<FIntVector2D>& OutColumns);
+
+	const TSet<FIntVector2D>& GetUnmeshedColumns() const { return UnmeshedColumns; }
+
+	const TMap<FIntVector2D, FColumn>& GetColumns() const { return Columns; }
+
+	void Empty();
+
+private:
+
+	/** Marks the Generated chunks of a column NeighborsReady and reports it */
+	void SetNeighborsReady(const FIntVector2D& ColumnCoord, FColumn& Column);
+
+	/** Removes the column from UnmeshedColumns if none of its chunks needs a mesh */
+	void UpdateUnmeshed(const FIntVector2D& ColumnCoord, const FColumn& Column);
+
+};
@@ -0,0 +1,56 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+
+/**
+Every chunk offset within a radius, sorted from the nearest to the furthest.
+Built once for the load, draw and collision shapes, so the shapes around a viewer are walked nearest first without
+scanning the bounding square and testing every chunk.
+*/
+class FChunkOffsetTable
+{
+
+public:
+
+	struct FOffset
+	{
+		FIntVector3 Offset;
+		// Squared distance (in chunks) to the origin
+		int32 DistanceSquared;
+	};
+
+private:
+
+	TArray<FOffset> Offsets;
+
+	int32 Radius;
+
+public:
+
+	FChunkOffsetTable() : Radius(0) {}
+
+	/** Builds the columns with a distance squared less than Radius squared. Z of every offset is 0 */
+	void BuildCircle(const int32 InRadius);
+
+	/** Builds the chunks with a distance squared less than Radius squared, Z included */
+	void BuildSphere(const int32 InRadius);
+
+	FORCEINLINE int32 Num() const { return Offsets.Num(); }
+
+	FORCEINLINE const FOffset& operator[](const int32 Index) const { return Offsets[Index]; }
+
+	FORCEINLINE int32 GetRadius() const { return Radius; }
+
+	// Range for support
+	FORCEINLINE const FOffset* begin() const { return Offsets.GetData(); }
+	FORCEINLINE const FOffset* end() const { return Offsets.GetData() + Offsets.Num(); }
+
+private:
+
+	void Build(const int32 InRadius, const int32 ZRadius);
+
+};
@@ -0,0 +1,42 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ChunkUtils.h"
+#include "IntVectors.h"
+
+/**
+Greedy meshes the visible faces of a chunk into quads, without ambient occlusion.
+Every row of a slice is a 32 bit mask of the faces that are visible, found with shifts and ANDs of the occupancy of whole columns of voxels.
+Quads are grown along a row with a bit scan and down the rows with a mask compare. A slice that has faces of several voxel types gets a
+mask per type, so only faces of the same type are merged.
+The quads, their vertices and their order are exactly the ones of the voxel at a time greedy mesher it replaced.
+*/
+class AETHERIAGAME_API FChunkMesher
+{
+
+public:
+
+	/* Voxels of a chunk with one layer of its neighbors on every side, indexed x + y * PADDED_SIZE + z * PADDED_SIZE * PADDED_SIZE */
+	static const int32 PADDED_SIZE = CHUNK_SIZE + 2;
+
+	struct FQuad
+	{
+		/* In chunk space, in the order the mesh component adds them to the vertex buffer */
+		FIntVector3 Vertices[4];
+		EVoxelFace Face;
+		uint8 VoxelType;
+
+		friend bool operator==(const FQuad& A, const FQuad& B)
+		{
+			return A.Face == B.Face && A.VoxelType == B.VoxelType && A.Vertices[0] == B.Vertices[0] && A.Vertices[1] == B.Vertices[1]
+				&& A.Vertices[2] == B.Vertices[2] && A.Vertices[3] == B.Vertices[3];
+		}
+	};
+
+	/** Appends the quads of every visible face of the chunk, back faces first, then by axis, slice, row and column */
+	static void MeshChunk(const uint8* PaddedVoxels, TArray<FQuad>& OutQuads);
+
+};
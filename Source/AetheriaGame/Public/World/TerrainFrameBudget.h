@@ -0,0 +1,121 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The kinds of work the terrain does on the game thread, each gets a slice of TerrainParameters.MaxUpdateTime */
+enum class ETerrainWork : uint8
+{
+	/* Adding the generated columns to the terrain */
+	Insertion,
+	/* Creating collision components */
+	Collision,
+	/* Creating mesh components and rebuilding dirty meshes, which submits their scene proxies */
+	Meshing,
+	/* Releasing the columns the viewers left behind */
+	Unloading,
+	Num
+};
+
+/**
+Splits the terrain's game thread time of a frame between the kinds of work. Only used on the game thread.
+Every kind gets a fixed share of the frame. A kind that finishes its work early gives the rest of its share to the kinds that
+run after it in the same frame, and a kind that goes over its share pays it back the next frame. A kind that was left without
+time for Aetheria.Terrain.StarvationFrames frames in a row is allowed one item, so a slow item can't block it forever.
+*/
+class FTerrainFrameBudget
+{
+
+public:
+
+	/** Times one item of work */
+	class FScopedItem
+	{
+	public:
+		FScopedItem(FTerrainFrameBudget& InBudget, const ETerrainWork InWork);
+		~FScopedItem();
+
+	private:
+		FTerrainFrameBudget& Budget;
+		const ETerrainWork Work;
+		const uint32 StartCycles;
+	};
+
+	struct FWorkStats
+	{
+		/* The time the work was allowed to use, including the time it borrowed */
+		double AllowedSeconds;
+		double UsedSeconds;
+		int32 NumItems;
+		/* Whether it had to leave work for a later frame */
+		bool bOutOfTime;
+	};
+
+private:
+
+	struct FWorkState
+	{
+		FWorkStats Stats;
+		/* Time used over its share last frame, taken out of this frame's share */
+		double DebtSeconds;
+		/* Frames in a row it ran out of time without doing anything */
+		int32 StarvedFrames;
+		bool bFinished;
+	};
+
+	struct FTotals
+	{
+		int64 Frames;
+		/* Frames the terrain went over MaxUpdateTime */
+		int64 FramesOverBudget;
+		double UsedSeconds[(int32)ETerrainWork::Num];
+		double MaxUsedSeconds[(int32)ETerrainWork::Num];
+		double MaxFrameSeconds;
+	};
+
+	FWorkState Works[(int32)ETerrainWork::Num];
+
+	double BudgetSeconds;
+
+	/* Time given up by the work that finished this frame */
+	double SpareSeconds;
+
+	FTotals Totals;
+
+public:
+
+	FTerrainFrameBudget();
+
+	/** Gives every kind of work its share of BudgetSeconds */
+	void BeginFrame(const double InBudgetSeconds);
+
+	/** @returns whether another item of Work fits in this frame. Marks Work as out of time if it doesn't */
+	bool HasTime(const ETerrainWork Work);
+
+	/** Called when Work has nothing left to do, gives the time it didn't use to the work after it */
+	void Finish(const ETerrainWork Work);
+
+	/** Settles the debts and starvation of this frame, and adds it to the totals */
+	void EndFrame();
+
+	/** The stats of Work for the last frame */
+	const FWorkStats& GetStats(const ETerrainWork Work) const { return Works[(int32)Work].Stats; }
+
+	/** Total time used by the terrain in the last frame */
+	double GetUsedSeconds() const;
+
+	double GetBudgetSeconds() const { return BudgetSeconds; }
+
+	static const TCHAR* GetWorkName(const ETerrainWork Work);
+
+	/** Logs the per work averages and maxima since the last reset */
+	void Log() const;
+
+	void Reset();
+
+private:
+
+	void AddItem(const ETerrainWork Work, const uint32 Cycles);
+
+};
@@ -0,0 +1,188 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+#include "ChunkUtils.h"
+#include "ChunkOffsetTable.h"
+
+/** Something the terrain is streamed around: a player, a spectator, or an anchor placed by the game like an AI's */
+struct FTerrainViewer
+{
+	/* Identifies the viewer from one tick to the next, the player controller or the anchor actor */
+	const UObject* Key;
+
+	FVector Location;
+
+	/* Used to prefetch the columns the viewer is heading to */
+	FVector Velocity;
+
+	/* Where the viewer looks, zero if it has no view like an AI anchor */
+	FVector ViewDirection;
+
+	/* Half the horizontal field of view in radians */
+	float HalfFOV;
+
+	/* Radii in chunks. The load distance includes the load expansion radius */
+	int32 DrawDistance;
+	int32 LoadDistance;
+	int32 CollisionDistance;
+
+	FIntVector3 GetChunkPosition() const
+	{
+		return FIntVector3((int32)(Location.X / 100.0f) >> CHUNK_SHIFT, (int32)(Location.Y / 100.0f) >> CHUNK_SHIFT, (int32)(Location.Z / 100.0f) >> CHUNK_SHIFT);
+	}
+};
+
+/**
+Keeps the union of the columns every viewer needs, so the terrain streams each column once no matter how many viewers need it.
+Every column counts the viewers that need it. When a viewer moves to another chunk only the columns its circle gained and lost
+are counted, and the columns whose count went from or to zero are reported. Only used on the game thread.
+A moving viewer also needs a cone of columns past its load distance in the direction it is heading, as far as it travels in
+Aetheria.Streaming.PrefetchSeconds, so fast viewers don't outrun the loaded columns.
+*/
+class FTerrainInterestManager
+{
+
+public:
+
+	struct FChanges
+	{
+		/* Columns in the load distance of a viewer that weren't in any before */
+		TArray<FIntVector2D> EnteredColumns;
+
+		/* Columns that aren't in the load distance of any viewer anymore */
+		TArray<FIntVector2D> LeftColumns;
+
+		/* Columns that are more than a column past the load distance of every viewer, and can be unloaded */
+		TArray<FIntVector2D> ReleasedColumns;
+
+		/* Whether a viewer moved to another chunk, changed radii, was added or was removed */
+		bool bViewersMoved;
+
+		/* Whether a viewer turned by an eighth of a circle */
+		bool bViewsTurned;
+
+		/* Whether the cone of columns a viewer is heading to changed */
+		bool bPrefetchChanged;
+	};
+
+private:
+
+	struct FViewerState
+	{
+		FTerrainViewer Viewer;
+		FIntVector3 ChunkPosition;
+		int32 ViewSector;
+
+		/* The eighth of a circle the viewer is heading to, -1 if it is too slow to prefetch */
+		int32 HeadingSector;
+		/* Number of columns it travels in Aetheria.Streaming.PrefetchSeconds */
+		int32 PrefetchLength;
+		/* Where it will be in Aetheria.Streaming.PrefetchSeconds */
+		FIntVector2D PredictedColumn;
+		/* Columns in the prefetch cone that are out of its load distance */
+		TArray<FIntVector2D> PrefetchColumns;
+	};
+
+	TArray<FViewerState> Viewers;
+
+	/* Number of viewers whose load distance contains the column */
+	TMap<FIntVector2D, int32> RequiredColumns;
+
+	/* Number of viewers within their load distance plus one of the column, so walking along the edge doesn't unload and reload columns */
+	TMap<FIntVector2D, int32> RetainedColumns;
+
+	/* Circles and spheres of every radius a viewer used */
+	TMap<int32, FChunkOffsetTable> Circles;
+	TMap<int32, FChunkOffsetTable> Spheres;
+
+	/* A rectangle of columns gameplay code asked for, needed until it is removed */
+	struct FRegion
+	{
+		FIntVector2D MinColumn;
+		FIntVector2D MaxColumn;
+		/* The columns that are meshed, one column in from the edges when the edges are only there as neighbors */
+		FIntVector2D MinDrawColumn;
+		FIntVector2D MaxDrawColumn;
+		bool bDraw;
+		/* Requested as if it were this many columns from a viewer */
+		float Priority;
+	};
+
+	TMap<int32, FRegion> Regions;
+
+public:
+
+	/** Replaces the viewers of last tick and reports the columns that entered and left the union */
+	void SetViewers(const TArray<FTerrainViewer>& NewViewers, FChanges& OutChanges);
+
+	int32 Num() const { return Viewers.Num(); }
+
+	const FTerrainViewer& GetViewer(const int32 Index) const { return Viewers[Index].Viewer; }
+
+	/** The chunk the viewer was in when SetViewers was last called */
+	const FIntVector3& GetViewerChunkPosition(const int32 Index) const { return Viewers[Index].ChunkPosition; }
+
+	/** Where the viewer will be in Aetheria.Streaming.PrefetchSeconds. Its own column if it is too slow to prefetch */
+	const FIntVector2D& GetPredictedColumn(const int32 Index) const { return Viewers[Index].PredictedColumn; }
+
+	/** Whether the column is in the load distance of a viewer */
+	bool IsRequired(const FIntVector2D& ColumnCoord) const { return RequiredColumns.Contains(ColumnCoord); }
+
+	/** Whether the column is within a column past the load distance of a viewer */
+	bool IsRetained(const FIntVector2D& ColumnCoord) const { return RetainedColumns.Contains(ColumnCoord); }
+
+	/** Whether the column is in the draw distance of a viewer, or in a region that is meshed */
+	bool IsInDrawDistance(const FIntVector2D& ColumnCoord) const;
+
+	/**
+	*  Adds a rectangle of columns to the union until RemoveRegion is called, no matter where the viewers are.
+	*  @param bDraw - whether the columns are meshed. Their neighbors are added too, a chunk can't be meshed without them
+	*  @param Priority - the region is requested as if it were this many columns from a viewer
+	*/
+	void AddRegion(const int32 RegionId, const FIntVector2D& MinColumn, const FIntVector2D& MaxColumn, const bool bDraw, const float Priority, FChanges& OutChanges);
+
+	void RemoveRegion(const int32 RegionId, FChanges& OutChanges);
+
+	/** The middle column of every region, the generation queue treats them like viewers */
+	void GetRegionCenters(TArray<FIntVector2D>& OutColumns) const;
+
+	/**
+	*  @param OutOfViewScale - multiplies the squared distance to the viewers that don't look at the column
+	*  @returns the lowest squared distance in columns from the column to a viewer, lower is requested first. Columns ahead of a moving
+	*           viewer count as closer and the ones behind it as further away, by Aetheria.Streaming.AheadDistanceScale and BehindDistanceScale
+	*/
+	float GetRequestPriority(const FIntVector2D& ColumnCoord, const float OutOfViewScale) const;
+
+	/** The columns within Radius of the origin, nearest first. Only radii of the current viewers are available */
+	const FChunkOffsetTable& GetCircle(const int32 Radius) const { return Circles.FindChecked(Radius); }
+
+	/** The chunks within Radius of the origin, nearest first. Only radii of the current viewers are available */
+	const FChunkOffsetTable& GetSphere(const int32 Radius) const { return Spheres.FindChecked(Radius); }
+
+	void Empty();
+
+private:
+
+	const FChunkOffsetTable& FindOrBuildCircle(const int32 Radius);
+
+	/** Sets the heading, prefetch length and predicted column of a viewer from its velocity */
+	static void UpdateMotion(FViewerState& State);
+
+	/** Gets the columns of the viewer's prefetch cone that are out of its load distance */
+	void GetPrefetchColumns(const FViewerState& State, TArray<FIntVector2D>& OutColumns);
+
+	/** Adds the columns in the circle around NewCenter that aren't in the circle around OldCenter, or all of them if there is no old circle */
+	void GetGainedColumns(const FIntVector2D& NewCenter, const int32 NewRadius, const FIntVector2D* OldCenter, const int32 OldRadius, TArray<FIntVector2D>& OutColumns);
+
+	/** Gets every column of the region, edges included */
+	static void GetRegionColumns(const FRegion& Region, TArray<FIntVector2D>& OutColumns);
+
+	static void AddColumns(TMap<FIntVector2D, int32>& Counts, const TArray<FIntVector2D>& Columns, TArray<FIntVector2D>* OutEnteredColumns);
+
+	static void RemoveColumns(TMap<FIntVector2D, int32>& Counts, const TArray<FIntVector2D>& Columns, TArray<FIntVector2D>& OutLeftColumns);
+
+};
@@ -1,153 +1,250 @@
-// Copyright (c) 2016, Charles JL Sun, All rights reserved.
-
-#pragma once
-
-#include "Runtime/Engine/Classes/Engine/DataTable.h"
-
-#include "Engine/EngineTypes.h"
-#include "TerrainParameters.generated.h"
-
-/**
-WIP. NOT USED IN CODE YET
-The data table type for voxel data, so user defined voxel types would be easier to create
-*/
-USTRUCT(BlueprintType)
-struct FVoxelTypeData : public FTableRowBase
-{
-
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel Type")
-	FString DisplayName;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel Type")
-	FColor VoxelColor;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel Type")
-	TAssetPtr<class UMaterialInterface> VoxelMaterial;
-
-	FVoxelTypeData() {};
-
-};
-
-/**
-Stores information about a voxel using the flyweight design pattern.
-Used by terrain, indexed by type id.
-*/
-USTRUCT(BlueprintType)
-struct FVoxelType
-{
-
-	GENERATED_BODY()
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Type")
-	FColor VoxelColor;
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Type")
-	UMaterialInterface* VoxelMaterial;
-
-	FVoxelType() {};
-
-	FVoxelType(FColor InVoxelColor, UMaterialInterface* InVoxelMaterial)
-		: VoxelColor(InVoxelColor), VoxelMaterial(InVoxelMaterial) {};
-
-};
-
-/**
-Stores information about a terrain.
-Seperate struct because it's easier to change and edit. Used by Voxel Terrain.
-*/
-USTRUCT(BlueprintType)
-struct FTerrainParameters
-{
-
-	GENERATED_BODY()
-
-	/* A radius around the player in which terrains are generated and rendered */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
-	int32 DrawDistanceInChunks;
-
-	/* Number of extra chunk radius for expansion */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
-	int32 LoadExpansionRadius;
-
-	/* A radius around the player in which collision meshes are generated */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
-	int32 CollisionDistanceInChunks;
-
-	/* The blur radius for ambient occlusion calculation */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
-	int32 AOBlurRadus;
-
-	/* The max time in seconds allowed between each update/tick */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
-	float MaxUpdateTime;
-
-	/* All the Voxel Types and their index */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
-	TArray<FVoxelType> VoxelTypes;
-
-};
-
-/**
-Default parameters used by the terrain generator to procedurally generate the terrain.
-TODO: Replace by individual biome system
-*/
-USTRUCT(BlueprintType)
-struct FTerrainGeneratorParameters
-{
-	GENERATED_BODY()
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	bool bUseRidgedMulti;
-
-	// The seed of our fractal
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	int32 Seed;
-
-	// The number of octaves that the noise generator will use
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	int32 NoiseOctaves;
-
-	// The frequency of the noise
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float NoiseFrequency;
-
-	// Frequency is multiplied by this every octave. Bigger than 1.
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float NoiseLacunarity;
-
-	// Amptitude is multiplied by this every octave. Less than 1.
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float NoisePersistance;
-
-	// Scale
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float NoiseScale;
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	bool bCreateTrees;
-
-	// Tree's Noise Scale
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float TreeScale;
-
-	// Tree's Noise Octaves
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float TreeOctaves;
-
-	// Tree's Density (between 0 - 1)
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	float TreeDensity;
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	int32 SnowVoxel;
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	int32 GrassVoxel;
-
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
-	bool bSnowOnTrees;
-
-
+// Copyright (c) 2016, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "Runtime/Engine/Classes/Engine/DataTable.h"
+
+#include "IntVectors.h"
+#include "BiomeGraph.h"
+#include "HeightmapSource.h"
+#include "NoiseTileCache.h"
+
+#include "Engine/EngineTypes.h"
+#include "TerrainParameters.generated.h"
+
+/**
+WIP. NOT USED IN CODE YET
+The data table type for voxel data, so user defined voxel types would be easier to create
+*/
+USTRUCT(BlueprintType)
+struct FVoxelTypeData : public FTableRowBase
+{
+
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel Type")
+	FString DisplayName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel Type")
+	FColor VoxelColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel Type")
+	TAssetPtr<class UMaterialInterface> VoxelMaterial;
+
+	FVoxelTypeData() {};
+
+};
+
+/**
+Stores information about a voxel using the flyweight design pattern.
+Used by terrain, indexed by type id.
+*/
+USTRUCT(BlueprintType)
+struct FVoxelType
+{
+
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Type")
+	FColor VoxelColor;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Type")
+	UMaterialInterface* VoxelMaterial;
+
+	FVoxelType() {};
+
+	FVoxelType(FColor InVoxelColor, UMaterialInterface* InVoxelMaterial)
+		: VoxelColor(InVoxelColor), VoxelMaterial(InVoxelMaterial) {};
+
+};
+
+/**
+Stores information about a terrain.
+Seperate struct because it's easier to change and edit. Used by Voxel Terrain.
+*/
+USTRUCT(BlueprintType)
+struct FTerrainParameters
+{
+
+	GENERATED_BODY()
+
+	/* A radius around the player in which terrains are generated and rendered */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 DrawDistanceInChunks;
+
+	/* Number of extra chunk radius for expansion */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 LoadExpansionRadius;
+
+	/* The draw distance can be lowered down to this when the game can't keep up, see Aetheria.Quality.Adaptive. The load expansion is lowered first */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 MinDrawDistanceInChunks;
+
+	/* A radius around the player in which collision meshes are generated */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 CollisionDistanceInChunks;
+
+	/* The blur radius for ambient occlusion calculation */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 AOBlurRadus;
+
+	/* Number of threads that generate chunks. 0 or less uses the number of cores minus 2 */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 NumGenerationThreads;
+
+	/* The game thread time in seconds the terrain can use every tick, split between adding columns, collision, meshing and unloading */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	float MaxUpdateTime;
+
+	/* A radius around the player start that is generated, meshed and given collision in BeginPlay, before the first frame. 0 streams it in like everything else */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	int32 SpawnRadiusInChunks;
+
+	/* Saves the noise of the spawn area to the Saved folder, so the next start with the same seed and parameters doesn't evaluate it again */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	bool bCacheSpawnArea;
+
+	/* All the Voxel Types and their index */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Parameters")
+	TArray<FVoxelType> VoxelTypes;
+
+};
+
+/**
+Default parameters used by the terrain generator to procedurally generate the terrain.
+A BiomeGraph with biomes replaces the built-in density terrain, snow and tree density.
+A HeightmapFile replaces both of them with the heights of the file.
+*/
+USTRUCT(BlueprintType)
+struct FTerrainGeneratorParameters
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	bool bUseRidgedMulti;
+
+	// The seed of our fractal
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 Seed;
+
+	// The number of octaves that the noise generator will use
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 NoiseOctaves;
+
+	// The frequency of the noise
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float NoiseFrequency;
+
+	// Frequency is multiplied by this every octave. Bigger than 1.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float NoiseLacunarity;
+
+	// Amptitude is multiplied by this every octave. Less than 1.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float NoisePersistance;
+
+	// Scale
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float NoiseScale;
+
+	// Voxels between each sample of the density noise in every axis, the voxels in between are trilinearly interpolated.
+	// 1 samples every voxel. Bigger spacings are a lot faster but smooth out the small details.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	FIntVector3 DensitySampleSpacing;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	bool bCreateTrees;
+
+	// Tree's Noise Scale
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float TreeScale;
+
+	// Tree's Noise Octaves
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float TreeOctaves;
+
+	// Tree's Density (between 0 - 1)
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float TreeDensity;
+
+	// Carves caves out of the solid voxels wherever the cave noise is above CaveThreshold
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	bool bCreateCaves;
+
+	// Cave's Noise Scale
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float CaveScale;
+
+	// Cave's Noise Octaves
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 CaveOctaves;
+
+	// Amptitude of the cave noise is multiplied by this every octave. Less than 1.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float CavePersistence;
+
+	// The cave noise (between -1 - 1) a voxel needs to be carved. Bigger thresholds make smaller caves.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	float CaveThreshold;
+
+	// The lowest layer caves are carved in
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 CaveMinHeight;
+
+	// Caves get smaller from CaveFadeHeight up and stop at CaveMaxHeight, where the threshold reaches 1
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 CaveFadeHeight;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 CaveMaxHeight;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 SnowVoxel;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 GrassVoxel;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	bool bSnowOnTrees;
+
+	// Data driven terrain. When it has biomes, they replace the noise, the voxels and the tree density above. The tree noise, the caves and bSnowOnTrees still apply.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	FBiomeGraph BiomeGraph;
+
+	// BiomeGraph compiled for Seed when the terrain begins play, invalid when the built-in terrain is used
+	FBiomeProgramPtr BiomeProgram;
+
+	// A 16 bit grayscale PNG, or a raw little endian 16 bit file (.r16, .raw), the surface is read from instead of noise.
+	// Relative paths start at the project directory. Empty uses the noise or the biome graph.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	FString HeightmapFile;
+
+	// Pixels on each side of a raw heightmap file, raw files have no header. 0 takes the file to be square. Ignored for PNGs.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 HeightmapRawWidth;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 HeightmapRawHeight;
+
+	// The voxel <x, y> of the heightmap's first pixel, each pixel is a voxel. Outside the map its edge repeats.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	FIntVector2D HeightmapOrigin;
+
+	// The heights of the samples 0 and 65535, the ones in between are linearly mapped
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 HeightmapMinHeight;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 HeightmapMaxHeight;
+
+	// Layers of GrassVoxel on top of the stone of the heightmap terrain
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Terrain Gen Parameter")
+	int32 HeightmapGrassDepth;
+
+	// HeightmapFile opened when the terrain begins play, invalid when the noise or the biome graph is used
+	FHeightmapSourcePtr HeightmapSource;
+
+	// Cache the noise tiles are found in and added to, invalid uses the one every terrain shares
+	FNoiseTileCachePtr NoiseTileCache;
+
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** What made the quality controller lower the terrain's radii */
+enum class ETerrainPressure : uint8
+{
+	None,
+	/* The frames took longer than Aetheria.Quality.TargetFrameMs */
+	FrameTime,
+	/* The loaded chunks took more than Aetheria.Quality.MaxChunkMB */
+	Memory,
+	/* More than Aetheria.Quality.MaxBacklog columns and chunks were waiting to be generated, meshed or given collision, outside of a fill */
+	Backlog
+};
+
+/**
+Lowers the radii the terrain is streamed in when the game can't keep up, and raises them back once it can. Only used on the game thread.
+Every level first takes a chunk off the load expansion, which frees memory without changing what is seen, down to the one column
+meshes need around them, then a chunk off the draw distance, down to TerrainParameters.MinDrawDistanceInChunks.
+A level is only dropped after the pressure lasted Aetheria.Quality.DownSeconds, and only raised after Aetheria.Quality.UpSeconds
+under Aetheria.Quality.Headroom of every limit. Nothing changes for Aetheria.Quality.CooldownSeconds after a change, so the terrain
+it loads or unloads can't make it oscillate.
+The backlog of a fill the controller didn't cause, like the first load, a teleport or a bigger draw distance, is expected to go over
+its limit and isn't pressure until it drained under the headroom once.
+*/
+class FTerrainQualityController
+{
+
+public:
+
+	/** What the controller watches, sampled once a frame */
+	struct FInputs
+	{
+		/* Real time of the last frame, not scaled by time dilation */
+		float FrameSeconds;
+		int64 ChunkBytes;
+		/* Columns waiting to be requested or generated, and chunks waiting for a mesh or collision */
+		int32 Backlog;
+	};
+
+	/** How far every radius can be lowered, from the terrain parameters */
+	struct FBounds
+	{
+		int32 MaxLoadExpansionReduction;
+		int32 MaxDrawDistanceReduction;
+	};
+
+private:
+
+	/* Number of chunks taken off the radii, the load expansion first */
+	int32 Level;
+
+	FBounds Bounds;
+
+	/* The frame time, smoothed over about half a second so a single hitch doesn't count as pressure */
+	float SmoothedFrameSeconds;
+
+	/* How long the pressure or the headroom lasted, only one of them is counted at a time */
+	float PressureSeconds;
+	float HeadroomSeconds;
+
+	/* Time left before the level can change again */
+	float CooldownSeconds;
+
+	ETerrainPressure Pressure;
+
+	/* A fill the controller didn't cause is running, its backlog isn't pressure */
+	bool bFilling;
+
+	FInputs LastInputs;
+
+public:
+
+	FTerrainQualityController();
+
+	/**
+	*  Samples the inputs and changes the level if the pressure or the headroom lasted long enough.
+	*  @returns whether the radii changed
+	*/
+	bool Update(const float DeltaSeconds, const FInputs& Inputs, const FBounds& InBounds);
+
+	/** Called with the columns that entered the range of the viewers in a frame the radii didn't change in. More than the headroom of the backlog at once starts a fill */
+	void OnColumnsEntered(const int32 NumColumns);
+
+	/** Chunks to take off the load expansion of every viewer */
+	int32 GetLoadExpansionReduction() const { return FMath::Min(Level, Bounds.MaxLoadExpansionReduction); }
+
+	/** Chunks to take off the draw distance of every viewer */
+	int32 GetDrawDistanceReduction() const { return FMath::Max(0, Level - Bounds.MaxLoadExpansionReduction); }
+
+	int32 GetLevel() const { return Level; }
+
+	/** Logs the level and the inputs it was last updated with */
+	void Log() const;
+
+	/** Goes back to full quality */
+	void Reset();
+
+};
@@ -1,214 +1,458 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
-#include "IntVectors.h"
-#include "ChunkUtils.h"
-#include "TerrainParameters.h"
-
-#include "GameFramework/Actor.h"
-#include "VoxelTerrain.generated.h"
-
-UCLASS()
-class AETHERIAGAME_API AVoxelTerrain : public AActor
-{
-	GENERATED_BODY()
-	
-public:	
-	// Sets default values for this actor's properties
-	AVoxelTerrain(const class FObjectInitializer& ObjectInitializer);
-
-	virtual void BeginDestroy() override;
-
-	virtual void BeginPlay() override;
-
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	static FIntVector3 WorldToChunkCoord(const FIntVector3& WorldCoord);
-
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	static FIntVector3 ChunkToWorldCoord(const FIntVector3& ChunkCoord);
-
-
-private:
-
-	class FTerrainGenerationThread* TerrainGenerationThread;
-
-	/* Stores all the Chunks in the terrain, indexed by LoadedChunksIndex */
-	UPROPERTY(Transient, DuplicateTransient)
-	TArray<FChunk> LoadedChunks;
-	/* Stores the index of the Chunk at a Chunk Coordinate, to access the Chunk in LoadedChunks */
-	TMap<FIntVector3, int32> LoadedChunksIndex;
-	/* The Mutex for both LoadedChunksIndex AND LoadedChunks */
-	FCriticalSection LoadedChunksMutex;
-
-	/* Stores the Mesh Component for at a Chunk Coordinate. Not Thread Safe because only main game thread should create/modify UObject. */
-	TMap<FIntVector3, class UChunkMeshComponent*> LoadedChunkMeshComponents;
-	/* The Mutex for LoadedChunkMeshComponents */
-	FCriticalSection LoadedChunkMeshesMutex;
-
-	/* Stores the Collision Component for at a Chunk Coordinate. Not Thread Safe because only main game thread should create/modify UObject. */
-	TMap<FIntVector3, class UChunkCollisionComponent*> LoadedChunkCollisionComponents;
-	/* The Mutex for LoadedChunkCollisionComponents */
-	FCriticalSection LoadedChunkCollisionsMutex;
-
-	/* Chunks that are currently being loaded/generated */
-	TSet<FIntVector3> PendingChunks;
-
-	float time = 0.0f;
-
-public:
-
-	/* Parameter for terrain generation */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Terrain")
-	FTerrainGeneratorParameters TerrainGenParameters;
-
-	/* Parameter for voxel terrain */
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Terrain")
-	FTerrainParameters TerrainParameters;
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// UPDATE METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-public:
-
-	virtual void Tick(float DeltaSeconds) override;
-
-	bool IsChunkPending(const FIntVector3& ChunkCoord);
-
-	void LoadChunk(const FIntVector3& ChunkCoord);
-
-	/** Add a chunk to the client/server's loaded chunks */
-	void AddChunk(FChunk& Chunk);
-
-	/** Updates the light values in the verticle chunk */
-	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
-	void UpdateChunkHeightmap(const FIntVector3& ChunkCoord);
-
-	void GenerateMesh(const FIntVector3& ChunkCoord);
-
-	void GenerateCollision(const FIntVector3& ChunkCoord);
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// VOXEL/CHUNK METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	FVoxelType GetVoxelType(const uint8& Voxel) const;
-
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	int32 GetNumVoxelTypes() const;
-
-	/**
-	*  Get the voxel at voxel coordinate <x, y, z>
-	*  @returns voxel type as uint8
-	*/
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	uint8 GetVoxelAt(const int32& x, const int32& y, const int32& z);
-
-	/** Set the voxel at voxel coordinate <x, y, z> */
-	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
-	void SetVoxelAt(const int32& x, const int32& y, const int32& z, uint8 Voxel);
-
-	/**
-	*  Mark an area of voxels to be 'dirty' and use that area to determine which chunks
-	*  need mesh updates, ambient occlusion updates only, and/or collision update.
-	*  Ambient Occlusion updates will be determined by the AORadius of the terrain.
-	*	@param MinVoxelCoord - Lower bound of the area of voxels that are changed (Inclusive)
-	*  @param MaxVoxelCoord - Upper bound of the area of voxels that are changed (Inclusive)
-	*/
-	void MarkVoxelAreaDirty(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord);
-
-	/**
-	*  Mark a single voxel to be 'dirty' and use that voxel to determine which chunks
-	*  need mesh updates, ambient occlusion updates only, and/or collision update.
-	*  Ambient Occlusion updates will be determined by the AORadius of the terrain.
-	*/
-	void MarkVoxelDirty(const FIntVector3& VoxelCoord);
-
-	/**
-	*  This method should be used with caution as it is the least imprecise and creates the most updates. Use Mark Voxel Dirty instead.
-	*  Mark a single Chunk to be 'dirty', all chunks around will get a mesh update and a collision update.
-	*  Also all chunks of all Z Coordinate in its Moore's neighbour will get an ambient occlusion update.
-	*/
-	void MarkChunkDirty(const FIntVector3& ChunkCoord);
-
-	/**
-	*  Get the voxels array at the chunk coordinate
-	*  @param OutVoxelsArray - Empty TArray that the function outputs to
-	*/
-	void GetChunkVoxelsArray(const FIntVector3& ChunkCoord, TArray<uint8>& OutVoxelsArray);
-
-	/**
-	*  Gets all the voxels from MinVoxelCoord to MaxVoxelCoord and store in an array.
-	*	@param MinVoxelCoord - Lower bound of the block of voxels to get (Inclusive)
-	*  @param MaxVoxelCoord - Upper bound of the block of voxels to get (Inclusive)
-	*  @param OutVoxelsArray - Empty TArray that the function outputs to.
-	*/
-	void GetVoxelsArray(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord, TArray<uint8>& OutVoxelsArray);
-
-
-	/** Returns whether the chunk at chunk coord is loaded on this Client/Server */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	bool HasChunk(const FIntVector3& ChunkCoord);
-
-	bool HasAllNeighborChunks(const FIntVector3& ChunkCoord);
-
-	/** Returns a FChunk Reference at ChunkCoord. Warning: Only use when ChunkCoord is sure to exist, raises error if not. */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	FChunk& GetChunkAt(const FIntVector3& ChunkCoord);
-
-	/** Returns a FChunk Reference AND its index at ChunkCoord. Warning: Only use when ChunkCoord is sure to exist, raises error if not. */
-	FChunk& GetChunkAndIndexAt(const FIntVector3& ChunkCoord, int32& OutChunkIndex);
-
-	/** Returns the chunk's index at ChunkCoord. Warning: Only use when ChunkCoord is sure to exist, raises error if not. */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	int32 GetChunkIndexAt(const FIntVector3& ChunkCoord);
-
-	/** Returns whether all the chunks at <x, y> are loaded. */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	bool HasChunkColumn(const FIntVector2D& ChunkColumnCoord);
-
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// CHUNK MESH METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	/** Returns whether the Collision for the chunks at ChunkCoord is loaded. */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	bool HasChunkMesh(const FIntVector3& ChunkCoord);
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// CHUNK COLLISION METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	/** Returns whether the Collision for the chunks at ChunkCoord is loaded. */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
-	bool HasChunkCollision(const FIntVector3& ChunkCoord);
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// HEIGHTMAP METHODS
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	/** Get the heightmap value at world voxel coordinate <x, y> */
-	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
-	int32 GetHeightAt(const int32& x, const int32& y);
-
-	/**
-	*  Get the heightmap array at the chunk column coordinate
-	*  @param OutVoxelsArray - Empty TArray that serves as output
-	*/
-	void GetChunkHeightsArray(const FIntVector2D& HeightmapCoord, TArray<int32>& OutHeightsArray);
-
-	/**
-	*  Gets all the heights from MinHeightCoord to MaxHeightCoord and store in an array.
-	*  @param MinHeightCoord - Lower bound (in voxels) of the height to get (Inclusive)
-	*  @param MaxHeightCoord - Upper bound (in voxels) of the height to get (Inclusive)
-	*  @param OutHeightmapArray - Empty TArray that the function outputs to.
-	*/
-	void GetHeightsArray(const FIntVector2D& MinHeightCoord, const FIntVector2D& MaxHeightCoord, TArray<int32>& OutHeightsArray);
-
-	
-};
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+#include "ChunkUtils.h"
+#include "TerrainParameters.h"
+#include "ChunkLifecycle.h"
+#include "TerrainInterestManager.h"
+#include "TerrainFrameBudget.h"
+#include "TerrainQualityController.h"
+
+#include "Async/Future.h"
+#include "GameFramework/Actor.h"
+#include "VoxelTerrain.generated.h"
+
+/** How far along every chunk of a region has to be for RequestRegion to complete. Every stage includes the ones before it */
+UENUM(BlueprintType)
+enum class ETerrainRegionStage : uint8
+{
+	/* Generated and loaded */
+	Voxels UMETA(DisplayName = "Voxels"),
+	/* Has a mesh component */
+	Mesh UMETA(DisplayName = "Mesh"),
+	/* Has a mesh and a collision component, so it can be stood on */
+	Collision UMETA(DisplayName = "Collision")
+};
+
+/** A region requested with AVoxelTerrain::RequestRegion */
+struct FTerrainRegionHandle
+{
+	/* Passed to AVoxelTerrain::ReleaseRegion once the region doesn't have to stay loaded */
+	int32 RegionId;
+
+	/* True once every chunk reached the required stage, false if the region was released or the terrain destroyed first */
+	TSharedFuture<bool> Future;
+};
+
+UCLASS()
+class AETHERIAGAME_API AVoxelTerrain : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	// Sets default values for this actor's properties
+	AVoxelTerrain(const class FObjectInitializer& ObjectInitializer);
+
+	virtual void BeginDestroy() override;
+
+	virtual void BeginPlay() override;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	static FIntVector3 WorldToChunkCoord(const FIntVector3& WorldCoord);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	static FIntVector3 ChunkToWorldCoord(const FIntVector3& ChunkCoord);
+
+
+private:
+
+	/* The chunks waiting to be generated, shared by all the generation threads */
+	class FTerrainGenerationQueue* GenerationQueue;
+
+	/* The columns the generation threads finished, drained every tick */
+	class FTerrainCompletionQueue* CompletionQueue;
+
+	/* The pool of threads that generate the terrain */
+	TArray<class FTerrainGenerationThread*> GenerationThreads;
+
+	/* Every structure placed by the generation threads, by the columns it reaches into */
+	class FStructureRegistry* StructureRegistry;
+
+	/* Stores all the Chunks in the terrain, indexed by LoadedChunksIndex */
+	UPROPERTY(Transient, DuplicateTransient)
+	TArray<FChunk> LoadedChunks;
+	/* Stores the index of the Chunk at a Chunk Coordinate, to access the Chunk in LoadedChunks */
+	TMap<FIntVector3, int32> LoadedChunksIndex;
+	/* The Mutex for both LoadedChunksIndex AND LoadedChunks */
+	FCriticalSection LoadedChunksMutex;
+
+	/* Stores the Mesh Component for at a Chunk Coordinate. Not Thread Safe because only main game thread should create/modify UObject. */
+	TMap<FIntVector3, class UChunkMeshComponent*> LoadedChunkMeshComponents;
+	/* The Mutex for LoadedChunkMeshComponents */
+	FCriticalSection LoadedChunkMeshesMutex;
+
+	/* Stores the Collision Component for at a Chunk Coordinate. Not Thread Safe because only main game thread should create/modify UObject. */
+	TMap<FIntVector3, class UChunkCollisionComponent*> LoadedChunkCollisionComponents;
+	/* The Mutex for LoadedChunkCollisionComponents */
+	FCriticalSection LoadedChunkCollisionsMutex;
+
+	/* The state of every chunk that was requested, from being generated to being unloaded. Game thread only. */
+	FChunkLifecycle ChunkLifecycle;
+
+	/* The union of the columns every viewer needs. Chunks are only requested, meshed and unloaded again when a viewer changes chunk. */
+	FTerrainInterestManager Interest;
+
+	/* Actors the terrain is streamed around besides the players, with their draw and collision distances */
+	struct FViewerAnchor
+	{
+		TWeakObjectPtr<AActor> Actor;
+		int32 DrawDistanceInChunks;
+		int32 CollisionDistanceInChunks;
+	};
+	TArray<FViewerAnchor> ViewerAnchors;
+
+	/* Columns in the union that haven't been requested yet, in the order they are requested */
+	TArray<FIntVector2D> PendingRequests;
+
+	/* A region gameplay code is waiting on. Identical requests share one */
+	struct FRegionRequest
+	{
+		FIntVector3 MinChunk;
+		FIntVector3 MaxChunk;
+		ETerrainRegionStage Stage;
+		int32 NumUsers;
+		bool bReady;
+		TSharedPtr<TPromise<bool>> Promise;
+		TSharedFuture<bool> Future;
+	};
+	TMap<int32, FRegionRequest> RegionRequests;
+	int32 NextRegionId;
+
+	/* The area around the player start, held until it is playable and then left to the viewers. INDEX_NONE once it was released, or if SpawnRadiusInChunks is 0 */
+	FTerrainRegionHandle SpawnRegion;
+
+	/* FPlatformTime::Seconds() when BeginPlay started, and how long after it the spawn area became playable. Negative until it is */
+	double BeginPlaySeconds;
+	double TimeToPlayable;
+
+	/* Chunks in the draw distance of the viewers that had no mesh, sampled every tick while Aetheria.Streaming.MissingChunkStats is on */
+	struct FMissingChunkStats
+	{
+		double Seconds;
+		/* The number of missing chunks times the length of the tick, summed */
+		double MissingChunkSeconds;
+		int32 MaxMissingChunks;
+
+		/* The same over the last second, logged when it is over */
+		double WindowSeconds;
+		double WindowMissingChunkSeconds;
+		int32 WindowMaxMissingChunks;
+	};
+	FMissingChunkStats MissingChunkStats;
+
+	/* Chunks whose mesh was marked for a low priority update, guarded by LoadedChunkMeshesMutex */
+	TSet<FIntVector3> DirtyChunkMeshes;
+
+	/* Splits TerrainParameters.MaxUpdateTime between the kinds of work done every tick */
+	FTerrainFrameBudget FrameBudget;
+
+	/* Lowers the load expansion and draw distance of the viewers when the game can't keep up */
+	FTerrainQualityController Quality;
+
+	/* Chunks waiting for a mesh or a collision component, nearest first. Rebuilt when a viewer moves to another chunk */
+	TArray<FIntVector3> PendingMeshes;
+	TArray<FIntVector3> PendingCollisions;
+
+	/* Loaded columns that are out of range of every viewer, unloaded as the frame budget allows */
+	TSet<FIntVector2D> PendingUnloads;
+
+	/* Unloading columns whose components are destroyed, their voxels are released on a later tick as the frame budget allows */
+	TArray<FIntVector2D> UnloadingColumns;
+
+	float time = 0.0f;
+
+public:
+
+	/* Parameter for terrain generation */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Terrain")
+	FTerrainGeneratorParameters TerrainGenParameters;
+
+	/* Parameter for voxel terrain */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Voxel Terrain")
+	FTerrainParameters TerrainParameters;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// UPDATE METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+public:
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	bool IsColumnPending(const FIntVector2D& ColumnCoord);
+
+	/** Generates every chunk in the column at <x, y>. @returns false if the column is already requested or loaded */
+	bool LoadColumn(const FIntVector2D& ColumnCoord);
+
+	/** Stops a pending column from being generated. Columns already being generated are discarded when they arrive. */
+	void CancelColumn(const FIntVector2D& ColumnCoord);
+
+	/** Destroys the mesh and collision components of every chunk in a loaded column, its voxels are released by FinishUnloadColumn on a later tick */
+	void UnloadColumn(const FIntVector2D& ColumnCoord);
+
+	/** Releases the voxels of a column that UnloadColumn was called on */
+	void FinishUnloadColumn(const FIntVector2D& ColumnCoord);
+
+	/** The lifecycle state of every requested chunk */
+	const FChunkLifecycle& GetChunkLifecycle() const { return ChunkLifecycle; }
+
+	/** The time every kind of terrain work took last tick, and its totals */
+	FTerrainFrameBudget& GetFrameBudget() { return FrameBudget; }
+
+	/** How far the radii of the viewers are lowered, and why */
+	FTerrainQualityController& GetQuality() { return Quality; }
+
+	/** The viewers the terrain was streamed around last tick, and the columns they need */
+	const FTerrainInterestManager& GetInterest() const { return Interest; }
+
+	/**
+	*  Streams the terrain around an actor that isn't a player, like an AI anchor. Players are streamed around on their own.
+	*  @param DrawDistanceInChunks - 0 or less uses TerrainParameters.DrawDistanceInChunks
+	*  @param CollisionDistanceInChunks - 0 or less uses TerrainParameters.CollisionDistanceInChunks
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
+	void AddViewerAnchor(AActor* Actor, const int32 DrawDistanceInChunks = 0, const int32 CollisionDistanceInChunks = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
+	void RemoveViewerAnchor(AActor* Actor);
+
+	/**
+	*  Streams a box of the world no matter where the viewers are, like the destination of a teleport or where a structure is spawned.
+	*  The region is requested as if it were Priority columns from a viewer, and stays loaded until it is released.
+	*  Identical requests share one region and one future, and every one of them has to be released.
+	*  @param Bounds - the box in world space, clamped to the height of the world
+	*  @param RequiredStage - the stage every chunk of the region has to reach for the future to complete
+	*/
+	FTerrainRegionHandle RequestRegion(const FBox& Bounds, const ETerrainRegionStage RequiredStage, const float Priority = 0.0f);
+
+	/** Lets a requested region be unloaded once no viewer needs it. Completes its future with false if it isn't ready yet */
+	void ReleaseRegion(const int32 RegionId);
+
+	/** Logs the average and max number of chunks in the draw distance of the viewers that had no mesh */
+	void LogMissingChunkStats(const bool bReset);
+
+	/** @returns the seconds from BeginPlay until the area around the player start was meshed and had collision, negative until it is or if SpawnRadiusInChunks is 0 */
+	double GetTimeToPlayable() const { return TimeToPlayable; }
+
+	/**
+	*  Add all the chunks of a column to the client/server's loaded chunks. The heightmaps are already computed by the generator.
+	*  The chunks are moved out of the column.
+	*  @returns false if the column was cancelled or already loaded, and was dropped
+	*/
+	bool AddColumn(FChunkColumn& Column);
+
+	/** The structures of the terrain, shared by all the generation threads. Null before BeginPlay. */
+	class FStructureRegistry* GetStructureRegistry() const { return StructureRegistry; }
+
+	/** Updates the light values in the verticle chunk */
+	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
+	void UpdateChunkHeightmap(const FIntVector3& ChunkCoord);
+
+	void GenerateMesh(const FIntVector3& ChunkCoord);
+
+	void GenerateCollision(const FIntVector3& ChunkCoord);
+
+private:
+
+	/** Gets every player, spectators included, and every anchor that is still alive */
+	void GatherViewers(TArray<FTerrainViewer>& OutViewers);
+
+	/**
+	*  Queues the columns that entered the union to be requested and cancels the pending ones that left it. Loaded columns are queued
+	*  to be unloaded once they are more than a column past every viewer, so a viewer walking along the edge doesn't reload them.
+	*/
+	void ApplyInterestChanges(const FTerrainInterestManager::FChanges& Changes);
+
+	/** Orders the columns waiting to be requested, nearest to a viewer and in view first */
+	void SortPendingRequests();
+
+	/** Requests up to Aetheria.Streaming.RequestsPerTick pending columns */
+	void RequestPendingColumns();
+
+	/**
+	*  Samples the real frame time, the memory of the chunks and the backlog, the radii of the viewers follow the next time they are gathered.
+	*  @returns whether the radii changed
+	*/
+	bool UpdateQuality();
+
+	/** Tells the generation queue where the viewers, the places they are heading to and the requested regions are */
+	void UpdateGenerationViewers();
+
+	/** Queues the ready chunks of a region that don't have the mesh and collision components its stage needs yet */
+	void QueueRegionChunks(const FRegionRequest& Request, const bool bQueueMeshes, const bool bQueueCollisions);
+
+	/** Whether every chunk of the region reached its stage */
+	bool IsRegionReady(const FRegionRequest& Request) const;
+
+	/** Completes the futures of the regions that became ready */
+	void UpdateRegionRequests();
+
+	/** Where the first player most likely spawns: the first player start, or the terrain itself if there is none */
+	FVector FindSpawnLocation() const;
+
+	/**
+	*  Generates, meshes and gives collision to a region before returning, instead of over the next ticks.
+	*  The columns are generated on every core, meshes and collision are components so they are made on the game thread.
+	*/
+	void WarmStartRegion(const FRegionRequest& Request);
+
+	/** Reports the time to playable once the spawn area is ready, then releases it */
+	void UpdateSpawnRegion();
+
+	/** Counts the chunks in the draw distance of the viewers that have no mesh, if Aetheria.Streaming.MissingChunkStats is on */
+	void UpdateMissingChunkStats(const float DeltaSeconds);
+
+	/** Adds the columns the generation threads finished to the terrain, as long as the frame budget allows */
+	void AddCompletedColumns();
+
+	/**
+	*  Queues the chunks whose neighbors just arrived to be meshed, and the ready chunks around the viewers to be collided.
+	*  Only walks the draw distance around the viewers, nearest first, when a viewer moved to another chunk.
+	*/
+	void UpdateReadyChunks(const bool bViewersMoved);
+
+	/** Queues the chunks of a column that need a mesh */
+	void QueueReadyChunkMeshes(const FIntVector2D& ColumnCoord);
+
+	/** Builds the queued collision components, as long as the frame budget allows */
+	void CollidePendingChunks();
+
+	/** Builds the queued mesh components, then rebuilds the meshes marked for a low priority update, as long as the frame budget allows */
+	void MeshPendingChunks();
+
+	/** Releases the voxels of the columns unloaded on earlier ticks, then unloads the queued columns that are still out of range, as long as the frame budget allows */
+	void UnloadPendingColumns();
+
+	/**
+	*  Stamps the structures that reached into columns after they were generated. Spills of columns that are still pending
+	*  are kept for later, and the ones of columns that aren't loaded are dropped because the registry stamps them when they are generated.
+	*/
+	void ApplyStructureSpills();
+
+public:
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// VOXEL/CHUNK METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	FVoxelType GetVoxelType(const uint8& Voxel) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	int32 GetNumVoxelTypes() const;
+
+	/**
+	*  Get the voxel at voxel coordinate <x, y, z>
+	*  @returns voxel type as uint8
+	*/
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	uint8 GetVoxelAt(const int32& x, const int32& y, const int32& z);
+
+	/** Set the voxel at voxel coordinate <x, y, z> */
+	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
+	void SetVoxelAt(const int32& x, const int32& y, const int32& z, uint8 Voxel);
+
+	/**
+	*  Mark an area of voxels to be 'dirty' and use that area to determine which chunks
+	*  need mesh updates, ambient occlusion updates only, and/or collision update.
+	*  Ambient Occlusion updates will be determined by the AORadius of the terrain.
+	*	@param MinVoxelCoord - Lower bound of the area of voxels that are changed (Inclusive)
+	*  @param MaxVoxelCoord - Upper bound of the area of voxels that are changed (Inclusive)
+	*/
+	void MarkVoxelAreaDirty(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord);
+
+	/**
+	*  Mark a single voxel to be 'dirty' and use that voxel to determine which chunks
+	*  need mesh updates, ambient occlusion updates only, and/or collision update.
+	*  Ambient Occlusion updates will be determined by the AORadius of the terrain.
+	*/
+	void MarkVoxelDirty(const FIntVector3& VoxelCoord);
+
+	/**
+	*  This method should be used with caution as it is the least imprecise and creates the most updates. Use Mark Voxel Dirty instead.
+	*  Mark a single Chunk to be 'dirty', all chunks around will get a mesh update and a collision update.
+	*  Also all chunks of all Z Coordinate in its Moore's neighbour will get an ambient occlusion update.
+	*/
+	void MarkChunkDirty(const FIntVector3& ChunkCoord);
+
+	/**
+	*  Get the voxels array at the chunk coordinate
+	*  @param OutVoxelsArray - Empty TArray that the function outputs to
+	*/
+	void GetChunkVoxelsArray(const FIntVector3& ChunkCoord, TArray<uint8>& OutVoxelsArray);
+
+	/**
+	*  Gets all the voxels from MinVoxelCoord to MaxVoxelCoord and store in an array.
+	*	@param MinVoxelCoord - Lower bound of the block of voxels to get (Inclusive)
+	*  @param MaxVoxelCoord - Upper bound of the block of voxels to get (Inclusive)
+	*  @param OutVoxelsArray - Empty TArray that the function outputs to.
+	*/
+	void GetVoxelsArray(const FIntVector3& MinVoxelCoord, const FIntVector3& MaxVoxelCoord, TArray<uint8>& OutVoxelsArray);
+
+
+	/** Returns whether the chunk at chunk coord is loaded on this Client/Server */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	bool HasChunk(const FIntVector3& ChunkCoord);
+
+	bool HasAllNeighborChunks(const FIntVector3& ChunkCoord);
+
+	/** Returns a FChunk Reference at ChunkCoord. Warning: Only use when ChunkCoord is sure to exist, raises error if not. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	FChunk& GetChunkAt(const FIntVector3& ChunkCoord);
+
+	/** Returns a FChunk Reference AND its index at ChunkCoord. Warning: Only use when ChunkCoord is sure to exist, raises error if not. */
+	FChunk& GetChunkAndIndexAt(const FIntVector3& ChunkCoord, int32& OutChunkIndex);
+
+	/** Returns the chunk's index at ChunkCoord. Warning: Only use when ChunkCoord is sure to exist, raises error if not. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	int32 GetChunkIndexAt(const FIntVector3& ChunkCoord);
+
+	/** Returns whether all the chunks at <x, y> are loaded. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	bool HasChunkColumn(const FIntVector2D& ChunkColumnCoord);
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// CHUNK MESH METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** Returns whether the Collision for the chunks at ChunkCoord is loaded. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	bool HasChunkMesh(const FIntVector3& ChunkCoord);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// CHUNK COLLISION METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** Returns whether the Collision for the chunks at ChunkCoord is loaded. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Voxel Terrain")
+	bool HasChunkCollision(const FIntVector3& ChunkCoord);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// HEIGHTMAP METHODS
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** Get the heightmap value at world voxel coordinate <x, y> */
+	UFUNCTION(BlueprintCallable, Category = "Voxel Terrain")
+	int32 GetHeightAt(const int32& x, const int32& y);
+
+	/**
+	*  Get the heightmap array at the chunk column coordinate
+	*  @param OutVoxelsArray - Empty TArray that serves as output
+	*/
+	void GetChunkHeightsArray(const FIntVector2D& HeightmapCoord, TArray<int32>& OutHeightsArray);
+
+	/**
+	*  Gets all the heights from MinHeightCoord to MaxHeightCoord and store in an array.
+	*  @param MinHeightCoord - Lower bound (in voxels) of the height to get (Inclusive)
+	*  @param MaxHeightCoord - Upper bound (in voxels) of the height to get (Inclusive)
+	*  @param OutHeightmapArray - Empty TArray that the function outputs to.
+	*/
+	void GetHeightsArray(const FIntVector2D& MinHeightCoord, const FIntVector2D& MaxHeightCoord, TArray<int32>& OutHeightsArray);
+
+	
+};
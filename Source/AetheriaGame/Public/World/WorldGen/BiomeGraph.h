@@ -0,0 +1,345 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+#include "NoiseGenerator.h"
+
+#include "BiomeGraph.generated.h"
+
+/** Set to 1 to time every instruction of the biome programs by the graph node it came from, see Aetheria.BiomeGraph.Profile */
+#ifndef BIOME_GRAPH_PROFILING
+	#define BIOME_GRAPH_PROFILING 0
+#endif
+
+/** What a node of the biome graph computes */
+UENUM(BlueprintType)
+enum class EBiomeNodeType : uint8
+{
+	/* Value */
+	Constant,
+	/* The height of the voxel, 0 at the bottom of the world and 1 at the top */
+	Height,
+	/* USimplexNoise::Fractal3D of the voxel's coordinates times Scale */
+	Fractal,
+	/* USimplexNoise::RidgedMulti3D of the voxel's coordinates times Scale */
+	RidgedMulti,
+	/* A + B */
+	Add,
+	/* A * B */
+	Multiply,
+	/* The smaller of A and B */
+	Min,
+	/* The larger of A and B */
+	Max,
+	/* A mapped through CurvePoints */
+	Curve
+};
+
+/** One node of a biome graph. Nodes only read nodes that come before them in the graph. */
+USTRUCT(BlueprintType)
+struct FBiomeNode
+{
+	GENERATED_BODY()
+
+	/* Only used to name the node in the profiler */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	FName Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	EBiomeNodeType Type;
+
+	/* Indices of the nodes read by Add, Multiply, Min, Max (A and B) and Curve (A) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	int32 InputA;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	int32 InputB;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	float Value;
+
+	/* The noise channel of the seed, nodes with the same channel share their noise. ETerrainNoiseChannel::Density is the built-in terrain's. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	int32 Channel;
+
+	/* Voxel coordinates are multiplied by this before the noise */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	float Scale;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	int32 Octaves;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	float Frequency;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	float Lacunarity;
+
+	/* Not used by RidgedMulti, which always uses 1 / Lacunarity */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	float Persistence;
+
+	/* Samples the noise at z = 0, so it only depends on <x, y> and is evaluated once per column */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	bool bIgnoreZ;
+
+	/* Points of a piecewise linear curve sorted by X, the ends are held flat */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Node")
+	TArray<FVector2D> CurvePoints;
+
+	FBiomeNode()
+		: Type(EBiomeNodeType::Constant), InputA(-1), InputB(-1), Value(0.0f), Channel(0), Scale(0.01f),
+		Octaves(1), Frequency(1.0f), Lacunarity(2.0f), Persistence(0.5f), bIgnoreZ(false) {}
+};
+
+/** Voxels with a density below MaxDensity, and above the layer before, are Voxel */
+USTRUCT(BlueprintType)
+struct FBiomeLayer
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Layer")
+	float MaxDensity;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Layer")
+	int32 Voxel;
+
+	FBiomeLayer() : MaxDensity(0.0f), Voxel(0) {}
+
+	FBiomeLayer(float InMaxDensity, int32 InVoxel) : MaxDensity(InMaxDensity), Voxel(InVoxel) {}
+};
+
+/** A biome, which turns its own density into voxels and decorates its surface */
+USTRUCT(BlueprintType)
+struct FBiome
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	FName Name;
+
+	/* The biome is picked where the selector is below this, and not below the MaxSelector of the biome before. The last biome takes the rest. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	float MaxSelector;
+
+	/* Index of the node with the biome's density */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	int32 DensityNode;
+
+	/* Sorted by MaxDensity. Voxels denser than every layer are air. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	TArray<FBiomeLayer> Layers;
+
+	/* Put on the air voxel above the ground, 0 for nothing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	int32 SurfaceVoxel;
+
+	/* Chance of a tree on every surface voxel (between 0 - 1), when the terrain creates trees */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome")
+	float TreeDensity;
+
+	FBiome() : MaxSelector(0.0f), DensityNode(-1), SurfaceVoxel(0), TreeDensity(0.0f) {}
+};
+
+/**
+A data driven terrain: a graph of noise and math nodes, the biomes, and the node that picks between them.
+Compiled into an FBiomeProgram before generation.
+*/
+USTRUCT(BlueprintType)
+struct FBiomeGraph
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Graph")
+	TArray<FBiomeNode> Nodes;
+
+	/* Index of the node that picks the biome of every column. It can't depend on z. -1 uses the first biome everywhere. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Graph")
+	int32 SelectorNode;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Biome Graph")
+	TArray<FBiome> Biomes;
+
+	FBiomeGraph() : SelectorNode(-1) {}
+};
+
+/** What a biome puts on its surface, read by the surface pass of the terrain generator */
+struct FBiomeSurface
+{
+	uint8 SurfaceVoxel;
+	float TreeDensity;
+};
+
+typedef TSharedPtr<const class FBiomeProgram, ESPMode::ThreadSafe> FBiomeProgramPtr;
+
+/**
+A biome graph compiled for a seed into a flat list of row instructions.
+Constants are folded, chains of scaling and offsetting by constants are fused into one instruction, and nodes nothing reads are dropped.
+Instructions that don't depend on z run once per row of columns and the rest once per row of voxels, with every row of noise
+evaluated by the batch kernels. Instructions only needed by biomes that aren't in the row are skipped.
+Immutable once compiled, so any number of generation threads can run it.
+*/
+class AETHERIAGAME_API FBiomeProgram
+{
+
+public:
+
+	/**
+	*  Compiles a graph for a seed.
+	*  @param OutError - Why the graph is invalid
+	*  @returns the program, or an invalid pointer if the graph is invalid
+	*/
+	static FBiomeProgramPtr Compile(const FBiomeGraph& Graph, int32 Seed, FString& OutError);
+
+	/**
+	*  Fills a block of voxels the same way UTerrainGenerator's density pass does.
+	*  @param Voxels - Indexed x + y * VoxelsSize.X + z * VoxelsSize.X * VoxelsSize.Y, already sized
+	*  @param OutBiomes - The biome of every <x, y>
+	*  @param OutAirHeight - Every layer from it up is air
+	*/
+	void Run(const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, TArray<uint8>& OutBiomes, int32& OutAirHeight) const;
+
+	/**
+	*  Finds the ground of every <x, y> without filling the block, for previews. Each row of columns is evaluated from the top layer down,
+	*  and stops as soon as every column of the row has a solid voxel.
+	*  @param OutHeights - One above the highest solid voxel of every <x, y>, 0 if the whole column is air
+	*  @param OutTopVoxels - The highest solid voxel of every <x, y>, before the surface voxel is put on it
+	*  @param OutBiomes - The biome of every <x, y>
+	*/
+	void RunSurface(const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<int32>& OutHeights, TArray<uint8>& OutTopVoxels, TArray<uint8>& OutBiomes) const;
+
+	int32 GetNumBiomes() const { return Biomes.Num(); }
+
+	const FBiomeSurface& GetSurface(int32 Biome) const { return Biomes[Biome].Surface; }
+
+	/** Hash of the graph and seed the program was compiled from */
+	uint32 GetHash() const { return Hash; }
+
+	/** Logs the instructions, and how long each one took if BIOME_GRAPH_PROFILING is on */
+	void LogProfile() const;
+
+	void ResetProfile() const;
+
+	/** @returns the last program that was compiled, for the profiling console command */
+	static FBiomeProgramPtr GetLastCompiled();
+
+private:
+
+	enum class EOp : uint8
+	{
+		Fill,
+		Height,
+		Fractal,
+		RidgedMulti,
+		Add,
+		Multiply,
+		Min,
+		Max,
+		Affine,
+		Curve
+	};
+
+	struct FInstruction
+	{
+		EOp Op;
+
+		/* Registers */
+		int32 Dest;
+		int32 A;
+		int32 B;
+
+		/* Affine computes A * Scale + Bias, Fill writes Bias */
+		float Scale;
+		float Bias;
+
+		/* Noise */
+		int32 Generator;
+		float NoiseScale;
+		int32 Octaves;
+		float Frequency;
+		float Lacunarity;
+		float Persistence;
+		bool bIgnoreZ;
+
+		/* Curve, a range of CurvePoints */
+		int32 FirstCurvePoint;
+		int32 NumCurvePoints;
+
+		/* Bit i is set if biome i needs the result */
+		uint32 BiomeMask;
+
+		/* Graph node the result belongs to */
+		int32 Node;
+	};
+
+	struct FCompiledBiome
+	{
+		int32 DensityRegister;
+		TArray<FBiomeLayer> Layers;
+		FBiomeSurface Surface;
+
+		/** @returns the voxel of the first layer the density is below, air if it is denser than every layer */
+		FORCEINLINE uint8 Classify(float Density) const
+		{
+			for (const FBiomeLayer& Layer : Layers)
+			{
+				if (Density < Layer.MaxDensity)
+				{
+					return (uint8)Layer.Voxel;
+				}
+			}
+			return 0;
+		}
+	};
+
+#if BIOME_GRAPH_PROFILING
+	struct FInstructionProfile
+	{
+		volatile int64 Cycles;
+		volatile int64 Rows;
+	};
+#endif
+
+	/* The selector and everything it reads, then the rest of the instructions that don't depend on z, then the ones that do */
+	TArray<FInstruction> SelectorInstructions;
+	TArray<FInstruction> ColumnInstructions;
+	TArray<FInstruction> VoxelInstructions;
+
+	int32 NumRegisters;
+	int32 SelectorRegister;
+
+	TArray<FCompiledBiome> Biomes;
+	TArray<float> BiomeMaxSelectors;
+
+	TArray<FNoiseGenerator> Generators;
+	TArray<FVector2D> CurvePoints;
+
+	/* Names of the graph nodes, for the profiler */
+	TArray<FString> NodeNames;
+
+	uint32 Hash;
+
+#if BIOME_GRAPH_PROFILING
+	/* Indexed like the instructions, selector first, then column, then voxel. The last one is classifying the voxels. */
+	mutable TArray<FInstructionProfile> Profile;
+#endif
+
+	FBiomeProgram() : NumRegisters(0), SelectorRegister(-1), Hash(0) {}
+
+	/**
+	*  Runs the selector on a row and picks the biome of every column
+	*  @returns the mask of the biomes in the row
+	*/
+	uint32 SelectRowBiomes(const FIntVector3& RowOrigin, int32 Count, float* Registers, uint8* OutRowBiomes) const;
+
+	/**
+	*  Runs a list of instructions on a row, skipping the ones no biome in RowBiomeMask needs
+	*  @param RowOrigin - World coordinate of the first voxel of the row
+	*  @param Registers - Register i of the row is at i * Count
+	*/
+	void RunInstructions(const TArray<FInstruction>& Instructions, int32 ProfileOffset, uint32 RowBiomeMask, const FIntVector3& RowOrigin, int32 Count, float* Registers) const;
+
+};
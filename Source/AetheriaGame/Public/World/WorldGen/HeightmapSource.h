@@ -0,0 +1,85 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+A 16 bit heightmap file that is read a tile at a time, so even a 16k x 16k map is never fully in memory.
+Raw files (.r16, .raw) are little endian with no header and are read in place. PNGs are compressed, so they are decoded once
+into a raw file in Saved/Heightmaps, next to nothing is kept of the PNG itself.
+The tiles that were read recently are kept in a cache bounded by Aetheria.Heightmap.CacheMB. Safe to read from any thread.
+*/
+class AETHERIAGAME_API FHeightmapSource
+{
+
+public:
+
+	/** Pixels on each side of a tile */
+	static const int32 TILE_SIZE = 256;
+
+	/**
+	*  Opens a heightmap. Has to be called on the game thread, because decoding a PNG loads the image wrapper module.
+	*  @param Filename - Relative paths start at the project directory
+	*  @param RawWidth, RawHeight - Dimensions of a raw file, which has no header. Ignored for PNGs.
+	*  @returns an invalid pointer if the file can't be read, with the reason in OutError
+	*/
+	static TSharedPtr<FHeightmapSource, ESPMode::ThreadSafe> Open(const FString& Filename, int32 RawWidth, int32 RawHeight, FString& OutError);
+
+	~FHeightmapSource();
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+
+	/** Hash of the file's path, size and time stamp, so cached noise tiles of an older version of the file aren't used */
+	uint32 GetHash() const { return Hash; }
+
+	/**
+	*  Copies the samples of a rectangle of pixels, indexed x + y * SizeX. Pixels outside of the map repeat its edge.
+	*  @param MinX, MinY - The first pixel of the rectangle, can be outside of the map
+	*/
+	void ReadRect(int32 MinX, int32 MinY, int32 SizeX, int32 SizeY, uint16* OutSamples) const;
+
+	/** @returns the memory the cached tiles take */
+	int64 GetCachedBytes() const;
+
+private:
+
+	typedef TSharedPtr<const TArray<uint16>, ESPMode::ThreadSafe> FTilePtr;
+
+	struct FCachedTile
+	{
+		FTilePtr Samples;
+		// Value of UseCounter the last time the tile was read. The smallest one is evicted first.
+		uint64 LastUse;
+	};
+
+	class IFileHandle* FileHandle;
+
+	int32 Width;
+	int32 Height;
+	uint32 Hash;
+
+	/* The Mutex for FileHandle, whose reads have to seek first */
+	mutable FCriticalSection FileMutex;
+
+	mutable TMap<FIntPoint, FCachedTile> Tiles;
+	mutable uint64 UseCounter;
+
+	/* The Mutex for Tiles and UseCounter */
+	mutable FCriticalSection TilesMutex;
+
+	FHeightmapSource(class IFileHandle* InFileHandle, int32 InWidth, int32 InHeight, uint32 InHash);
+
+	/** @returns the tile, reading it from the file if it isn't cached */
+	FTilePtr GetTile(const FIntPoint& TileCoord) const;
+
+	/** Reads a tile from the file, tiles on the edges of the map are smaller */
+	FTilePtr ReadTile(const FIntPoint& TileCoord) const;
+
+	/** Decodes a 16 bit grayscale PNG into a raw file, unless it was already decoded since the PNG last changed */
+	static bool DecodePNG(const FString& Filename, FString& OutRawFilename, int32& OutWidth, int32& OutHeight, FString& OutError);
+
+};
+
+typedef TSharedPtr<FHeightmapSource, ESPMode::ThreadSafe> FHeightmapSourcePtr;
@@ -0,0 +1,50 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "SimplexNoiseBatch.h"
+
+/**
+3D simplex noise with its own permutation and gradient tables, one for each seed and channel.
+Coordinates are doubles and are split into an integer lattice offset and a small float part before the noise is evaluated,
+so the noise is as precise a million units away from the origin as it is next to it.
+The functions give the same values as USimplexNoise's, apart from the tables, and are safe to call from any thread.
+*/
+class AETHERIAGAME_API FNoiseGenerator
+{
+
+public:
+
+	/** Uses the same tables as USimplexNoise */
+	FNoiseGenerator();
+
+	/** Shuffles the tables from the seed. Every channel of a seed is unrelated to the others. */
+	FNoiseGenerator(int32 Seed, uint32 Channel);
+
+	/** @returns the 3D noise function at <x, y, z> */
+	float Noise3D(double x, double y, double z) const;
+
+	/** @returns the fBm fractal function at <x, y, z>, see USimplexNoise::Fractal3D */
+	float Fractal3D(double x, double y, double z, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f, float Persistence = 0.5f) const;
+
+	/** @returns the ridged multifractal function at <x, y, z>, see USimplexNoise::RidgedMulti3D */
+	float RidgedMulti3D(double x, double y, double z, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f) const;
+
+	/** Same as calling Fractal3D(StartX + i * StepX, Y, Z, ...) for every i < Count */
+	void Fractal3DRow(double StartX, double StepX, double Y, double Z, int32 Count, float* Out, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f, float Persistence = 0.5f) const;
+
+	/** FSimplexNoiseBatch::Fractal3DRowBands for the points StartX + i * StepX */
+	int32 Fractal3DRowBands(double StartX, double StepX, double Y, double Z, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f, float Persistence = 0.5f) const;
+
+	/** Same as calling RidgedMulti3D(StartX + i * StepX, Y, Z, ...) for every i < Count */
+	void RidgedMulti3DRow(double StartX, double StepX, double Y, double Z, int32 Count, float* Out, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f) const;
+
+	const FSimplexNoiseTables& GetTables() const { return Tables; }
+
+private:
+
+	FSimplexNoiseTables Tables;
+
+};
@@ -0,0 +1,151 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+
+/** Identifies a tile of generated noise. Tiles are only shared between terrains with the same seed and generator parameters. */
+struct FNoiseTileKey
+{
+	int32 Seed;
+
+	/* Hash of every generator parameter the tile depends on */
+	uint32 ParameterHash;
+
+	/* Column coordinate of the tile */
+	FIntVector2D TileCoord;
+
+	FNoiseTileKey() {}
+
+	FNoiseTileKey(int32 InSeed, uint32 InParameterHash, const FIntVector2D& InTileCoord)
+		: Seed(InSeed), ParameterHash(InParameterHash), TileCoord(InTileCoord) {}
+
+	friend bool operator==(const FNoiseTileKey& A, const FNoiseTileKey& B)
+	{
+		return A.Seed == B.Seed && A.ParameterHash == B.ParameterHash && A.TileCoord == B.TileCoord;
+	}
+
+	friend uint32 GetTypeHash(const FNoiseTileKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Seed), Key.ParameterHash), GetTypeHash(Key.TileCoord));
+	}
+};
+
+/**
+Everything the terrain generator computes from noise for a block of voxels, before the surface and trees are placed.
+Every value only depends on its world coordinate, so a block can be copied into any other block that overlaps it.
+*/
+struct FNoiseTile
+{
+	/* Origin and dimensions of the block in world space */
+	FIntVector3 Origin;
+	FIntVector3 Size;
+
+	/* Stone, grass or air with the caves carved out, indexed x + y * Size.X + z * Size.X * Size.Y */
+	TArray<uint8> Voxels;
+
+	/* Biome of every <x, y>, empty if the terrain has no biome graph */
+	TArray<uint8> Biomes;
+
+	/* Tree probability and leaf color noise of every <x, y>, empty if trees are disabled */
+	TArray<float> TreeProbs;
+	TArray<float> ColorNoises;
+
+	/* Every layer from it up is air */
+	int32 AirHeight;
+
+	int64 GetAllocatedSize() const
+	{
+		return sizeof(*this) + Voxels.GetAllocatedSize() + Biomes.GetAllocatedSize() + TreeProbs.GetAllocatedSize() + ColorNoises.GetAllocatedSize();
+	}
+};
+
+typedef TSharedPtr<const FNoiseTile, ESPMode::ThreadSafe> FNoiseTilePtr;
+
+/**
+A thread safe least recently used cache of noise tiles, shared by all the generation threads.
+A column that is generated again, like one the player comes back to, copies its tile instead of evaluating the noise again.
+The memory is bounded by Aetheria.NoiseTileCache.MaxMB, 0 turns the cache off.
+Generating with FTerrainGeneratorParameters::NoiseTileCache set uses that cache instead of the shared one, like the benchmarks do.
+*/
+class AETHERIAGAME_API FNoiseTileCache
+{
+
+public:
+
+	struct FStats
+	{
+		int64 Hits;
+		int64 Misses;
+		int64 Evictions;
+		int32 NumTiles;
+		int64 NumBytes;
+
+		double GetHitRate() const { return Hits + Misses > 0 ? (double)Hits / (double)(Hits + Misses) : 0.0; }
+	};
+
+private:
+
+	struct FEntry
+	{
+		FNoiseTilePtr Tile;
+		int64 NumBytes;
+		// Value of UseCounter the last time the tile was found or added. The smallest one is evicted first.
+		uint64 LastUse;
+	};
+
+	TMap<FNoiseTileKey, FEntry> Entries;
+
+	uint64 UseCounter;
+
+	int64 NumBytes;
+
+	int64 Hits;
+	int64 Misses;
+	int64 Evictions;
+
+	/* The Mutex for everything above */
+	mutable FCriticalSection CacheMutex;
+
+public:
+
+	FNoiseTileCache();
+
+	/** The cache every terrain generator uses */
+	static FNoiseTileCache& Get();
+
+	/** @returns whether Aetheria.NoiseTileCache.MaxMB allows any tiles */
+	static bool IsEnabled();
+
+	/** @returns the tile, or an invalid pointer if it isn't cached. Counts as a hit or a miss. */
+	FNoiseTilePtr Find(const FNoiseTileKey& Key);
+
+	/** Adds a tile, then evicts the least recently used tiles until the cache fits in its memory again. Keeps the existing tile if there is one. */
+	void Add(const FNoiseTileKey& Key, const FNoiseTilePtr& Tile);
+
+	/** Removes every tile */
+	void Empty();
+
+	/**
+	*  Writes the tiles of the keys to a file, so a later run can start with them. Doesn't count as hits or misses.
+	*  @returns the number of tiles written, the keys that aren't cached are skipped
+	*/
+	int32 SaveTiles(const FString& Filename, const TArray<FNoiseTileKey>& Keys) const;
+
+	/** @returns the number of tiles of a file written by SaveTiles that were added, 0 if it doesn't exist or was written by another version */
+	int32 LoadTiles(const FString& Filename);
+
+	FStats GetStats() const;
+
+	void ResetStats();
+
+private:
+
+	/** Mutex must be held */
+	void EvictToFit(int64 MaxBytes);
+
+};
+
+typedef TSharedPtr<FNoiseTileCache, ESPMode::ThreadSafe> FNoiseTileCachePtr;
@@ -0,0 +1,147 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define SIMPLEX_NOISE_BATCH_X86 1
+#else
+	#define SIMPLEX_NOISE_BATCH_X86 0
+#endif
+
+// Only arm64, the kernels use horizontal reductions 32 bit ARM doesn't have
+#if defined(__aarch64__) || defined(_M_ARM64)
+	#define SIMPLEX_NOISE_BATCH_NEON 1
+#else
+	#define SIMPLEX_NOISE_BATCH_NEON 0
+#endif
+
+/**
+Turns off floating point contraction for the rest of the file. Put at the top of every file with noise math, so no compiler
+fuses a multiply and an add into an FMA in one instruction set and not another.
+*/
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define SIMPLEX_NOISE_FP_CONTRACT_OFF __pragma(fp_contract(off))
+#elif defined(__clang__)
+	#define SIMPLEX_NOISE_FP_CONTRACT_OFF _Pragma("STDC FP_CONTRACT OFF")
+#elif defined(__GNUC__)
+	#define SIMPLEX_NOISE_FP_CONTRACT_OFF _Pragma("GCC optimize(\"fp-contract=off\")")
+#else
+	#define SIMPLEX_NOISE_FP_CONTRACT_OFF
+#endif
+
+/** The batch kernels are compiled with the octave loop unrolled for every octave count up to this */
+#define SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES 8
+
+/** The instruction sets the batch noise kernels are compiled for */
+enum class ENoiseInstructionSet : uint8
+{
+	Scalar,
+	SSE2,
+	AVX2,
+	NEON,
+
+	Num
+};
+
+/**
+Lookup tables used by the batch noise kernels.
+The tables are stored as int32 so they can be read with hardware gathers, and together they fit in 4KB of L1.
+*/
+MS_ALIGN(64) struct FSimplexNoiseTables
+{
+	// Random jumble of 0 - 255, repeated twice to avoid wrapping the index at 255
+	int32 Perm[512];
+
+	// Hashes the lattice point one last time into the gradient used there, only the lowest 4 bits are used.
+	// Same as Perm for the default tables, which is the last lookup SimplexNoiseImplementation does.
+	int32 Gradients[512];
+} GCC_ALIGN(64);
+
+/**
+One octave of a row of noise, for the lower level batch functions.
+The coordinates are relative to a lattice point so they stay small, and Offset moves them back to where they are.
+Only lattice points whose coordinates add up to a multiple of 3 can be used, the simplex grid is the same from all of them.
+*/
+struct FNoiseRowOctave
+{
+	// Local coordinates of the points, X has one per point
+	const float* X;
+	float Y;
+	float Z;
+
+	// Added to the simplex cell of every point before it is hashed
+	int32 OffsetX;
+	int32 OffsetY;
+	int32 OffsetZ;
+
+	float Amplitude;
+};
+
+/**
+Evaluates simplex noise for whole rows of points at once, which is a lot faster than calling USimplexNoise once per point.
+A row is Count points that share the same <y, z> with different x values.
+The kernel is chosen at runtime from the best instruction set the CPU supports. Every instruction set
+produces bit for bit the same results as the scalar USimplexNoise functions. No FMA is ever used: AVX2 is compiled
+without it and floating point contraction is off in the scalar and batch noise code.
+*/
+class AETHERIAGAME_API FSimplexNoiseBatch
+{
+
+public:
+
+	/** Same as calling USimplexNoise::Noise3D(X[i], Y, Z) for every i < Count */
+	static void Noise3DRow(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, float* Out);
+
+	/** Same as calling USimplexNoise::Fractal3D(X[i], Y, Z, ...) for every i < Count */
+	static void Fractal3DRow(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, float* Out, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f, float Persistence = 0.5f);
+
+	/**
+	*  Sorts every point of a fractal row into one of three bands by the value Offset - Fractal3D(X[i], Y, Z, ...) * Scale.
+	*  The band is 0 below Lower, 1 from Lower to below Upper, and 2 from Upper up, exactly the same as if the whole fractal was computed,
+	*  but the octaves of a point stop being added once the ones left can't move it into another band.
+	*  @returns the number of octaves evaluated, summed over every point
+	*/
+	static int32 Fractal3DRowBands(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f, float Persistence = 0.5f);
+
+	/** Same as calling USimplexNoise::RidgedMulti3D(X[i], Y, Z, ...) for every i < Count */
+	static void RidgedMulti3DRow(const FSimplexNoiseTables& Tables, const float* X, float Y, float Z, int32 Count, float* Out, int32 Octaves = 1, float Frequency = 1.0f, float Lacunarity = 2.0f);
+
+	/** Sum of Octaves[i].Amplitude * Noise3D(Octaves[i] points), the octaves are given explicitly. Used by FNoiseGenerator. */
+	static void Fractal3DOctaves(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, float* Out);
+
+	/** Fractal3DRowBands with the octaves given explicitly */
+	static int32 Fractal3DOctavesBands(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, uint8* OutBands, float Offset, float Scale, float Lower, float Upper);
+
+	/** RidgedMulti3DRow with the octaves given explicitly. The amplitudes have to be 1 / Lacunarity to the power of the octave. */
+	static void RidgedMulti3DOctaves(const FSimplexNoiseTables& Tables, const FNoiseRowOctave* Octaves, int32 NumOctaves, int32 Count, float* Out);
+
+	/** @returns whether rows with up to SIMPLEX_NOISE_BATCH_MAX_FIXED_OCTAVES octaves run the kernels unrolled for their octave count */
+	static bool GetUseFixedOctaveKernels();
+
+	/**
+	*  Switches between the unrolled kernels and the ones that loop over any number of octaves, for benchmarking.
+	*  Both give the same results. The unrolled kernels can be turned off with -NoiseGenericOctaves on the command line.
+	*/
+	static void SetUseFixedOctaveKernels(bool bUseFixedOctaveKernels);
+
+	/** @returns the tables with the same permutation as USimplexNoise */
+	static const FSimplexNoiseTables& GetDefaultTables();
+
+	/** @returns the instruction set the kernels currently run with */
+	static ENoiseInstructionSet GetInstructionSet();
+
+	/**
+	*  Forces the kernels to run with an instruction set, mostly for benchmarking and testing.
+	*  The default can also be overridden with -NoiseISA=<Name> on the command line.
+	*  @returns false if the CPU (or this build) doesn't support it, in which case nothing changes
+	*/
+	static bool SetInstructionSet(ENoiseInstructionSet InstructionSet);
+
+	/** @returns whether the kernels for the instruction set are compiled in and the CPU supports them */
+	static bool IsInstructionSetSupported(ENoiseInstructionSet InstructionSet);
+
+	static const TCHAR* GetInstructionSetName(ENoiseInstructionSet InstructionSet);
+
+};
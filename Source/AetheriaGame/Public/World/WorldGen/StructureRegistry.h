@@ -0,0 +1,88 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+#include "StructureTemplate.h"
+
+/**
+A thread safe record of every structure placed in a terrain, by the columns each one reaches into.
+A column only places the structures that grow from its own voxels, so it doesn't need to generate any voxels of its neighbors.
+The structures of its neighbors that reach into it are stamped from the registry when it is generated, and the ones placed
+after it was generated are handed to the game thread as spills, to be stamped into the loaded chunks.
+The structures of a column are forgotten once neither it nor any column they reach into is loaded. Placements only depend on
+the seed, so a column generated again places the same ones and spills them into the neighbors that were loaded without them.
+*/
+class AETHERIAGAME_API FStructureRegistry
+{
+
+public:
+
+	/** A structure that reaches into a column which was already generated when the structure was placed */
+	struct FSpill
+	{
+		FIntVector2D ColumnCoord;
+		FStructurePlacement Structure;
+	};
+
+private:
+
+	/* Every structure that reaches into a column, including the ones that grow from it */
+	TMap<FIntVector2D, TArray<FStructurePlacement>> ColumnStructures;
+
+	/* Columns that had their structures stamped and weren't removed since */
+	TSet<FIntVector2D> GeneratedColumns;
+
+	/* Columns whose own structures are in ColumnStructures, kept while any column they reach into is generated */
+	TSet<FIntVector2D> RegisteredColumns;
+
+	TArray<FSpill> Spills;
+
+	/* The Mutex for everything above */
+	FCriticalSection RegistryMutex;
+
+	/** Adds a structure to every column it reaches into, and spills it into the ones already generated. RegistryMutex has to be locked. */
+	void RegisterStructure(const FIntVector2D& SourceColumnCoord, const FStructurePlacement& Structure);
+
+	/** @returns whether the column or any column its structures reach into is generated. RegistryMutex has to be locked. */
+	bool IsColumnNeeded(const FIntVector2D& SourceColumnCoord) const;
+
+	/** Removes the structures that grow from a column from every column they reach into. RegistryMutex has to be locked. */
+	void UnregisterColumn(const FIntVector2D& SourceColumnCoord);
+
+	/** @returns the structures that grow from a column. RegistryMutex has to be locked. */
+	void GetOwnStructures(const FIntVector2D& SourceColumnCoord, TArray<FStructurePlacement>& OutStructures) const;
+
+public:
+
+	/**
+	*  Registers the structures that grow from a column with every column they reach into, and marks the column generated.
+	*  @param Structures - The structures that grow from the column
+	*  @param OutColumnStructures - Every structure to stamp into the column: its own and the ones of the neighbors generated before it
+	*/
+	void AddColumn(const FIntVector2D& ColumnCoord, const TArray<FStructurePlacement>& Structures, TArray<FStructurePlacement>& OutColumnStructures);
+
+	/**
+	*  Marks a column as no longer loaded, and forgets the structures of it and of its neighbors that no generated column needs anymore.
+	*  Does nothing if the column wasn't added.
+	*/
+	void RemoveColumn(const FIntVector2D& ColumnCoord);
+
+	/** Moves the spills out of the registry */
+	void TakeSpills(TArray<FSpill>& OutSpills);
+
+	/** Puts back spills whose column is still on its way to the game thread */
+	void ReturnSpills(const TArray<FSpill>& InSpills);
+
+	/** Forgets every structure */
+	void Empty();
+
+	/** @returns the columns a structure reaches into (Inclusive) */
+	static void GetColumnBounds(const FStructurePlacement& Structure, FIntVector2D& OutMinColumn, FIntVector2D& OutMaxColumn);
+
+	/** @returns the column a structure grows from */
+	static FIntVector2D GetSourceColumn(const FStructurePlacement& Structure);
+
+};
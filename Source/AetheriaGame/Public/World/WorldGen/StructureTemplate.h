@@ -0,0 +1,98 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+
+/**
+A structure, like a tree, precompiled into bit masks so it can be stamped into any block of voxels.
+Every voxel type of the structure is a layer, and every row of x in a layer is one bit mask per <y, z>,
+so clipping the structure to a block is one mask per row instead of a bounds check per voxel.
+*/
+class AETHERIAGAME_API FStructureTemplate
+{
+
+public:
+
+	/** Builds the template from the offsets of its voxels, relative to where it is placed. Later voxels at the same offset replace earlier ones. */
+	FStructureTemplate(const TArray<TPair<FIntVector3, uint8>>& Voxels);
+
+	/**
+	*  Writes the part of the structure inside a block of voxels. A voxel is only replaced by a structure voxel of higher rank,
+	*  so overlapping structures end up the same whatever order they are stamped in, and stamping twice changes nothing.
+	*  @param Position - World coordinate the structure is placed at
+	*  @param VoxelsOrigin - World coordinate of the first voxel in Voxels
+	*  @param VoxelsSize - Dimensions of the block, indexed x + y * VoxelsSize.X + z * VoxelsSize.X * VoxelsSize.Y
+	*/
+	void Stamp(const FIntVector3& Position, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, uint8* Voxels) const;
+
+	/** Lower bound of the voxels, relative to where it is placed (Inclusive) */
+	const FIntVector3& GetMin() const { return Min; }
+
+	/** Upper bound of the voxels, relative to where it is placed (Exclusive) */
+	FIntVector3 GetMax() const { return Min + Size; }
+
+	/** @returns the rank of a voxel when structures overlap. Terrain voxels are 0 and always replaced. */
+	static uint8 GetVoxelRank(uint8 Voxel);
+
+private:
+
+	struct FLayer
+	{
+		uint8 Voxel;
+		/* Bit x is set in row y + z * Size.Y if the voxel is at <Min.X + x, Min.Y + y, Min.Z + z> */
+		TArray<uint32> Rows;
+	};
+
+	FIntVector3 Min;
+
+	/* Size.X is at most 32, the bits of a row */
+	FIntVector3 Size;
+
+	/* Sorted by rank, lowest first */
+	TArray<FLayer> Layers;
+
+};
+
+/** A structure placed in the world. The template is an index into FStructureLibrary. */
+struct FStructurePlacement
+{
+	FIntVector3 Position;
+	int32 Template;
+
+	FStructurePlacement() {}
+
+	FStructurePlacement(const FIntVector3& InPosition, int32 InTemplate)
+		: Position(InPosition), Template(InTemplate) {}
+
+	friend bool operator==(const FStructurePlacement& A, const FStructurePlacement& B)
+	{
+		return A.Position == B.Position && A.Template == B.Template;
+	}
+};
+
+/** Every structure template, built once and shared by all the generation threads */
+class AETHERIAGAME_API FStructureLibrary
+{
+
+public:
+
+	static const FStructureLibrary& Get();
+
+	const FStructureTemplate& GetTemplate(int32 Template) const { return Templates[Template]; }
+
+	/** @returns the template of a tree, with one of the leaf types 11, 13 or 14 */
+	int32 GetTreeTemplate(uint8 LeafType, bool bSnowOnTrees) const;
+
+	/** How high a tree reaches above the voxel it grows on */
+	static const int32 TreeHeight = 10;
+
+private:
+
+	TArray<FStructureTemplate> Templates;
+
+	FStructureLibrary();
+
+};
@@ -0,0 +1,48 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ChunkUtils.h"
+
+#include "Containers/Queue.h"
+
+/**
+The columns the generation threads finished, waiting for the game thread to add them to the terrain.
+Lock free with many producers and a single consumer. Pushing a column only publishes its pointer, its chunks are never copied
+on the way, and the game thread drains the queue once per tick.
+*/
+class FTerrainCompletionQueue
+{
+
+public:
+
+	struct FCompletedColumn
+	{
+		TUniquePtr<FChunkColumn> Column;
+		// FPlatformTime::Cycles() when the column finished generating
+		uint32 GeneratedCycles;
+	};
+
+private:
+
+	TQueue<FCompletedColumn, EQueueMode::Mpsc> Columns;
+
+	/* Only used for stats, the queue itself doesn't need it */
+	volatile int32 NumColumns;
+
+public:
+
+	FTerrainCompletionQueue();
+
+	/** Hands a generated column over to the game thread. Can be called from any thread. */
+	void Push(TUniquePtr<FChunkColumn>&& Column);
+
+	/** Takes the oldest column. Only the game thread can call it. @returns false if the queue is empty */
+	bool Pop(FCompletedColumn& OutCompleted);
+
+	/** Number of columns waiting, may be out of date as soon as it returns */
+	int32 Num() const { return NumColumns; }
+
+};
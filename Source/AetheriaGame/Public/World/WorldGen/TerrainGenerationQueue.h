@@ -0,0 +1,87 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "IntVectors.h"
+
+/**
+A thread safe priority queue of chunk columns waiting to be generated, shared by all the generation threads.
+Columns closest to a viewer are generated first. Queued columns can be cancelled at any time.
+*/
+class FTerrainGenerationQueue
+{
+
+private:
+
+	struct FEntry
+	{
+		FIntVector2D ColumnCoord;
+		// Squared distance (in chunks) to the closest viewer. Lower is generated first.
+		int32 Priority;
+	};
+
+	struct FEntryPriority
+	{
+		FORCEINLINE bool operator()(const FEntry& A, const FEntry& B) const
+		{
+			return A.Priority < B.Priority;
+		}
+	};
+
+	/* Binary heap of queued columns. May contain cancelled columns, which are skipped when dequeued */
+	TArray<FEntry> Heap;
+
+	/* All the columns that are queued and not cancelled */
+	TSet<FIntVector2D> QueuedColumns;
+
+	/* Column positions of everything that streams terrain in */
+	TArray<FIntVector2D> ViewerColumnPositions;
+
+	/* Whether the priorities in the heap are out of date */
+	bool bViewersChanged;
+
+	bool bIsShutdown;
+
+	/* The Mutex for everything above */
+	mutable FCriticalSection QueueMutex;
+
+	/* Triggered when a column is queued, wakes up one generation thread */
+	FEvent* WorkAvailableEvent;
+
+public:
+
+	FTerrainGenerationQueue();
+
+	~FTerrainGenerationQueue();
+
+	/** Queues a column to be generated. Does nothing if it is already queued */
+	void Enqueue(const FIntVector2D& ColumnCoord);
+
+	/** Removes a column from the queue. @returns false if the column wasn't queued (or is already being generated) */
+	bool Cancel(const FIntVector2D& ColumnCoord);
+
+	/** Sets the positions that priorities are measured from */
+	void SetViewers(const TArray<FIntVector2D>& InViewerColumnPositions);
+
+	/**
+	*  Blocks the calling thread until a column is available, then pops the column with the highest priority.
+	*  @returns false if the queue was shut down
+	*/
+	bool WaitAndDequeue(FIntVector2D& OutColumnCoord);
+
+	/** Wakes up every thread waiting on the queue and makes all future waits return immediately */
+	void Shutdown();
+
+	/** Number of columns waiting to be generated */
+	int32 Num() const;
+
+private:
+
+	int32 GetPriority(const FIntVector2D& ColumnCoord) const;
+
+	/** Pops the next column that hasn't been cancelled. Mutex must be held. */
+	bool PopNext(FIntVector2D& OutColumnCoord);
+
+};
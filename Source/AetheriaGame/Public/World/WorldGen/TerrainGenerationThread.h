@@ -1,52 +1,55 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
-#include "ChunkUtils.h"
-#include "IntVectors.h"
-
-#include "TerrainGenerator.h"
-
-#include "Runnable.h"
-#include "Queue.h"
-
-class FTerrainGenerationThread : public FRunnable
-{
-
-private:
-
-	friend class AVoxelTerrain;
-
-	class AVoxelTerrain* VoxelTerrain;
-
-	FRunnableThread* Thread;
-
-	bool bIsThreadRunning;
-
-	TQueue<FIntVector3> ChunksToGenerate;
-
-	FEvent* ChunkAddedEvent;
-
-public:
-
-	FTerrainGenerationThread(class AVoxelTerrain* InVoxelTerrain);
-
-	virtual ~FTerrainGenerationThread();
-
-	virtual bool Init() override;
-
-	virtual uint32 Run() override;
-
-	virtual void Stop() override;
-
-	void EnsureCompletion();
-
-	void QueueChunk(const FIntVector3& ChunkCoord);
-
-private:
-
-	void NextChunk();
-
-};
\ No newline at end of file
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ChunkUtils.h"
+#include "IntVectors.h"
+
+#include "TerrainGenerator.h"
+
+#include "Runnable.h"
+
+/**
+One worker of the terrain generation pool.
+Every worker pulls the closest chunk column from the shared FTerrainGenerationQueue and sleeps on it when there is no work.
+Finished columns are pushed onto the FTerrainCompletionQueue the game thread drains.
+*/
+class FTerrainGenerationThread : public FRunnable
+{
+
+private:
+
+	friend class AVoxelTerrain;
+
+	class AVoxelTerrain* VoxelTerrain;
+
+	class FTerrainGenerationQueue* GenerationQueue;
+
+	class FTerrainCompletionQueue* CompletionQueue;
+
+	FRunnableThread* Thread;
+
+	bool bIsThreadRunning;
+
+public:
+
+	FTerrainGenerationThread(class AVoxelTerrain* InVoxelTerrain, class FTerrainGenerationQueue* InGenerationQueue, class FTerrainCompletionQueue* InCompletionQueue, const int32 ThreadIndex);
+
+	virtual ~FTerrainGenerationThread();
+
+	virtual bool Init() override;
+
+	virtual uint32 Run() override;
+
+	/** Stops the thread. The queue must be shut down as well to wake it up if it's waiting. */
+	virtual void Stop() override;
+
+	void EnsureCompletion();
+
+private:
+
+	void GenerateColumn(const FIntVector2D& ColumnCoord);
+
+};
@@ -1,31 +1,118 @@
-// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
-#include "ChunkUtils.h"
-#include "TerrainParameters.h"
-
-#include "Kismet/BlueprintFunctionLibrary.h"
-#include "TerrainGenerator.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class AETHERIAGAME_API UTerrainGenerator : public UBlueprintFunctionLibrary
-{
-	GENERATED_BODY()
-	
-public:
-
-	// Procedurally generates a Chunk based on noise
-	UFUNCTION(Category = "Terrain Generator", BlueprintCallable)
-	static void GenerateChunk(const class AVoxelTerrain* const VoxelTerrain, FChunk& Chunk, const FTerrainGeneratorParameters& Parameter);
-
-private:
-
-	static void MakeTree(const FTerrainGeneratorParameters& Parameter, const uint8 LeafType, const FIntVector3& Position, const FIntVector3& ChunkPosInVoxels, TArray<uint8>& ExtraVoxels);
-
-};
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ChunkUtils.h"
+#include "TerrainParameters.h"
+#include "StructureTemplate.h"
+#include "NoiseTileCache.h"
+
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "TerrainGenerator.generated.h"
+
+/** The noise the terrain generator uses, each seed has its own FNoiseGenerator for every channel */
+enum class ETerrainNoiseChannel : uint32
+{
+	Density,
+	Tree,
+	LeafColor,
+	Cave
+};
+
+/**
+ * 
+ */
+UCLASS()
+class AETHERIAGAME_API UTerrainGenerator : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+	
+public:
+
+	/**
+	*  Procedurally generates a whole column of chunks based on noise in one pass.
+	*  All the chunks of the column share the 2D noise and the surface detection, so nothing is computed twice.
+	*  @param VoxelTerrain - Its structure registry gives the structures of the neighbor columns, without one only the column's own are stamped
+	*  @param OutColumn - Filled with WORLD_HEIGHT_CHUNKS chunks, their heightmaps and the column heightmap
+	*/
+	UFUNCTION(Category = "Terrain Generator", BlueprintCallable)
+	static void GenerateColumn(const class AVoxelTerrain* const VoxelTerrain, const FIntVector2D& ColumnCoord, FChunkColumn& OutColumn, const FTerrainGeneratorParameters& Parameter);
+
+	/**
+	*  Finds the layers of the density terrain that are the same for every <x, y>, from the largest value the noise can reach.
+	*  @param OutStoneHeight - Every layer below it is stone
+	*  @param OutAirHeight - Every layer from it up is air
+	*/
+	static void GetDensityBounds(const FTerrainGeneratorParameters& Parameter, const int32 Height, int32& OutStoneHeight, int32& OutAirHeight);
+
+	/**
+	*  Builds the biome graph of the built-in terrain, a single biome with the parameters' noise, grass and snow.
+	*  Generates the same voxels as the built-in terrain, except that the density is sampled at every voxel whatever DensitySampleSpacing is.
+	*/
+	static FBiomeGraph MakeBiomeGraph(const FTerrainGeneratorParameters& Parameter);
+
+	/** The key the noise of a column is cached with */
+	static FNoiseTileKey GetNoiseTileKey(const FTerrainGeneratorParameters& Parameter, const FIntVector2D& ColumnCoord);
+
+private:
+
+	/**
+	*  Fills a block with the noise of a column. The tile is copied from the cache if the column was generated before,
+	*  otherwise it is generated and cached, so a column that is loaded again doesn't evaluate the noise again.
+	*/
+	static void GatherNoise(const FTerrainGeneratorParameters& Parameter, const FIntVector2D& ColumnCoord, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, struct FNoiseTile& OutBlock);
+
+	/** Runs the 2D and 3D passes over a block of voxels */
+	static void GenerateNoiseTile(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, struct FNoiseTile& OutTile);
+
+	/** Hash of every parameter the noise tiles depend on */
+	static uint32 GetNoiseParameterHash(const FTerrainGeneratorParameters& Parameter);
+
+	/** 2D pass. Tree probability (0 - 1) and leaf color noise (-1 - 1) of every <x, y> in the block of voxels */
+	static void GenerateTreeNoise(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<float>& OutTreeProbs, TArray<float>& OutColorNoises);
+
+	/**
+	*  2D pass for the ridged multi terrain. The noise doesn't depend on z, so each <x, y> is filled from a single noise value.
+	*  @param OutAirHeight - Every layer from it up is air
+	*/
+	static void FillHeightfield(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, int32& OutAirHeight);
+
+	/**
+	*  2D pass for the heightmap file terrain. Each <x, y> is stone up to HeightmapGrassDepth below its height, then grass, then air.
+	*  Only reads the tiles of the file under the block.
+	*  @param OutAirHeight - Every layer from it up is air
+	*/
+	static void FillFromHeightmap(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, int32& OutAirHeight);
+
+	/**
+	*  3D pass. Classifies every voxel into stone, grass or air from the density noise.
+	*  Layers the noise can't reach are filled without evaluating any noise.
+	*  @param OutAirHeight - Every layer from it up is air
+	*/
+	static void FillDensity(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, TArray<uint8>& Voxels, int32& OutAirHeight);
+
+	/**
+	*  The density pass with Parameter.DensitySampleSpacing bigger than 1. The noise is only sampled on a lattice
+	*  and every voxel from StoneHeight to AirHeight is classified from the trilinear interpolation of the samples around it.
+	*/
+	static void InterpolateDensity(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, const int32 StoneHeight, const int32 AirHeight, TArray<uint8>& Voxels);
+
+	/**
+	*  3D pass that carves caves out of the solid voxels wherever the cave noise is above the threshold of its layer.
+	*  Chunks outside of the layers that can have caves, and bricks of 8 voxels without any solid voxel, are skipped without evaluating any noise.
+	*  @param AirHeight - Every layer from it up is air, so nothing there is carved
+	*/
+	static void CarveCaves(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, const int32 AirHeight, TArray<uint8>& Voxels);
+
+	/**
+	*  Puts the surface voxel of each column's biome (snow without a biome graph) on every air voxel that sits on the ground,
+	*  and collects the trees that grow on the highest surface of each <x, y> as structures. The tree noise is only read if trees are enabled.
+	*  @param Biomes - The biome of every <x, y>, empty without a biome graph
+	*  Compiled for both values of Parameter.bCreateTrees so the surface loop doesn't test it per voxel.
+	*/
+	template <bool bCreateTrees>
+	static void PlaceSurface(const FTerrainGeneratorParameters& Parameter, const FIntVector3& VoxelsOrigin, const FIntVector3& VoxelsSize, const int32 AirHeight, const TArray<uint8>& Biomes, const TArray<float>& TreeProbs, const TArray<float>& ColorNoises, TArray<uint8>& Voxels, TArray<FStructurePlacement>& OutStructures);
+
+};
@@ -0,0 +1,109 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The stages of UTerrainGenerator::GenerateColumn, in the order they run */
+enum class ETerrainGeneratorStage : int32
+{
+	/* Density, heightfield or biome graph */
+	BaseTerrain,
+	TreeNoise,
+	Caves,
+	Surface,
+	Structures,
+	/* Copying the block into chunks and building the heightmaps */
+	Chunks,
+
+	Num
+};
+
+/**
+Thread safe counters of how long every stage of the terrain generator took, summed over all the generation threads,
+of how much of the cave pass was rejected without evaluating any noise, and of how long generated columns waited to be loaded.
+Logged by Aetheria.TerrainGenerator.Stats.
+*/
+class AETHERIAGAME_API FTerrainGeneratorStats
+{
+
+public:
+
+	struct FStageStats
+	{
+		int64 Cycles;
+		int64 Count;
+	};
+
+	struct FCaveStats
+	{
+		/* Chunks of blocks the cave pass looked at, and the ones outside the cave layers or above the air */
+		int64 Chunks;
+		int64 RejectedChunks;
+
+		/* Bricks of the chunks that were left, and the ones without any solid voxel */
+		int64 Bricks;
+		int64 RejectedBricks;
+
+		int64 CarvedVoxels;
+	};
+
+	struct FLatencyStats
+	{
+		/* Columns that were added to the terrain, and the cycles between their generation finishing and their chunks being loaded */
+		int64 Columns;
+		int64 Cycles;
+		int64 MaxCycles;
+	};
+
+private:
+
+	FStageStats Stages[(int32)ETerrainGeneratorStage::Num];
+
+	FCaveStats Caves;
+
+	FLatencyStats ResidentLatency;
+
+public:
+
+	FTerrainGeneratorStats();
+
+	/** The stats every terrain generator adds to */
+	static FTerrainGeneratorStats& Get();
+
+	void AddStage(ETerrainGeneratorStage Stage, uint32 Cycles);
+
+	void AddCaves(const FCaveStats& InCaves);
+
+	FStageStats GetStage(ETerrainGeneratorStage Stage) const;
+
+	FCaveStats GetCaves() const;
+
+	/** Adds the time a generated column waited for the game thread to load it */
+	void AddResidentLatency(uint32 Cycles);
+
+	FLatencyStats GetResidentLatency() const;
+
+	void Reset();
+
+	/** Logs the time of every stage, against the total and against the base terrain */
+	void Log() const;
+
+	static const TCHAR* GetStageName(ETerrainGeneratorStage Stage);
+
+};
+
+/** Adds the cycles from its construction to its destruction to a stage */
+struct FTerrainGeneratorStageTimer
+{
+	const ETerrainGeneratorStage Stage;
+	const uint32 StartCycles;
+
+	FTerrainGeneratorStageTimer(ETerrainGeneratorStage InStage)
+		: Stage(InStage), StartCycles(FPlatformTime::Cycles()) {}
+
+	~FTerrainGeneratorStageTimer()
+	{
+		FTerrainGeneratorStats::Get().AddStage(Stage, FPlatformTime::Cycles() - StartCycles);
+	}
+};
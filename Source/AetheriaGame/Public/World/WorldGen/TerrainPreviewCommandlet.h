@@ -0,0 +1,27 @@
+// Copyright (c) 2016-2017, Charles JL Sun, All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Commandlets/Commandlet.h"
+#include "TerrainPreviewCommandlet.generated.h"
+
+/**
+Renders a top-down preview of the terrain generator parameters into a color PNG and a 16 bit height PNG, to tune them without playing.
+Only the biome selection and the ground of every column are evaluated, never the voxels beneath it, the caves or the trees,
+and the columns are spread over every core. Runs without a GPU:
+UE4Editor-Cmd Aetheria.uproject -run=TerrainPreview [-Terrain=/Game/Path/BP_Terrain] [-Seed=123] [-Chunks=64] [-X=0 -Y=0] [-Output=Path.png] -nullrhi
+*/
+UCLASS()
+class UTerrainPreviewCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UTerrainPreviewCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+};